@@ -0,0 +1,447 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+/* Measure the cost of opening and parsing code objects, and of looking up
+   their symbols and disassembling them, at production sizes.
+
+   Usage: code-object-benchmark [OPTION]... [FUNCTION_COUNT...]
+
+   For each FUNCTION_COUNT (1000, 10000 and 100000 by default), a synthetic
+   code object with that many function symbols, spread over compilation units
+   with line tables, is opened from memory like the snapshot decoder does.
+   The instructions are disassembled by the fake libamd-dbgapi.  The address
+   ranges of the source lines are checked against the generated line
+   tables.
+
+   The results are printed to stdout as one JSON object per line and per
+   FUNCTION_COUNT, so that runs can be compared by scripts.  Latencies are
+   the median of the iterations, in nanoseconds.  */
+
+#include "code_object.h"
+#include "json_writer.h"
+#include "logging.h"
+#include "synthetic_code_object.h"
+
+#include <amd-dbgapi/amd-dbgapi.h>
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <malloc.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace amd::debug_agent;
+
+namespace
+{
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr amd_dbgapi_global_address_t load_address = 0x7f0000000000;
+
+struct options_t
+{
+  size_t m_function_size{ 256 };
+  size_t m_functions_per_compilation_unit{ 16 };
+  size_t m_line_rows_per_function{ 8 };
+  size_t m_iterations{ 5 };
+  size_t m_lookups{ 1000000 };
+  size_t m_disassemblies{ 10000 };
+  size_t m_line_lookups{ 100000 };
+};
+
+/* Return the number of bytes allocated with malloc and not freed yet.  */
+size_t
+heap_in_use ()
+{
+#if __GLIBC_PREREQ(2, 33)
+  return mallinfo2 ().uordblks;
+#else
+  return static_cast<unsigned int> (mallinfo ().uordblks);
+#endif
+}
+
+/* Return the peak resident set size of the process, in kilobytes.  */
+long
+max_rss_kb ()
+{
+  rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+template <typename Function>
+uint64_t
+time_ns (Function &&function)
+{
+  auto start = clock_type::now ();
+  function ();
+  return std::chrono::duration_cast<std::chrono::nanoseconds> (
+             clock_type::now () - start)
+      .count ();
+}
+
+uint64_t
+median (std::vector<uint64_t> values)
+{
+  std::sort (values.begin (), values.end ());
+  return values[values.size () / 2];
+}
+
+void
+run (json_writer_t &json, size_t function_count, const options_t &options,
+     amd_dbgapi_architecture_id_t architecture_id)
+{
+  synthetic_code_object_options_t generator_options;
+  generator_options.m_function_count = function_count;
+  generator_options.m_function_size = options.m_function_size;
+  generator_options.m_compilation_unit_count
+      = (function_count + options.m_functions_per_compilation_unit - 1)
+        / options.m_functions_per_compilation_unit;
+  generator_options.m_line_rows_per_function
+      = options.m_line_rows_per_function;
+  /* Leave gaps between the compilation units, so that the address ranges
+     of their last lines end at the end of their sequence.  */
+  generator_options.m_compilation_unit_gap = synthetic_block_size;
+
+  const synthetic_code_object_t synthetic
+      = make_synthetic_code_object (generator_options);
+  const std::string uri
+      = "memory://benchmark#offset=" + std::to_string (load_address)
+        + "&size=" + std::to_string (synthetic.m_image.size ());
+
+  std::mt19937_64 rng (function_count);
+  std::uniform_int_distribution<size_t> function_dist (0, function_count - 1);
+
+  /* A pc at the start of a random instruction block.  */
+  auto random_pc = [&] () {
+    const synthetic_function_t &function
+        = synthetic.m_functions[function_dist (rng)];
+    std::uniform_int_distribution<size_t> block_dist (
+        0, function.m_size / synthetic_block_size - 1);
+    return load_address + function.m_address
+           + block_dist (rng) * synthetic_block_size;
+  };
+
+  std::vector<uint64_t> open_ns, symbols_ns, debug_info_ns,
+      first_disassemble_ns, retained_bytes;
+
+  for (size_t i = 0; i < options.m_iterations; ++i)
+    {
+      /* A fully parsed code object.  The copy of the image it owns is
+         included in its retained memory.  */
+      {
+        std::vector<char> image = synthetic.m_image;
+        const size_t heap_before = heap_in_use () - image.size ();
+        code_object_t code_object (uri, load_address);
+
+        open_ns.push_back (
+            time_ns ([&] () { code_object.open (std::move (image)); }));
+        symbols_ns.push_back (time_ns (
+            [&] () { code_object.find_symbol (load_address + 0x100); }));
+        debug_info_ns.push_back (
+            time_ns ([&] () { code_object.parse (); }));
+
+        retained_bytes.push_back (heap_in_use () - heap_before);
+      }
+
+      /* A code object disassembled once, so that only the line table of the
+         compilation unit containing the pc is decoded.  */
+      {
+        code_object_t code_object (uri, load_address);
+        code_object.open (synthetic.m_image);
+
+        const amd_dbgapi_global_address_t pc = random_pc ();
+        first_disassemble_ns.push_back (time_ns ([&] () {
+          code_object.disassemble (
+              architecture_id, pc,
+              [&] (amd_dbgapi_global_address_t address, void *buffer,
+                   amd_dbgapi_size_t *size) {
+                return code_object.read_image_memory (address, buffer, size);
+              });
+        }));
+      }
+    }
+
+  code_object_t code_object (uri, load_address);
+  code_object.open (synthetic.m_image);
+  code_object.parse ();
+
+  /* Mostly addresses inside the functions, a few past the end of the
+     code object.  */
+  std::uniform_int_distribution<amd_dbgapi_global_address_t> address_dist (
+      load_address, load_address + code_object.mem_size () * 17 / 16);
+  std::vector<amd_dbgapi_global_address_t> addresses (options.m_lookups);
+  for (auto &&address : addresses)
+    address = address_dist (rng);
+
+  /* The first lookups also demangle the symbol names.  */
+  auto lookups_per_second = [&] () {
+    size_t found = 0;
+    const uint64_t ns = time_ns ([&] () {
+      for (auto address : addresses)
+        found += code_object.find_symbol (address).has_value ();
+    });
+    if (!found)
+      std::cerr << "error: no symbol found" << std::endl;
+    return static_cast<uint64_t> (addresses.size () * 1e9 / ns);
+  };
+  const uint64_t cold_lookups_per_second = lookups_per_second ();
+  const uint64_t warm_lookups_per_second = lookups_per_second ();
+
+  std::vector<amd_dbgapi_global_address_t> pcs (options.m_disassemblies);
+  for (auto &&pc : pcs)
+    pc = random_pc ();
+
+  const uint64_t disassemble_ns
+      = time_ns ([&] () {
+          for (auto pc : pcs)
+            code_object.disassemble (
+                architecture_id, pc,
+                [&] (amd_dbgapi_global_address_t address, void *buffer,
+                     amd_dbgapi_size_t *size) {
+                  return code_object.read_image_memory (address, buffer,
+                                                        size);
+                });
+        })
+        / std::max<size_t> (pcs.size (), 1);
+
+  /* The address ranges of random source lines.  Each line is a single row,
+     which ends at the next row of its function, or at the end of the
+     function.  */
+  std::vector<std::pair<const synthetic_function_t *, size_t>> lines;
+  lines.reserve (options.m_line_lookups);
+  for (size_t i = 0; i < options.m_line_lookups; ++i)
+    {
+      const synthetic_function_t &function
+          = synthetic.m_functions[function_dist (rng)];
+      std::uniform_int_distribution<size_t> row_dist (
+          0, function.m_row_addresses.size () - 1);
+      lines.emplace_back (&function, row_dist (rng));
+    }
+
+  size_t wrong_ranges = 0;
+  const uint64_t line_lookups_ns = time_ns ([&] () {
+    for (auto [function, row] : lines)
+      {
+        const auto ranges = code_object.find_line_address_ranges (
+            std::string (synthetic_compilation_directory) + '/'
+                + function->m_file_name,
+            function->m_first_line + row);
+
+        const amd_dbgapi_global_address_t start
+            = load_address + function->m_row_addresses[row];
+        const amd_dbgapi_global_address_t end
+            = load_address
+              + (row + 1 < function->m_row_addresses.size ()
+                     ? function->m_row_addresses[row + 1]
+                     : function->m_address + function->m_size);
+
+        if (ranges.size () != 1
+            || ranges.front () != std::make_pair (start, end))
+          ++wrong_ranges;
+      }
+  });
+  if (wrong_ranges)
+    std::cerr << "error: " << wrong_ranges
+              << " source lines have wrong address ranges" << std::endl;
+  const uint64_t line_lookups_per_second
+      = lines.size () * 1e9 / std::max<uint64_t> (line_lookups_ns, 1);
+
+  json.begin_object ();
+  json.key ("function_count").value (function_count);
+  json.key ("compilation_unit_count")
+      .value (generator_options.m_compilation_unit_count);
+  json.key ("line_rows_per_function")
+      .value (generator_options.m_line_rows_per_function);
+  json.key ("image_size").value (synthetic.m_image.size ());
+  json.key ("iterations").value (options.m_iterations);
+  json.key ("open_ns").value (median (open_ns));
+  json.key ("load_symbol_map_ns").value (median (symbols_ns));
+  json.key ("load_debug_info_ns").value (median (debug_info_ns));
+  json.key ("first_disassemble_ns").value (median (first_disassemble_ns));
+  json.key ("disassemble_ns").value (disassemble_ns);
+  json.key ("find_symbol_cold_per_second").value (cold_lookups_per_second);
+  json.key ("find_symbol_per_second").value (warm_lookups_per_second);
+  json.key ("find_line_address_ranges_per_second")
+      .value (line_lookups_per_second);
+  json.key ("wrong_line_address_ranges").value (wrong_ranges);
+  json.key ("retained_bytes").value (median (retained_bytes));
+  json.key ("max_rss_kb").value (max_rss_kb ());
+  json.end_object ();
+  std::cout << std::endl;
+}
+
+void
+print_usage ()
+{
+  std::cerr << "usage: code-object-benchmark [OPTION]... [FUNCTION_COUNT...]"
+            << std::endl
+            << std::endl;
+  std::cerr << "  --function-size=BYTES       "
+               "Size of each function (default 256)."
+            << std::endl;
+  std::cerr << "  --functions-per-cu=N        "
+               "Functions per compilation unit (default 16)."
+            << std::endl;
+  std::cerr << "  --line-rows=N               "
+               "Line table rows per function (default 8)."
+            << std::endl;
+  std::cerr << "  --iterations=N              "
+               "Number of times each code object is opened and"
+            << std::endl
+            << "                              "
+               "parsed (default 5)."
+            << std::endl;
+  std::cerr << "  --lookups=N                 "
+               "Number of symbol lookups (default 1000000)."
+            << std::endl;
+  std::cerr << "  --disassemblies=N           "
+               "Number of disassemblies (default 10000)."
+            << std::endl;
+  std::cerr << "  --line-lookups=N            "
+               "Number of source line lookups (default 100000)."
+            << std::endl;
+}
+
+} /* namespace */
+
+int
+main (int argc, char **argv)
+{
+  options_t options;
+
+  enum : int
+  {
+    option_function_size = 256,
+    option_functions_per_cu,
+    option_line_rows,
+    option_iterations,
+    option_lookups,
+    option_disassemblies,
+    option_line_lookups
+  };
+
+  static struct option long_options[]
+      = { { "function-size", required_argument, nullptr,
+            option_function_size },
+          { "functions-per-cu", required_argument, nullptr,
+            option_functions_per_cu },
+          { "line-rows", required_argument, nullptr, option_line_rows },
+          { "iterations", required_argument, nullptr, option_iterations },
+          { "lookups", required_argument, nullptr, option_lookups },
+          { "disassemblies", required_argument, nullptr,
+            option_disassemblies },
+          { "line-lookups", required_argument, nullptr, option_line_lookups },
+          { "help", no_argument, nullptr, 'h' },
+          { 0 } };
+
+  while (int c = getopt_long (argc, argv, "h", long_options, nullptr))
+    {
+      if (c == -1)
+        break;
+
+      switch (c)
+        {
+        case option_function_size:
+          options.m_function_size = std::strtoul (optarg, nullptr, 0);
+          break;
+        case option_functions_per_cu:
+          options.m_functions_per_compilation_unit
+              = std::max (std::strtoul (optarg, nullptr, 0), 1ul);
+          break;
+        case option_line_rows:
+          options.m_line_rows_per_function
+              = std::strtoul (optarg, nullptr, 0);
+          break;
+        case option_iterations:
+          options.m_iterations
+              = std::max (std::strtoul (optarg, nullptr, 0), 1ul);
+          break;
+        case option_lookups:
+          options.m_lookups = std::strtoul (optarg, nullptr, 0);
+          break;
+        case option_disassemblies:
+          options.m_disassemblies = std::strtoul (optarg, nullptr, 0);
+          break;
+        case option_line_lookups:
+          options.m_line_lookups = std::strtoul (optarg, nullptr, 0);
+          break;
+        case 'h':
+          print_usage ();
+          return EXIT_SUCCESS;
+        default:
+          print_usage ();
+          return EXIT_FAILURE;
+        }
+    }
+
+  std::vector<size_t> function_counts;
+  for (int i = optind; i < argc; ++i)
+    if (size_t count = std::strtoul (argv[i], nullptr, 0))
+      function_counts.push_back (count);
+
+  if (function_counts.empty ())
+    function_counts = { 1000, 10000, 100000 };
+
+  /* The disassembly is printed, as it would be in a report.  */
+  set_agent_out_fd (::open ("/dev/null", O_WRONLY | O_CLOEXEC));
+
+  amd_dbgapi_callbacks_t callbacks{};
+  callbacks.allocate_memory = malloc;
+  callbacks.deallocate_memory = free;
+
+  amd_dbgapi_architecture_id_t architecture_id;
+  if (amd_dbgapi_initialize (&callbacks) != AMD_DBGAPI_STATUS_SUCCESS
+      || amd_dbgapi_get_architecture (
+             synthetic_code_object_options_t{}.m_elf_amdgpu_machine,
+             &architecture_id)
+             != AMD_DBGAPI_STATUS_SUCCESS)
+    {
+      std::cerr << "error: could not initialize the fake libamd-dbgapi"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  json_writer_t json (std::cout);
+  for (auto function_count : function_counts)
+    run (json, function_count, options, architecture_id);
+
+  amd_dbgapi_finalize ();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,179 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+/* Check that code_object_registry_t finds the code objects of the fake
+   libamd-dbgapi's process by address, also after a code object is unloaded
+   and another one is loaded at the same address in a single update.
+
+   Usage: code-object-registry-test  */
+
+#include "code_object.h"
+#include "fake_dbgapi.h"
+#include "logging.h"
+
+#include <amd-dbgapi/amd-dbgapi.h>
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+using namespace amd::debug_agent;
+
+namespace
+{
+
+bool g_failed = false;
+
+void
+check (bool condition, const char *what)
+{
+  if (condition)
+    return;
+
+  std::cerr << "FAIL: " << what << std::endl;
+  g_failed = true;
+}
+
+/* Return the id and the load address of each code object of PROCESS_ID.  */
+std::vector<std::pair<amd_dbgapi_code_object_id_t,
+                      amd_dbgapi_global_address_t>>
+code_objects (amd_dbgapi_process_id_t process_id)
+{
+  amd_dbgapi_code_object_id_t *code_object_ids;
+  size_t code_object_count;
+  if (amd_dbgapi_process_code_object_list (process_id, &code_object_count,
+                                           &code_object_ids, nullptr)
+      != AMD_DBGAPI_STATUS_SUCCESS)
+    return {};
+
+  std::vector<std::pair<amd_dbgapi_code_object_id_t,
+                        amd_dbgapi_global_address_t>>
+      result;
+  for (size_t i = 0; i < code_object_count; ++i)
+    {
+      amd_dbgapi_global_address_t load_address;
+      if (amd_dbgapi_code_object_get_info (
+              code_object_ids[i], AMD_DBGAPI_CODE_OBJECT_INFO_LOAD_ADDRESS,
+              sizeof (load_address), &load_address)
+          == AMD_DBGAPI_STATUS_SUCCESS)
+        result.emplace_back (code_object_ids[i], load_address);
+    }
+  free (code_object_ids);
+  return result;
+}
+
+/* Check that REGISTRY finds each code object of PROCESS_ID at its load
+   address.  */
+void
+check_find (code_object_registry_t &registry,
+            amd_dbgapi_process_id_t process_id)
+{
+  auto loaded = code_objects (process_id);
+  check (!loaded.empty (), "the process has code objects");
+
+  for (auto &&[code_object_id, load_address] : loaded)
+    {
+      code_object_t *code_object = registry.find (load_address);
+      check (code_object != nullptr, "a code object is found");
+      if (!code_object)
+        continue;
+
+      check (code_object->id ().handle == code_object_id.handle,
+             "the code object loaded at the address is found");
+      check (code_object->find_symbol (load_address + 0x100).has_value (),
+             "the code object's symbols are found");
+    }
+}
+
+} /* namespace */
+
+int
+main ()
+{
+  set_agent_out_fd (STDERR_FILENO);
+
+  amd_dbgapi_callbacks_t callbacks{};
+  callbacks.allocate_memory = malloc;
+  callbacks.deallocate_memory = free;
+  /* The code objects are in the memory of this process.  */
+  callbacks.xfer_global_memory
+      = [] (amd_dbgapi_client_process_id_t,
+            amd_dbgapi_global_address_t address, amd_dbgapi_size_t *size,
+            void *read_buffer, const void *write_buffer) {
+          if (!read_buffer)
+            return AMD_DBGAPI_STATUS_ERROR;
+          std::memcpy (read_buffer, reinterpret_cast<const void *> (address),
+                       *size);
+          return AMD_DBGAPI_STATUS_SUCCESS;
+        };
+
+  amd_dbgapi_process_id_t process_id;
+  if (amd_dbgapi_initialize (&callbacks) != AMD_DBGAPI_STATUS_SUCCESS
+      || amd_dbgapi_process_attach (nullptr, &process_id)
+             != AMD_DBGAPI_STATUS_SUCCESS)
+    {
+      std::cerr << "error: could not initialize the fake libamd-dbgapi"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  for (bool background_parsing : { false, true })
+    {
+      code_object_registry_t registry (process_id, std::nullopt,
+                                       background_parsing);
+
+      /* The code objects are only listed if the list changed since it was
+         last listed.  */
+      fake_dbgapi::reload_code_object (0);
+      registry.update ();
+      registry.open_all ();
+      check_find (registry, process_id);
+
+      /* The runtime destroys an executable and freezes another one at the
+         same address, reported in a single update.  */
+      fake_dbgapi::reload_code_object (1);
+      registry.update ();
+      registry.open_all ();
+      check_find (registry, process_id);
+    }
+
+  amd_dbgapi_process_detach (process_id);
+  amd_dbgapi_finalize ();
+
+  if (g_failed)
+    return EXIT_FAILURE;
+
+  std::cout << "PASS" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,237 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+/* Check the command queue: the order of the commands as the ring wraps
+   around, a full queue, the doorbell, and producers waiting for room in a
+   full queue.
+
+   Usage: command-queue-test  */
+
+#include "command_queue.h"
+
+#include <poll.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace amd::debug_agent;
+
+namespace
+{
+
+bool g_failed = false;
+
+void
+check (bool condition, const char *what)
+{
+  if (condition)
+    return;
+
+  std::cerr << "FAIL: " << what << std::endl;
+  g_failed = true;
+}
+
+/* The commands are told apart by their completion, which is never
+   completed.  */
+std::unique_ptr<command_completion_t[]> g_completions;
+
+worker_command_t
+command (size_t index)
+{
+  return { worker_command_t::kind_t::print_waves, false,
+           &g_completions[index] };
+}
+
+/* Return the index of COMMAND.  */
+size_t
+index (const worker_command_t &command)
+{
+  return command.m_completion - g_completions.get ();
+}
+
+/* Return true if the doorbell of QUEUE is rung.  */
+bool
+doorbell_rung (const command_queue_t &queue)
+{
+  pollfd fd{ queue.doorbell_fd (), POLLIN, 0 };
+  return poll (&fd, 1, 0) == 1 && (fd.revents & POLLIN);
+}
+
+/* Push and pop the commands in batches of various sizes, so that the ring
+   wraps around at every position.  */
+void
+check_wrap_around (size_t command_count)
+{
+  command_queue_t queue;
+  worker_command_t popped;
+
+  check (!queue.pop (popped), "a new queue is empty");
+
+  size_t pushed = 0, expected = 0;
+  for (size_t batch = 1; pushed < command_count; batch = batch % 97 + 1)
+    {
+      for (size_t i = 0; i < batch && pushed < command_count; ++i)
+        queue.push (command (pushed++));
+
+      while (queue.pop (popped))
+        check (index (popped) == expected++,
+               "the commands are popped in order");
+
+      check (expected == pushed, "all the commands pushed are popped");
+    }
+}
+
+/* Fill the queue, and check that it makes room as commands are popped.  */
+void
+check_full_queue ()
+{
+  command_queue_t queue;
+
+  size_t pushed = 0;
+  while (queue.try_push (command (pushed)))
+    ++pushed;
+
+  check (pushed > 0, "the queue has room for commands");
+  check (!queue.try_push (command (pushed)),
+         "a full queue does not accept a command");
+
+  worker_command_t popped;
+  check (queue.pop (popped) && index (popped) == 0,
+         "the first command is popped from a full queue");
+  check (queue.try_push (command (pushed)),
+         "a command is pushed once a command is popped");
+  check (!queue.try_push (command (pushed + 1)),
+         "the queue is full again");
+
+  size_t expected = 1;
+  while (queue.pop (popped))
+    check (index (popped) == expected++, "the commands are popped in order");
+  check (expected == pushed + 1, "all the commands pushed are popped");
+}
+
+/* Check that the doorbell is rung by the first command pushed after it was
+   acknowledged.  */
+void
+check_doorbell ()
+{
+  command_queue_t queue;
+  worker_command_t popped;
+
+  check (!doorbell_rung (queue), "the doorbell of a new queue is not rung");
+
+  queue.push (command (0));
+  queue.push (command (1));
+  check (doorbell_rung (queue), "pushing a command rings the doorbell");
+
+  queue.acknowledge ();
+  check (!doorbell_rung (queue), "acknowledging clears the doorbell");
+  check (queue.pop (popped) && queue.pop (popped),
+         "the commands pushed before acknowledging are popped");
+
+  check (queue.try_push (command (2)) && doorbell_rung (queue),
+         "try_push rings the doorbell");
+  queue.acknowledge ();
+  check (queue.pop (popped) && index (popped) == 2,
+         "the command is popped after acknowledging");
+
+  queue.ring ();
+  check (doorbell_rung (queue), "the doorbell is rung without a command");
+  queue.acknowledge ();
+  check (!queue.pop (popped), "no command is popped");
+}
+
+/* Run PRODUCER_COUNT threads pushing COMMANDS_PER_PRODUCER commands each,
+   much more than the queue holds, while this thread pops them as the
+   worker thread does.  */
+void
+check_producers (size_t producer_count, size_t commands_per_producer)
+{
+  command_queue_t queue;
+
+  std::vector<std::thread> producers;
+  for (size_t p = 0; p < producer_count; ++p)
+    producers.emplace_back ([&queue, p, commands_per_producer] () {
+      for (size_t i = 0; i < commands_per_producer; ++i)
+        queue.push (command (p * commands_per_producer + i));
+    });
+
+  /* The next index expected from each producer.  */
+  std::vector<size_t> expected (producer_count);
+  for (size_t p = 0; p < producer_count; ++p)
+    expected[p] = p * commands_per_producer;
+
+  size_t popped_count = 0;
+  while (popped_count < producer_count * commands_per_producer)
+    {
+      pollfd fd{ queue.doorbell_fd (), POLLIN, 0 };
+      if (poll (&fd, 1, 1000) != 1)
+        {
+          check (false, "the doorbell is rung while commands are pending");
+          break;
+        }
+
+      queue.acknowledge ();
+      for (worker_command_t popped; queue.pop (popped); ++popped_count)
+        {
+          size_t producer = index (popped) / commands_per_producer;
+          check (index (popped) == expected[producer]++,
+                 "the commands of each producer are popped in order");
+        }
+    }
+
+  for (auto &&producer : producers)
+    producer.join ();
+
+  check (popped_count == producer_count * commands_per_producer,
+         "all the commands pushed are popped");
+}
+
+} /* namespace */
+
+int
+main ()
+{
+  constexpr size_t command_count = 100000;
+  g_completions.reset (new command_completion_t[command_count]);
+
+  check_wrap_around (command_count);
+  check_full_queue ();
+  check_doorbell ();
+  check_producers (4, command_count / 4);
+
+  if (g_failed)
+    return EXIT_FAILURE;
+
+  std::cout << "PASS" << std::endl;
+  return EXIT_SUCCESS;
+}
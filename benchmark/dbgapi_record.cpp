@@ -0,0 +1,708 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+/* A libamd-dbgapi interposer recording the calls made by the agent, and
+   their results, to a trace that the replay library can serve back without
+   a GPU.  See dbgapi_trace.h for the trace format.
+
+   Usage: LD_PRELOAD=libamd-dbgapi-record.so
+          ROCM_DEBUG_AGENT_DBGAPI_TRACE=FILE HSA_TOOLS_LIB=... PROGRAM
+
+   The calls are forwarded to the next libamd-dbgapi in the symbol lookup
+   order.  The trace is written to FILE, rocm-debug-agent.PID.trace by
+   default, at the end of each report and when the library is finalized, so
+   that it is complete when the process is aborted after a report.  */
+
+#include "dbgapi_trace.h"
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace amd::debug_agent::dbgapi_trace;
+
+namespace
+{
+
+/* Return the address of the function NAME in the next libamd-dbgapi.  */
+void *
+real_function (const char *name)
+{
+  void *address = dlsym (RTLD_NEXT, name);
+  if (!address)
+    {
+      std::cerr << "libamd-dbgapi-record: " << name
+                << " not found: " << dlerror () << std::endl;
+      std::abort ();
+    }
+  return address;
+}
+
+#define REAL(function)                                                        \
+  (reinterpret_cast<decltype (&function)> ([] () {                            \
+    static void *address = real_function (#function);                         \
+    return address;                                                           \
+  }()))
+
+class trace_writer_t
+{
+public:
+  trace_writer_t ()
+  {
+    std::string path;
+    if (const char *env = ::getenv ("ROCM_DEBUG_AGENT_DBGAPI_TRACE"))
+      path = env;
+    else
+      path = "rocm-debug-agent." + std::to_string (::getpid ()) + ".trace";
+
+    m_fd = ::open (path.c_str (), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                   0666);
+    if (m_fd == -1)
+      {
+        std::cerr << "libamd-dbgapi-record: could not open `" << path
+                  << "': " << strerror (errno) << std::endl;
+        return;
+      }
+
+    const char *options = ::getenv ("ROCM_DEBUG_AGENT_OPTIONS");
+    m_buffer = trace_header (options ? options : "");
+  }
+
+  void write (const record_t &record)
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    append_record (m_buffer, record);
+    if (m_buffer.size () >= flush_threshold)
+      flush_locked ();
+  }
+
+  void flush ()
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    flush_locked ();
+  }
+
+private:
+  static constexpr size_t flush_threshold = 1 << 20;
+
+  void flush_locked ()
+  {
+    if (m_fd == -1)
+      {
+        m_buffer.clear ();
+        return;
+      }
+
+    for (size_t written = 0; written < m_buffer.size ();)
+      {
+        ssize_t ret = ::write (m_fd, m_buffer.data () + written,
+                               m_buffer.size () - written);
+        if (ret == -1 && errno == EINTR)
+          continue;
+        if (ret == -1)
+          {
+            std::cerr << "libamd-dbgapi-record: could not write the trace: "
+                      << strerror (errno) << std::endl;
+            break;
+          }
+        written += ret;
+      }
+    m_buffer.clear ();
+  }
+
+  std::mutex m_mutex;
+  int m_fd{ -1 };
+  std::string m_buffer;
+};
+
+/* Never destroyed, so that the calls made by the agent while the process
+   exits are still recorded.  */
+trace_writer_t *
+trace_writer ()
+{
+  static trace_writer_t *const writer = [] () {
+    std::atexit ([] () { trace_writer ()->flush (); });
+    return new trace_writer_t;
+  }();
+  return writer;
+}
+
+/* The number of dbgapi calls in progress in this thread.  The library may
+   call its own interface, and only the calls made by the agent are
+   recorded.  */
+thread_local size_t t_call_depth = 0;
+
+class call_t
+{
+public:
+  explicit call_t (function_t function) : m_function (function)
+  {
+    ++t_call_depth;
+  }
+  ~call_t () { --t_call_depth; }
+
+  call_t (const call_t &) = delete;
+  call_t &operator= (const call_t &) = delete;
+
+  amd_dbgapi_status_t record (amd_dbgapi_status_t status, std::string key,
+                              std::string output = {})
+  {
+    if (t_call_depth == 1)
+      trace_writer ()->write (
+          { m_function, std::move (key), status, std::move (output) });
+    return status;
+  }
+
+private:
+  function_t m_function;
+};
+
+/* The agent's callbacks, and the callbacks given to the library instead,
+   recording the breakpoint changes.  */
+amd_dbgapi_callbacks_t *g_client_callbacks;
+amd_dbgapi_callbacks_t g_callbacks;
+
+amd_dbgapi_status_t
+insert_breakpoint (amd_dbgapi_client_process_id_t client_process_id,
+                   amd_dbgapi_global_address_t address,
+                   amd_dbgapi_breakpoint_id_t breakpoint_id)
+{
+  amd_dbgapi_status_t status = g_client_callbacks->insert_breakpoint (
+      client_process_id, address, breakpoint_id);
+  trace_writer ()->write ({ function_t::insert_breakpoint_callback,
+                      make_key (address, breakpoint_id), status, {} });
+  return status;
+}
+
+amd_dbgapi_status_t
+remove_breakpoint (amd_dbgapi_client_process_id_t client_process_id,
+                   amd_dbgapi_breakpoint_id_t breakpoint_id)
+{
+  amd_dbgapi_status_t status
+      = g_client_callbacks->remove_breakpoint (client_process_id,
+                                               breakpoint_id);
+  trace_writer ()->write ({ function_t::remove_breakpoint_callback,
+                      make_key (breakpoint_id), status, {} });
+  return status;
+}
+
+/* Record a get_info call.  The queries in STRING_QUERIES return a string
+   allocated by the library, which is recorded instead of its address.  */
+template <function_t function, typename Id, typename Query>
+amd_dbgapi_status_t
+get_info (amd_dbgapi_status_t (*real) (Id, Query, size_t, void *), Id id,
+          Query query, size_t value_size, void *value,
+          std::initializer_list<Query> string_queries = {})
+{
+  call_t call (function);
+  amd_dbgapi_status_t status = real (id, query, value_size, value);
+
+  encoder_t output;
+  if (status == AMD_DBGAPI_STATUS_SUCCESS)
+    {
+      if (std::find (string_queries.begin (), string_queries.end (), query)
+          != string_queries.end ())
+        output.put_string (*static_cast<char **> (value));
+      else
+        output.put_bytes (value, value_size);
+    }
+
+  return call.record (status, make_key (id, query, value_size),
+                      output.release ());
+}
+
+/* Record a call returning a list of handles allocated by the library.  */
+template <function_t function, typename Id, typename Handle,
+          typename... Changed>
+amd_dbgapi_status_t
+get_list (amd_dbgapi_status_t (*real) (Id, size_t *, Handle **, Changed...),
+          Id id, size_t *count, Handle **list, Changed... changed)
+{
+  call_t call (function);
+  amd_dbgapi_status_t status = real (id, count, list, changed...);
+
+  encoder_t output;
+  if (status == AMD_DBGAPI_STATUS_SUCCESS)
+    {
+      /* The list is not returned if it did not change.  */
+      const bool unchanged
+          = ((changed && (output.put (*changed),
+                          *changed == AMD_DBGAPI_CHANGED_NO))
+             || ...);
+
+      if (!unchanged)
+        {
+          output.put (*count);
+          for (size_t i = 0; i < *count; ++i)
+            output.put ((*list)[i]);
+        }
+    }
+
+  return call.record (status,
+                      make_key (id, (changed != nullptr)...),
+                      output.release ());
+}
+
+/* The symbolizer given to the library while disassembling an instruction,
+   recording the addresses symbolized.  */
+struct symbolizer_t
+{
+  amd_dbgapi_symbolizer_id_t m_symbolizer_id;
+  amd_dbgapi_status_t (*m_symbolizer) (
+      amd_dbgapi_symbolizer_id_t symbolizer_id,
+      amd_dbgapi_global_address_t address, char **symbol_text);
+  std::vector<amd_dbgapi_global_address_t> m_addresses;
+
+  static amd_dbgapi_status_t
+  symbolize (amd_dbgapi_symbolizer_id_t symbolizer_id,
+             amd_dbgapi_global_address_t address, char **symbol_text)
+  {
+    auto &symbolizer = *reinterpret_cast<symbolizer_t *> (symbolizer_id);
+    symbolizer.m_addresses.push_back (address);
+    return symbolizer.m_symbolizer (symbolizer.m_symbolizer_id, address,
+                                    symbol_text);
+  }
+};
+
+} /* namespace */
+
+amd_dbgapi_status_t
+amd_dbgapi_initialize (amd_dbgapi_callbacks_t *callbacks)
+{
+  call_t call (function_t::initialize);
+
+  g_client_callbacks = callbacks;
+  if (callbacks)
+    {
+      g_callbacks = *callbacks;
+      g_callbacks.insert_breakpoint = insert_breakpoint;
+      g_callbacks.remove_breakpoint = remove_breakpoint;
+    }
+
+  return call.record (
+      REAL (amd_dbgapi_initialize) (callbacks ? &g_callbacks : nullptr), {});
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_finalize ()
+{
+  call_t call (function_t::finalize);
+  call.record (REAL (amd_dbgapi_finalize) (), {});
+  trace_writer ()->flush ();
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+void
+amd_dbgapi_set_log_level (amd_dbgapi_log_level_t level)
+{
+  REAL (amd_dbgapi_set_log_level) (level);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_get_architecture (uint32_t elf_amdgpu_machine,
+                             amd_dbgapi_architecture_id_t *architecture_id)
+{
+  call_t call (function_t::get_architecture);
+  amd_dbgapi_status_t status = REAL (amd_dbgapi_get_architecture) (
+      elf_amdgpu_machine, architecture_id);
+
+  encoder_t output;
+  if (status == AMD_DBGAPI_STATUS_SUCCESS)
+    output.put (*architecture_id);
+
+  return call.record (status, make_key (elf_amdgpu_machine),
+                      output.release ());
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_architecture_get_info (amd_dbgapi_architecture_id_t architecture_id,
+                                  amd_dbgapi_architecture_info_t query,
+                                  size_t value_size, void *value)
+{
+  return get_info<function_t::architecture_get_info> (
+      REAL (amd_dbgapi_architecture_get_info), architecture_id, query,
+      value_size, value, { AMD_DBGAPI_ARCHITECTURE_INFO_NAME });
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_architecture_register_class_list (
+    amd_dbgapi_architecture_id_t architecture_id, size_t *register_class_count,
+    amd_dbgapi_register_class_id_t **register_classes)
+{
+  return get_list<function_t::architecture_register_class_list> (
+      REAL (amd_dbgapi_architecture_register_class_list), architecture_id,
+      register_class_count, register_classes);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_architecture_register_class_get_info (
+    amd_dbgapi_register_class_id_t register_class_id,
+    amd_dbgapi_register_class_info_t query, size_t value_size, void *value)
+{
+  return get_info<function_t::architecture_register_class_get_info> (
+      REAL (amd_dbgapi_architecture_register_class_get_info),
+      register_class_id, query, value_size, value,
+      { AMD_DBGAPI_REGISTER_CLASS_INFO_NAME });
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_register_get_info (amd_dbgapi_register_id_t register_id,
+                              amd_dbgapi_register_info_t query,
+                              size_t value_size, void *value)
+{
+  return get_info<function_t::register_get_info> (
+      REAL (amd_dbgapi_register_get_info), register_id, query, value_size,
+      value, { AMD_DBGAPI_REGISTER_INFO_NAME, AMD_DBGAPI_REGISTER_INFO_TYPE });
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_register_is_in_register_class (
+    amd_dbgapi_register_class_id_t register_class_id,
+    amd_dbgapi_register_id_t register_id,
+    amd_dbgapi_register_class_state_t *register_class_state)
+{
+  call_t call (function_t::register_is_in_register_class);
+  amd_dbgapi_status_t status
+      = REAL (amd_dbgapi_register_is_in_register_class) (
+          register_class_id, register_id, register_class_state);
+
+  encoder_t output;
+  if (status == AMD_DBGAPI_STATUS_SUCCESS)
+    output.put (*register_class_state);
+
+  return call.record (status, make_key (register_class_id, register_id),
+                      output.release ());
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_wave_register_list (amd_dbgapi_wave_id_t wave_id,
+                               size_t *register_count,
+                               amd_dbgapi_register_id_t **registers)
+{
+  return get_list<function_t::wave_register_list> (
+      REAL (amd_dbgapi_wave_register_list), wave_id, register_count,
+      registers);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_read_register (amd_dbgapi_wave_id_t wave_id,
+                          amd_dbgapi_register_id_t register_id,
+                          amd_dbgapi_size_t offset,
+                          amd_dbgapi_size_t value_size, void *value)
+{
+  call_t call (function_t::read_register);
+  amd_dbgapi_status_t status = REAL (amd_dbgapi_read_register) (
+      wave_id, register_id, offset, value_size, value);
+
+  encoder_t output;
+  if (status == AMD_DBGAPI_STATUS_SUCCESS)
+    output.put_bytes (value, value_size);
+
+  return call.record (status,
+                      make_key (wave_id, register_id, offset, value_size),
+                      output.release ());
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_wave_get_info (amd_dbgapi_wave_id_t wave_id,
+                          amd_dbgapi_wave_info_t query, size_t value_size,
+                          void *value)
+{
+  return get_info<function_t::wave_get_info> (
+      REAL (amd_dbgapi_wave_get_info), wave_id, query, value_size, value);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_dispatch_get_info (amd_dbgapi_dispatch_id_t dispatch_id,
+                              amd_dbgapi_dispatch_info_t query,
+                              size_t value_size, void *value)
+{
+  return get_info<function_t::dispatch_get_info> (
+      REAL (amd_dbgapi_dispatch_get_info), dispatch_id, query, value_size,
+      value);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_dwarf_address_space_to_address_space (
+    amd_dbgapi_architecture_id_t architecture_id, uint64_t dwarf_address_space,
+    amd_dbgapi_address_space_id_t *address_space_id)
+{
+  call_t call (function_t::dwarf_address_space_to_address_space);
+  amd_dbgapi_status_t status
+      = REAL (amd_dbgapi_dwarf_address_space_to_address_space) (
+          architecture_id, dwarf_address_space, address_space_id);
+
+  encoder_t output;
+  if (status == AMD_DBGAPI_STATUS_SUCCESS)
+    output.put (*address_space_id);
+
+  return call.record (status, make_key (architecture_id, dwarf_address_space),
+                      output.release ());
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_read_memory (amd_dbgapi_process_id_t process_id,
+                        amd_dbgapi_wave_id_t wave_id,
+                        amd_dbgapi_lane_id_t lane_id,
+                        amd_dbgapi_address_space_id_t address_space_id,
+                        amd_dbgapi_segment_address_t segment_address,
+                        amd_dbgapi_size_t *value_size, void *value)
+{
+  call_t call (function_t::read_memory);
+  std::string key = make_key (process_id, wave_id, lane_id, address_space_id,
+                              segment_address, *value_size);
+  amd_dbgapi_status_t status
+      = REAL (amd_dbgapi_read_memory) (process_id, wave_id, lane_id,
+                                       address_space_id, segment_address,
+                                       value_size, value);
+
+  encoder_t output;
+  if (status == AMD_DBGAPI_STATUS_SUCCESS)
+    output.put_bytes (value, *value_size);
+
+  return call.record (status, std::move (key), output.release ());
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_next_pending_event (amd_dbgapi_process_id_t process_id,
+                                       amd_dbgapi_event_id_t *event_id,
+                                       amd_dbgapi_event_kind_t *kind)
+{
+  call_t call (function_t::process_next_pending_event);
+  amd_dbgapi_status_t status = REAL (amd_dbgapi_process_next_pending_event) (
+      process_id, event_id, kind);
+
+  encoder_t output;
+  if (status == AMD_DBGAPI_STATUS_SUCCESS)
+    output.put (*event_id).put (*kind);
+
+  return call.record (status, make_key (process_id), output.release ());
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_event_get_info (amd_dbgapi_event_id_t event_id,
+                           amd_dbgapi_event_info_t query, size_t value_size,
+                           void *value)
+{
+  return get_info<function_t::event_get_info> (
+      REAL (amd_dbgapi_event_get_info), event_id, query, value_size, value);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_event_processed (amd_dbgapi_event_id_t event_id)
+{
+  call_t call (function_t::event_processed);
+  return call.record (REAL (amd_dbgapi_event_processed) (event_id),
+                      make_key (event_id));
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_wave_list (amd_dbgapi_process_id_t process_id,
+                              size_t *wave_count, amd_dbgapi_wave_id_t **waves,
+                              amd_dbgapi_changed_t *changed)
+{
+  return get_list<function_t::process_wave_list> (
+      REAL (amd_dbgapi_process_wave_list), process_id, wave_count, waves,
+      changed);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_code_object_list (
+    amd_dbgapi_process_id_t process_id, size_t *code_object_count,
+    amd_dbgapi_code_object_id_t **code_objects, amd_dbgapi_changed_t *changed)
+{
+  return get_list<function_t::process_code_object_list> (
+      REAL (amd_dbgapi_process_code_object_list), process_id,
+      code_object_count, code_objects, changed);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_code_object_get_info (amd_dbgapi_code_object_id_t code_object_id,
+                                 amd_dbgapi_code_object_info_t query,
+                                 size_t value_size, void *value)
+{
+  return get_info<function_t::code_object_get_info> (
+      REAL (amd_dbgapi_code_object_get_info), code_object_id, query,
+      value_size, value, { AMD_DBGAPI_CODE_OBJECT_INFO_URI_NAME });
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_wave_stop (amd_dbgapi_wave_id_t wave_id)
+{
+  call_t call (function_t::wave_stop);
+  return call.record (REAL (amd_dbgapi_wave_stop) (wave_id),
+                      make_key (wave_id));
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_wave_resume (amd_dbgapi_wave_id_t wave_id,
+                        amd_dbgapi_resume_mode_t resume_mode,
+                        amd_dbgapi_exceptions_t exceptions)
+{
+  call_t call (function_t::wave_resume);
+  return call.record (
+      REAL (amd_dbgapi_wave_resume) (wave_id, resume_mode, exceptions),
+      make_key (wave_id, resume_mode, exceptions));
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_set_progress (amd_dbgapi_process_id_t process_id,
+                                 amd_dbgapi_progress_t progress)
+{
+  call_t call (function_t::process_set_progress);
+  amd_dbgapi_status_t status = call.record (
+      REAL (amd_dbgapi_process_set_progress) (process_id, progress),
+      make_key (process_id, progress));
+
+  /* The progress is restored at the end of each report.  */
+  if (progress == AMD_DBGAPI_PROGRESS_NORMAL)
+    trace_writer ()->flush ();
+
+  return status;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_set_wave_creation (amd_dbgapi_process_id_t process_id,
+                                      amd_dbgapi_wave_creation_t creation)
+{
+  call_t call (function_t::process_set_wave_creation);
+  return call.record (
+      REAL (amd_dbgapi_process_set_wave_creation) (process_id, creation),
+      make_key (process_id, creation));
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_attach (amd_dbgapi_client_process_id_t client_process_id,
+                           amd_dbgapi_process_id_t *process_id)
+{
+  call_t call (function_t::process_attach);
+  amd_dbgapi_status_t status
+      = REAL (amd_dbgapi_process_attach) (client_process_id, process_id);
+
+  encoder_t output;
+  if (status == AMD_DBGAPI_STATUS_SUCCESS)
+    output.put (*process_id);
+
+  return call.record (status, {}, output.release ());
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_detach (amd_dbgapi_process_id_t process_id)
+{
+  call_t call (function_t::process_detach);
+  amd_dbgapi_status_t status = call.record (
+      REAL (amd_dbgapi_process_detach) (process_id), make_key (process_id));
+  trace_writer ()->flush ();
+  return status;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_get_info (amd_dbgapi_process_id_t process_id,
+                             amd_dbgapi_process_info_t query,
+                             size_t value_size, void *value)
+{
+  return get_info<function_t::process_get_info> (
+      REAL (amd_dbgapi_process_get_info), process_id, query, value_size,
+      value);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_set_memory_precision (amd_dbgapi_process_id_t process_id,
+                                 amd_dbgapi_memory_precision_t precision)
+{
+  call_t call (function_t::set_memory_precision);
+  return call.record (
+      REAL (amd_dbgapi_set_memory_precision) (process_id, precision),
+      make_key (process_id, precision));
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_report_breakpoint_hit (
+    amd_dbgapi_breakpoint_id_t breakpoint_id,
+    amd_dbgapi_client_thread_id_t client_thread_id,
+    amd_dbgapi_breakpoint_action_t *breakpoint_action)
+{
+  call_t call (function_t::report_breakpoint_hit);
+  amd_dbgapi_status_t status = REAL (amd_dbgapi_report_breakpoint_hit) (
+      breakpoint_id, client_thread_id, breakpoint_action);
+
+  encoder_t output;
+  if (status == AMD_DBGAPI_STATUS_SUCCESS)
+    output.put (*breakpoint_action);
+
+  return call.record (status, make_key (breakpoint_id), output.release ());
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_disassemble_instruction (
+    amd_dbgapi_architecture_id_t architecture_id,
+    amd_dbgapi_global_address_t address, amd_dbgapi_size_t *size,
+    const void *memory, char **instruction_text,
+    amd_dbgapi_symbolizer_id_t symbolizer_id,
+    amd_dbgapi_status_t (*symbolizer) (
+        amd_dbgapi_symbolizer_id_t symbolizer_id,
+        amd_dbgapi_global_address_t address, char **symbol_text))
+{
+  call_t call (function_t::disassemble_instruction);
+
+  encoder_t key;
+  key.put (architecture_id).put (address).put (*size);
+  key.put_bytes (memory, *size).put (instruction_text != nullptr);
+
+  symbolizer_t recorder{ symbolizer_id, symbolizer, {} };
+  amd_dbgapi_status_t status = REAL (amd_dbgapi_disassemble_instruction) (
+      architecture_id, address, size, memory, instruction_text,
+      symbolizer ? reinterpret_cast<amd_dbgapi_symbolizer_id_t> (&recorder)
+                 : symbolizer_id,
+      symbolizer ? symbolizer_t::symbolize : nullptr);
+
+  encoder_t output;
+  if (status == AMD_DBGAPI_STATUS_SUCCESS)
+    {
+      output.put (*size);
+      if (instruction_text)
+        output.put_string (*instruction_text);
+      output.put (recorder.m_addresses.size ());
+      for (auto symbolized_address : recorder.m_addresses)
+        output.put (symbolized_address);
+    }
+
+  return call.record (status, key.release (), output.release ());
+}
@@ -0,0 +1,715 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+/* A stand-in for libamd-dbgapi that replays a trace written by the
+   recording library.  See dbgapi_replay.h.  */
+
+#include "dbgapi_replay.h"
+#include "dbgapi_trace.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <initializer_list>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace amd::debug_agent;
+using namespace amd::debug_agent::dbgapi_trace;
+
+namespace
+{
+
+/* A recorded result, and the callbacks invoked while it was computed.  */
+struct result_t
+{
+  amd_dbgapi_status_t m_status;
+  std::string m_output;
+  std::vector<record_t> m_callbacks;
+};
+
+/* The results of the calls of a function with the same input arguments.  */
+struct result_queue_t
+{
+  std::vector<result_t> m_results;
+  size_t m_next{ 0 };
+};
+
+/* The number of missing calls reported on stderr.  */
+constexpr uint64_t max_missing_call_warnings = 10;
+
+struct replay_t
+{
+  std::string m_agent_options;
+  std::optional<amd_dbgapi_global_address_t> m_breakpoint_address;
+
+  /* The result queues, by function and key.  */
+  std::unordered_map<std::string, result_queue_t> m_queues;
+
+  /* The number of recorded pending events not returned to the agent yet.  */
+  size_t m_pending_event_count{ 0 };
+
+  amd_dbgapi_callbacks_t *m_callbacks{ nullptr };
+  amd_dbgapi_client_process_id_t m_client_process_id{ nullptr };
+  int m_notifier[2]{ -1, -1 };
+
+  dbgapi_replay::statistics_t m_statistics;
+};
+
+replay_t g_replay;
+std::mutex g_mutex;
+std::condition_variable g_replayed_cv;
+
+std::string
+queue_key (function_t function, std::string_view key)
+{
+  std::string queue_key (1, static_cast<char> (function));
+  queue_key.append (key);
+  return queue_key;
+}
+
+void
+signal_notifier ()
+{
+  char byte = 0;
+  if (::write (g_replay.m_notifier[1], &byte, 1) == -1 && errno != EAGAIN)
+    std::cerr << "libamd-dbgapi-replay: could not signal the notifier: "
+              << strerror (errno) << std::endl;
+}
+
+/* Return the next recorded result of FUNCTION called with KEY, after
+   invoking the callbacks recorded with it.  Return nullptr if the call was
+   not recorded.  */
+const result_t *
+replay_call (function_t function, const std::string &key)
+{
+  const result_t *result;
+  {
+    std::lock_guard<std::mutex> lock (g_mutex);
+    ++g_replay.m_statistics.m_calls;
+
+    auto it = g_replay.m_queues.find (queue_key (function, key));
+    if (it == g_replay.m_queues.end ())
+      {
+        if (g_replay.m_statistics.m_missing_calls++
+            < max_missing_call_warnings)
+          std::cerr << "libamd-dbgapi-replay: call to function "
+                    << static_cast<int> (function) << " not in the trace"
+                    << std::endl;
+        return nullptr;
+      }
+
+    result_queue_t &queue = it->second;
+    if (queue.m_next == queue.m_results.size ())
+      {
+        /* Events are not repeated.  */
+        if (function == function_t::process_next_pending_event)
+          return nullptr;
+        return &queue.m_results.back ();
+      }
+
+    result = &queue.m_results[queue.m_next++];
+
+    if (function == function_t::process_next_pending_event
+        && !--g_replay.m_pending_event_count)
+      g_replayed_cv.notify_all ();
+  }
+
+  /* The results are never modified once loaded, so they can be used without
+     holding the lock.  */
+  for (auto &&callback : result->m_callbacks)
+    {
+      decoder_t args (callback.m_key);
+      if (callback.m_function == function_t::insert_breakpoint_callback)
+        {
+          auto address = args.get<amd_dbgapi_global_address_t> ();
+          auto breakpoint_id = args.get<amd_dbgapi_breakpoint_id_t> ();
+          g_replay.m_callbacks->insert_breakpoint (
+              g_replay.m_client_process_id, address, breakpoint_id);
+        }
+      else if (callback.m_function == function_t::remove_breakpoint_callback)
+        g_replay.m_callbacks->remove_breakpoint (
+            g_replay.m_client_process_id,
+            args.get<amd_dbgapi_breakpoint_id_t> ());
+    }
+
+  return result;
+}
+
+/* Replay a call returning only a status.  A call that was not recorded,
+   for example the detach of a process that aborted while recording,
+   succeeds.  */
+amd_dbgapi_status_t
+replay_status (function_t function, const std::string &key)
+{
+  const result_t *result = replay_call (function, key);
+  return result ? result->m_status : AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+/* Replay a call returning a single value in *VALUE.  */
+template <typename T>
+amd_dbgapi_status_t
+replay_value (function_t function, const std::string &key, T *value)
+{
+  const result_t *result = replay_call (function, key);
+  if (!result)
+    return AMD_DBGAPI_STATUS_ERROR;
+
+  if (result->m_status == AMD_DBGAPI_STATUS_SUCCESS)
+    *value = decoder_t (result->m_output).get<T> ();
+
+  return result->m_status;
+}
+
+char *
+allocate_string (std::string_view string)
+{
+  char *copy = static_cast<char *> (
+      g_replay.m_callbacks->allocate_memory (string.size () + 1));
+  std::memcpy (copy, string.data (), string.size ());
+  copy[string.size ()] = '\0';
+  return copy;
+}
+
+template <typename Id, typename Query>
+amd_dbgapi_status_t
+get_info (function_t function, Id id, Query query, size_t value_size,
+          void *value, std::initializer_list<Query> string_queries = {})
+{
+  const result_t *result
+      = replay_call (function, make_key (id, query, value_size));
+  if (!result)
+    return AMD_DBGAPI_STATUS_ERROR;
+
+  if (result->m_status == AMD_DBGAPI_STATUS_SUCCESS)
+    {
+      std::string_view bytes = decoder_t (result->m_output).get_bytes ();
+
+      if (std::find (string_queries.begin (), string_queries.end (), query)
+          != string_queries.end ())
+        *static_cast<char **> (value) = allocate_string (bytes);
+      else
+        std::memcpy (value, bytes.data (),
+                     std::min (bytes.size (), value_size));
+    }
+
+  return result->m_status;
+}
+
+/* Replay a call returning a list of handles.  CHANGED is empty for the
+   functions without a changed argument.  */
+template <typename Id, typename Handle, typename... Changed>
+amd_dbgapi_status_t
+get_list (function_t function, Id id, size_t *count, Handle **list,
+          Changed... changed)
+{
+  const result_t *result
+      = replay_call (function, make_key (id, (changed != nullptr)...));
+  if (!result)
+    return AMD_DBGAPI_STATUS_ERROR;
+
+  if (result->m_status == AMD_DBGAPI_STATUS_SUCCESS)
+    {
+      decoder_t output (result->m_output);
+
+      /* The list is not returned if it did not change.  */
+      const bool unchanged
+          = ((changed
+              && (*changed = output.get<amd_dbgapi_changed_t> ())
+                     == AMD_DBGAPI_CHANGED_NO)
+             || ...);
+
+      if (!unchanged)
+        {
+          *count = output.get<size_t> ();
+          *list = static_cast<Handle *> (
+              g_replay.m_callbacks->allocate_memory (*count
+                                                     * sizeof (Handle)));
+          for (size_t i = 0; i < *count; ++i)
+            (*list)[i] = output.get<Handle> ();
+        }
+    }
+
+  return result->m_status;
+}
+
+} /* namespace */
+
+namespace amd::debug_agent::dbgapi_replay
+{
+
+bool
+load (const std::string &path)
+{
+  std::optional<trace_t> trace = read_trace (path);
+  if (!trace)
+    return false;
+
+  std::lock_guard<std::mutex> lock (g_mutex);
+  g_replay.m_agent_options = std::move (trace->m_agent_options);
+
+  std::vector<record_t> callbacks;
+  for (auto &&record : trace->m_records)
+    {
+      if (record.m_function >= function_t::insert_breakpoint_callback)
+        {
+          if (record.m_function == function_t::insert_breakpoint_callback
+              && !g_replay.m_breakpoint_address)
+            g_replay.m_breakpoint_address
+                = decoder_t (record.m_key)
+                      .get<amd_dbgapi_global_address_t> ();
+
+          callbacks.emplace_back (std::move (record));
+          continue;
+        }
+
+      if (record.m_function == function_t::process_next_pending_event)
+        ++g_replay.m_pending_event_count;
+
+      g_replay.m_queues[queue_key (record.m_function, record.m_key)]
+          .m_results.push_back ({ record.m_status,
+                                  std::move (record.m_output),
+                                  std::move (callbacks) });
+      callbacks.clear ();
+    }
+
+  if (g_replay.m_notifier[0] == -1
+      && ::pipe2 (g_replay.m_notifier, O_CLOEXEC | O_NONBLOCK) == -1)
+    return false;
+
+  return true;
+}
+
+std::string
+agent_options ()
+{
+  std::lock_guard<std::mutex> lock (g_mutex);
+  return g_replay.m_agent_options;
+}
+
+std::optional<amd_dbgapi_global_address_t>
+breakpoint_address ()
+{
+  std::lock_guard<std::mutex> lock (g_mutex);
+  return g_replay.m_breakpoint_address;
+}
+
+bool
+wait_until_replayed (std::chrono::milliseconds timeout)
+{
+  std::unique_lock<std::mutex> lock (g_mutex);
+  return g_replayed_cv.wait_for (
+      lock, timeout, [] () { return !g_replay.m_pending_event_count; });
+}
+
+statistics_t
+statistics ()
+{
+  std::lock_guard<std::mutex> lock (g_mutex);
+  statistics_t statistics = g_replay.m_statistics;
+  for (auto &&[key, queue] : g_replay.m_queues)
+    statistics.m_unused_records += queue.m_results.size () - queue.m_next;
+  return statistics;
+}
+
+} /* namespace amd::debug_agent::dbgapi_replay */
+
+/* The dbgapi interface.  */
+
+amd_dbgapi_status_t
+amd_dbgapi_initialize (amd_dbgapi_callbacks_t *callbacks)
+{
+  if (!callbacks)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+
+  g_replay.m_callbacks = callbacks;
+  return replay_status (function_t::initialize, {});
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_finalize ()
+{
+  return replay_status (function_t::finalize, {});
+}
+
+void
+amd_dbgapi_set_log_level (amd_dbgapi_log_level_t level)
+{
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_get_architecture (uint32_t elf_amdgpu_machine,
+                             amd_dbgapi_architecture_id_t *architecture_id)
+{
+  return replay_value (function_t::get_architecture,
+                       make_key (elf_amdgpu_machine), architecture_id);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_architecture_get_info (amd_dbgapi_architecture_id_t architecture_id,
+                                  amd_dbgapi_architecture_info_t query,
+                                  size_t value_size, void *value)
+{
+  return get_info (function_t::architecture_get_info, architecture_id, query,
+                   value_size, value, { AMD_DBGAPI_ARCHITECTURE_INFO_NAME });
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_architecture_register_class_list (
+    amd_dbgapi_architecture_id_t architecture_id, size_t *register_class_count,
+    amd_dbgapi_register_class_id_t **register_classes)
+{
+  return get_list (function_t::architecture_register_class_list,
+                   architecture_id, register_class_count, register_classes);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_architecture_register_class_get_info (
+    amd_dbgapi_register_class_id_t register_class_id,
+    amd_dbgapi_register_class_info_t query, size_t value_size, void *value)
+{
+  return get_info (function_t::architecture_register_class_get_info,
+                   register_class_id, query, value_size, value,
+                   { AMD_DBGAPI_REGISTER_CLASS_INFO_NAME });
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_register_get_info (amd_dbgapi_register_id_t register_id,
+                              amd_dbgapi_register_info_t query,
+                              size_t value_size, void *value)
+{
+  return get_info (
+      function_t::register_get_info, register_id, query, value_size, value,
+      { AMD_DBGAPI_REGISTER_INFO_NAME, AMD_DBGAPI_REGISTER_INFO_TYPE });
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_register_is_in_register_class (
+    amd_dbgapi_register_class_id_t register_class_id,
+    amd_dbgapi_register_id_t register_id,
+    amd_dbgapi_register_class_state_t *register_class_state)
+{
+  return replay_value (function_t::register_is_in_register_class,
+                       make_key (register_class_id, register_id),
+                       register_class_state);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_wave_register_list (amd_dbgapi_wave_id_t wave_id,
+                               size_t *register_count,
+                               amd_dbgapi_register_id_t **registers)
+{
+  return get_list (function_t::wave_register_list, wave_id, register_count,
+                   registers);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_read_register (amd_dbgapi_wave_id_t wave_id,
+                          amd_dbgapi_register_id_t register_id,
+                          amd_dbgapi_size_t offset,
+                          amd_dbgapi_size_t value_size, void *value)
+{
+  const result_t *result = replay_call (
+      function_t::read_register,
+      make_key (wave_id, register_id, offset, value_size));
+  if (!result)
+    return AMD_DBGAPI_STATUS_ERROR;
+
+  if (result->m_status == AMD_DBGAPI_STATUS_SUCCESS)
+    {
+      std::string_view bytes = decoder_t (result->m_output).get_bytes ();
+      std::memcpy (value, bytes.data (), std::min (bytes.size (), value_size));
+    }
+
+  return result->m_status;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_wave_get_info (amd_dbgapi_wave_id_t wave_id,
+                          amd_dbgapi_wave_info_t query, size_t value_size,
+                          void *value)
+{
+  return get_info (function_t::wave_get_info, wave_id, query, value_size,
+                   value);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_dispatch_get_info (amd_dbgapi_dispatch_id_t dispatch_id,
+                              amd_dbgapi_dispatch_info_t query,
+                              size_t value_size, void *value)
+{
+  return get_info (function_t::dispatch_get_info, dispatch_id, query,
+                   value_size, value);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_dwarf_address_space_to_address_space (
+    amd_dbgapi_architecture_id_t architecture_id, uint64_t dwarf_address_space,
+    amd_dbgapi_address_space_id_t *address_space_id)
+{
+  return replay_value (function_t::dwarf_address_space_to_address_space,
+                       make_key (architecture_id, dwarf_address_space),
+                       address_space_id);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_read_memory (amd_dbgapi_process_id_t process_id,
+                        amd_dbgapi_wave_id_t wave_id,
+                        amd_dbgapi_lane_id_t lane_id,
+                        amd_dbgapi_address_space_id_t address_space_id,
+                        amd_dbgapi_segment_address_t segment_address,
+                        amd_dbgapi_size_t *value_size, void *value)
+{
+  const result_t *result = replay_call (
+      function_t::read_memory, make_key (process_id, wave_id, lane_id,
+                                         address_space_id, segment_address,
+                                         *value_size));
+  if (!result)
+    return AMD_DBGAPI_STATUS_ERROR;
+
+  if (result->m_status == AMD_DBGAPI_STATUS_SUCCESS)
+    {
+      std::string_view bytes = decoder_t (result->m_output).get_bytes ();
+      *value_size = std::min<amd_dbgapi_size_t> (bytes.size (), *value_size);
+      std::memcpy (value, bytes.data (), *value_size);
+    }
+
+  return result->m_status;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_next_pending_event (amd_dbgapi_process_id_t process_id,
+                                       amd_dbgapi_event_id_t *event_id,
+                                       amd_dbgapi_event_kind_t *kind)
+{
+  const result_t *result = replay_call (
+      function_t::process_next_pending_event, make_key (process_id));
+
+  *event_id = AMD_DBGAPI_EVENT_NONE;
+  *kind = AMD_DBGAPI_EVENT_KIND_NONE;
+
+  if (!result)
+    return AMD_DBGAPI_STATUS_SUCCESS;
+
+  if (result->m_status == AMD_DBGAPI_STATUS_SUCCESS)
+    {
+      decoder_t output (result->m_output);
+      *event_id = output.get<amd_dbgapi_event_id_t> ();
+      *kind = output.get<amd_dbgapi_event_kind_t> ();
+    }
+
+  /* Wake up the agent again for the events recorded after this drain.  */
+  if (event_id->handle == AMD_DBGAPI_EVENT_NONE.handle)
+    {
+      std::lock_guard<std::mutex> lock (g_mutex);
+      if (g_replay.m_pending_event_count)
+        signal_notifier ();
+    }
+
+  return result->m_status;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_event_get_info (amd_dbgapi_event_id_t event_id,
+                           amd_dbgapi_event_info_t query, size_t value_size,
+                           void *value)
+{
+  return get_info (function_t::event_get_info, event_id, query, value_size,
+                   value);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_event_processed (amd_dbgapi_event_id_t event_id)
+{
+  return replay_status (function_t::event_processed, make_key (event_id));
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_wave_list (amd_dbgapi_process_id_t process_id,
+                              size_t *wave_count, amd_dbgapi_wave_id_t **waves,
+                              amd_dbgapi_changed_t *changed)
+{
+  return get_list (function_t::process_wave_list, process_id, wave_count,
+                   waves, changed);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_code_object_list (
+    amd_dbgapi_process_id_t process_id, size_t *code_object_count,
+    amd_dbgapi_code_object_id_t **code_objects, amd_dbgapi_changed_t *changed)
+{
+  return get_list (function_t::process_code_object_list, process_id,
+                   code_object_count, code_objects, changed);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_code_object_get_info (amd_dbgapi_code_object_id_t code_object_id,
+                                 amd_dbgapi_code_object_info_t query,
+                                 size_t value_size, void *value)
+{
+  return get_info (function_t::code_object_get_info, code_object_id, query,
+                   value_size, value,
+                   { AMD_DBGAPI_CODE_OBJECT_INFO_URI_NAME });
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_wave_stop (amd_dbgapi_wave_id_t wave_id)
+{
+  return replay_status (function_t::wave_stop, make_key (wave_id));
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_wave_resume (amd_dbgapi_wave_id_t wave_id,
+                        amd_dbgapi_resume_mode_t resume_mode,
+                        amd_dbgapi_exceptions_t exceptions)
+{
+  return replay_status (function_t::wave_resume,
+                        make_key (wave_id, resume_mode, exceptions));
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_set_progress (amd_dbgapi_process_id_t process_id,
+                                 amd_dbgapi_progress_t progress)
+{
+  return replay_status (function_t::process_set_progress,
+                        make_key (process_id, progress));
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_set_wave_creation (amd_dbgapi_process_id_t process_id,
+                                      amd_dbgapi_wave_creation_t creation)
+{
+  return replay_status (function_t::process_set_wave_creation,
+                        make_key (process_id, creation));
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_attach (amd_dbgapi_client_process_id_t client_process_id,
+                           amd_dbgapi_process_id_t *process_id)
+{
+  g_replay.m_client_process_id = client_process_id;
+  amd_dbgapi_status_t status
+      = replay_value (function_t::process_attach, {}, process_id);
+
+  std::lock_guard<std::mutex> lock (g_mutex);
+  if (g_replay.m_pending_event_count)
+    signal_notifier ();
+
+  return status;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_detach (amd_dbgapi_process_id_t process_id)
+{
+  return replay_status (function_t::process_detach, make_key (process_id));
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_get_info (amd_dbgapi_process_id_t process_id,
+                             amd_dbgapi_process_info_t query,
+                             size_t value_size, void *value)
+{
+  /* The recorded notifier is replaced with the replay's.  */
+  if (query == AMD_DBGAPI_PROCESS_INFO_NOTIFIER
+      && value_size == sizeof (amd_dbgapi_notifier_t))
+    {
+      *static_cast<amd_dbgapi_notifier_t *> (value) = g_replay.m_notifier[0];
+      return AMD_DBGAPI_STATUS_SUCCESS;
+    }
+
+  return get_info (function_t::process_get_info, process_id, query,
+                   value_size, value);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_set_memory_precision (amd_dbgapi_process_id_t process_id,
+                                 amd_dbgapi_memory_precision_t precision)
+{
+  return replay_status (function_t::set_memory_precision,
+                        make_key (process_id, precision));
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_report_breakpoint_hit (
+    amd_dbgapi_breakpoint_id_t breakpoint_id,
+    amd_dbgapi_client_thread_id_t client_thread_id,
+    amd_dbgapi_breakpoint_action_t *breakpoint_action)
+{
+  return replay_value (function_t::report_breakpoint_hit,
+                       make_key (breakpoint_id), breakpoint_action);
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_disassemble_instruction (
+    amd_dbgapi_architecture_id_t architecture_id,
+    amd_dbgapi_global_address_t address, amd_dbgapi_size_t *size,
+    const void *memory, char **instruction_text,
+    amd_dbgapi_symbolizer_id_t symbolizer_id,
+    amd_dbgapi_status_t (*symbolizer) (
+        amd_dbgapi_symbolizer_id_t symbolizer_id,
+        amd_dbgapi_global_address_t address, char **symbol_text))
+{
+  encoder_t key;
+  key.put (architecture_id).put (address).put (*size);
+  key.put_bytes (memory, *size).put (instruction_text != nullptr);
+
+  const result_t *result
+      = replay_call (function_t::disassemble_instruction, key.str ());
+  if (!result)
+    return AMD_DBGAPI_STATUS_ERROR;
+
+  if (result->m_status == AMD_DBGAPI_STATUS_SUCCESS)
+    {
+      decoder_t output (result->m_output);
+      *size = output.get<amd_dbgapi_size_t> ();
+      if (instruction_text)
+        *instruction_text = allocate_string (output.get_bytes ());
+
+      /* Symbolize the same addresses, for the agent's work to be the same as
+         when recording.  */
+      for (size_t count = output.get<size_t> (); count; --count)
+        {
+          auto symbolized_address = output.get<amd_dbgapi_global_address_t> ();
+          char *symbol_text;
+          if (symbolizer
+              && symbolizer (symbolizer_id, symbolized_address, &symbol_text)
+                     == AMD_DBGAPI_STATUS_SUCCESS)
+            g_replay.m_callbacks->deallocate_memory (symbol_text);
+        }
+    }
+
+  return result->m_status;
+}
@@ -0,0 +1,82 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#ifndef _ROCM_DEBUG_AGENT_DBGAPI_REPLAY_H
+#define _ROCM_DEBUG_AGENT_DBGAPI_REPLAY_H 1
+
+#include <amd-dbgapi/amd-dbgapi.h>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/* Control of the replay libamd-dbgapi.
+
+   The replay library implements the dbgapi interface used by the agent by
+   serving the results recorded in a trace by the recording library.  The
+   results of the calls with the same function and input arguments are
+   served in the order they were recorded, and the last one is repeated once
+   they are exhausted.  The pending events are served in order, and the
+   notifier is signaled until they are all returned to the agent.  */
+
+namespace amd::debug_agent::dbgapi_replay
+{
+
+struct statistics_t
+{
+  /* The number of calls to the dbgapi interface.  */
+  uint64_t m_calls{ 0 };
+  /* The number of calls that do not match any recorded call.  */
+  uint64_t m_missing_calls{ 0 };
+  /* The number of recorded calls that were not replayed.  */
+  uint64_t m_unused_records{ 0 };
+};
+
+/* Load the trace PATH.  Must be called before the agent initializes the
+   library.  Return false if the trace cannot be read.  */
+bool load (const std::string &path);
+
+/* The ROCM_DEBUG_AGENT_OPTIONS of the recorded process.  */
+std::string agent_options ();
+
+/* The address of the first breakpoint inserted by the recorded library,
+   the runtime's r_debug breakpoint.  */
+std::optional<amd_dbgapi_global_address_t> breakpoint_address ();
+
+/* Wait until all the recorded events were returned to the agent.  Return
+   false if they were not within TIMEOUT.  */
+bool wait_until_replayed (std::chrono::milliseconds timeout);
+
+statistics_t statistics ();
+
+} /* namespace amd::debug_agent::dbgapi_replay */
+
+#endif /* _ROCM_DEBUG_AGENT_DBGAPI_REPLAY_H */
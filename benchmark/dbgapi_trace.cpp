@@ -0,0 +1,96 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#include "dbgapi_trace.h"
+
+#include <fstream>
+#include <iterator>
+
+namespace amd::debug_agent::dbgapi_trace
+{
+
+std::string
+trace_header (std::string_view agent_options)
+{
+  encoder_t encoder;
+  encoder.put_string (agent_options);
+  return std::string (magic, sizeof (magic) - 1) + encoder.str ();
+}
+
+void
+append_record (std::string &buffer, const record_t &record)
+{
+  encoder_t encoder;
+  encoder.put (record.m_function)
+      .put_string (record.m_key)
+      .put (record.m_status)
+      .put_string (record.m_output);
+  buffer.append (encoder.str ());
+}
+
+std::optional<trace_t>
+read_trace (const std::string &path)
+{
+  std::ifstream file (path, std::ios::binary);
+  if (!file)
+    return {};
+
+  const std::string data{ std::istreambuf_iterator<char> (file),
+                          std::istreambuf_iterator<char> () };
+
+  const std::string_view header (magic, sizeof (magic) - 1);
+  if (std::string_view (data).substr (0, header.size ()) != header)
+    return {};
+
+  decoder_t decoder (std::string_view (data).substr (header.size ()));
+
+  trace_t trace;
+  trace.m_agent_options = decoder.get_bytes ();
+  if (!decoder.ok ())
+    return {};
+
+  while (!decoder.empty ())
+    {
+      record_t record;
+      record.m_function = decoder.get<function_t> ();
+      record.m_key = decoder.get_bytes ();
+      record.m_status = decoder.get<amd_dbgapi_status_t> ();
+      record.m_output = decoder.get_bytes ();
+
+      if (!decoder.ok ())
+        break;
+
+      trace.m_records.emplace_back (std::move (record));
+    }
+
+  return trace;
+}
+
+} /* namespace amd::debug_agent::dbgapi_trace */
@@ -0,0 +1,268 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#ifndef _ROCM_DEBUG_AGENT_DBGAPI_TRACE_H
+#define _ROCM_DEBUG_AGENT_DBGAPI_TRACE_H 1
+
+#include <amd-dbgapi/amd-dbgapi.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/* The format of the dbgapi traces written by the recording library and read
+   by the replay library.
+
+   A trace is the magic string, the ROCM_DEBUG_AGENT_OPTIONS of the recorded
+   process, and a sequence of records.  A record is the function called, the
+   key encoding its input arguments, the status returned, and the output
+   encoding the values returned through its pointer arguments.  The callbacks
+   invoked by the library during a call are recorded just before the call.
+
+   Integers, enumerations and handles are encoded as LEB128 varints, signed
+   values zigzag encoded first, and strings and byte arrays as their varint
+   size followed by their bytes.  */
+
+namespace amd::debug_agent::dbgapi_trace
+{
+
+/* The values are part of the trace format.  */
+enum class function_t : uint8_t
+{
+  initialize = 1,
+  finalize,
+  get_architecture,
+  architecture_get_info,
+  architecture_register_class_list,
+  architecture_register_class_get_info,
+  register_get_info,
+  register_is_in_register_class,
+  wave_register_list,
+  read_register,
+  wave_get_info,
+  dispatch_get_info,
+  dwarf_address_space_to_address_space,
+  read_memory,
+  process_next_pending_event,
+  event_get_info,
+  event_processed,
+  process_wave_list,
+  process_code_object_list,
+  code_object_get_info,
+  wave_stop,
+  wave_resume,
+  process_set_progress,
+  process_set_wave_creation,
+  process_attach,
+  process_detach,
+  process_get_info,
+  set_memory_precision,
+  report_breakpoint_hit,
+  disassemble_instruction,
+
+  insert_breakpoint_callback = 64,
+  remove_breakpoint_callback
+};
+
+constexpr char magic[] = "ROCDBGTRACE1";
+
+namespace detail
+{
+
+template <typename T, typename = void> struct is_handle : std::false_type
+{
+};
+
+template <typename T>
+struct is_handle<T, std::void_t<decltype (std::declval<T> ().handle)>>
+    : std::true_type
+{
+};
+
+} /* namespace detail */
+
+/* Append encoded values to a string.  */
+class encoder_t
+{
+public:
+  encoder_t &put_varint (uint64_t value)
+  {
+    do
+      {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        m_data.push_back (value ? byte | 0x80 : byte);
+      }
+    while (value);
+    return *this;
+  }
+
+  /* Encode an integer, an enumeration or a handle.  */
+  template <typename T> encoder_t &put (const T &value)
+  {
+    if constexpr (detail::is_handle<T>::value)
+      return put_varint (value.handle);
+    else if constexpr (std::is_enum_v<T>)
+      return put (static_cast<std::underlying_type_t<T>> (value));
+    else if constexpr (std::is_signed_v<T>)
+      return put_varint ((static_cast<uint64_t> (value) << 1)
+                         ^ static_cast<uint64_t> (
+                             static_cast<int64_t> (value) >> 63));
+    else
+      return put_varint (value);
+  }
+
+  encoder_t &put_bytes (const void *data, size_t size)
+  {
+    put_varint (size);
+    m_data.append (static_cast<const char *> (data), size);
+    return *this;
+  }
+
+  encoder_t &put_string (std::string_view string)
+  {
+    return put_bytes (string.data (), string.size ());
+  }
+
+  const std::string &str () const { return m_data; }
+  std::string release () { return std::move (m_data); }
+
+private:
+  std::string m_data;
+};
+
+/* Return the key encoding ARGS.  */
+template <typename... Args>
+std::string
+make_key (const Args &...args)
+{
+  encoder_t encoder;
+  (encoder.put (args), ...);
+  return encoder.release ();
+}
+
+/* Decode the values appended by an encoder_t.  Reading past the end of the
+   data returns zeros and clears ok ().  */
+class decoder_t
+{
+public:
+  explicit decoder_t (std::string_view data) : m_data (data) {}
+
+  uint64_t get_varint ()
+  {
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+      {
+        if (m_data.empty ())
+          {
+            m_ok = false;
+            return 0;
+          }
+
+        uint8_t byte = m_data.front ();
+        m_data.remove_prefix (1);
+        value |= static_cast<uint64_t> (byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+          break;
+      }
+    return value;
+  }
+
+  template <typename T> T get ()
+  {
+    if constexpr (detail::is_handle<T>::value)
+      return T{ get_varint () };
+    else if constexpr (std::is_enum_v<T>)
+      return static_cast<T> (get<std::underlying_type_t<T>> ());
+    else if constexpr (std::is_signed_v<T>)
+      {
+        uint64_t value = get_varint ();
+        return static_cast<T> ((value >> 1) ^ -(value & 1));
+      }
+    else
+      return static_cast<T> (get_varint ());
+  }
+
+  std::string_view get_bytes ()
+  {
+    size_t size = get_varint ();
+    if (size > m_data.size ())
+      {
+        m_ok = false;
+        size = m_data.size ();
+      }
+
+    std::string_view bytes = m_data.substr (0, size);
+    m_data.remove_prefix (size);
+    return bytes;
+  }
+
+  bool empty () const { return m_data.empty (); }
+  bool ok () const { return m_ok; }
+
+private:
+  std::string_view m_data;
+  bool m_ok{ true };
+};
+
+struct record_t
+{
+  function_t m_function;
+  std::string m_key;
+  amd_dbgapi_status_t m_status;
+  std::string m_output;
+};
+
+/* Return the start of the trace of a process whose agent options are
+   AGENT_OPTIONS.  */
+std::string trace_header (std::string_view agent_options);
+
+/* Append RECORD to the trace BUFFER.  */
+void append_record (std::string &buffer, const record_t &record);
+
+struct trace_t
+{
+  std::string m_agent_options;
+  std::vector<record_t> m_records;
+};
+
+/* Read the trace file PATH.  Return an empty optional if the file cannot be
+   read or is not a trace.  A record truncated by the end of the file, for
+   example because the recorded process was killed, is ignored.  */
+std::optional<trace_t> read_trace (const std::string &path);
+
+} /* namespace amd::debug_agent::dbgapi_trace */
+
+#endif /* _ROCM_DEBUG_AGENT_DBGAPI_TRACE_H */
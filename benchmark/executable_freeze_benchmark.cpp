@@ -0,0 +1,168 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+/* Measure the overhead the ROCdebug-agent adds to hsa_executable_freeze and
+   hsa_executable_destroy, which wait for the agent to report the code object
+   list change to dbgapi.
+
+   Usage: executable-freeze-benchmark [THREAD_COUNT...]
+
+   For each THREAD_COUNT (1, 4 and 16 by default), that many threads each
+   create, freeze and destroy empty executables, as an application loading
+   many modules concurrently would.  Run it once without the agent, and once
+   with it loaded:
+
+     HSA_TOOLS_LIB=librocm-debug-agent.so.2 HSA_ENABLE_DEBUG=1 \
+       executable-freeze-benchmark  */
+
+#include <hsa/hsa.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using clock_type = std::chrono::steady_clock;
+
+/* The number of executables each thread freezes and destroys.  */
+constexpr size_t iteration_count = 1000;
+
+void
+check (hsa_status_t status, const char *what)
+{
+  if (status == HSA_STATUS_SUCCESS)
+    return;
+
+  const char *message = "unknown error";
+  hsa_status_string (status, &message);
+  std::cerr << "error: " << what << " failed: " << message << std::endl;
+  std::exit (EXIT_FAILURE);
+}
+
+struct thread_times_t
+{
+  double freeze_ns{ 0 };
+  double destroy_ns{ 0 };
+};
+
+thread_times_t
+freeze_executables ()
+{
+  thread_times_t times;
+
+  for (size_t i = 0; i < iteration_count; ++i)
+    {
+      hsa_executable_t executable;
+      check (hsa_executable_create_alt (
+                 HSA_PROFILE_FULL, HSA_DEFAULT_FLOAT_ROUNDING_MODE_DEFAULT,
+                 nullptr, &executable),
+             "hsa_executable_create_alt");
+
+      auto start = clock_type::now ();
+      check (hsa_executable_freeze (executable, nullptr),
+             "hsa_executable_freeze");
+      auto frozen = clock_type::now ();
+      check (hsa_executable_destroy (executable), "hsa_executable_destroy");
+      auto destroyed = clock_type::now ();
+
+      using nanoseconds_t = std::chrono::duration<double, std::nano>;
+      times.freeze_ns += nanoseconds_t (frozen - start).count ();
+      times.destroy_ns += nanoseconds_t (destroyed - frozen).count ();
+    }
+
+  return times;
+}
+
+void
+run (size_t thread_count)
+{
+  std::vector<thread_times_t> times (thread_count);
+  std::vector<std::thread> threads;
+
+  auto start = clock_type::now ();
+  for (size_t i = 0; i < thread_count; ++i)
+    threads.emplace_back (
+        [&times, i] () { times[i] = freeze_executables (); });
+  for (auto &&thread : threads)
+    thread.join ();
+  double elapsed_ns
+      = std::chrono::duration<double, std::nano> (clock_type::now () - start)
+            .count ();
+
+  thread_times_t total;
+  for (auto &&thread_times : times)
+    {
+      total.freeze_ns += thread_times.freeze_ns;
+      total.destroy_ns += thread_times.destroy_ns;
+    }
+
+  const size_t call_count = thread_count * iteration_count;
+  std::cout << std::right << std::setw (8) << thread_count << std::fixed
+            << std::setprecision (2) << std::setw (14)
+            << total.freeze_ns / call_count / 1e3 << std::setw (14)
+            << total.destroy_ns / call_count / 1e3 << std::setw (14)
+            << call_count / (elapsed_ns / 1e9) / 1e3 << std::endl;
+}
+
+} /* namespace */
+
+int
+main (int argc, char **argv)
+{
+  std::vector<size_t> thread_counts;
+  for (int i = 1; i < argc; ++i)
+    thread_counts.push_back (std::strtoul (argv[i], nullptr, 0));
+
+  if (thread_counts.empty ())
+    thread_counts = { 1, 4, 16 };
+
+  check (hsa_init (), "hsa_init");
+
+  const char *tools_lib = std::getenv ("HSA_TOOLS_LIB");
+  std::cout << "tools library: " << (tools_lib ? tools_lib : "none")
+            << std::endl;
+
+  std::cout << std::right << std::setw (8) << "threads" << std::setw (14)
+            << "freeze (us)" << std::setw (14) << "destroy (us)"
+            << std::setw (14) << "kexec/s" << std::endl;
+
+  for (size_t thread_count : thread_counts)
+    run (std::max<size_t> (thread_count, 1));
+
+  check (hsa_shut_down (), "hsa_shut_down");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,1416 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+/* A stand-in for libamd-dbgapi that simulates a process in host memory.  See
+   fake_dbgapi.h.  */
+
+#include "fake_dbgapi.h"
+#include "synthetic_code_object.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+using namespace amd::debug_agent;
+using namespace amd::debug_agent::fake_dbgapi;
+
+namespace
+{
+
+using stop_reason_t = std::underlying_type_t<amd_dbgapi_wave_stop_reasons_t>;
+
+struct architecture_t
+{
+  const char *m_name;
+  uint32_t m_elf_amdgpu_machine;
+};
+
+constexpr architecture_t architectures[] = {
+  { "amdgcn-amd-amdhsa--gfx90a", 0x3f },
+  { "amdgcn-amd-amdhsa--gfx942", 0x4c },
+  { "amdgcn-amd-amdhsa--gfx1100", 0x41 },
+  { "amdgcn-amd-amdhsa--gfx1200", 0x48 },
+};
+
+constexpr amd_dbgapi_size_t largest_instruction_size = 8;
+
+enum register_class_t : uint32_t
+{
+  general = 1 << 0,
+  vector = 1 << 1,
+  scalar = 1 << 2,
+  system = 1 << 3
+};
+
+constexpr const char *register_class_names[]
+    = { "general", "vector", "scalar", "system" };
+
+struct simulated_register_t
+{
+  std::string m_name;
+  std::string m_type;
+  amd_dbgapi_size_t m_size;
+  /* The register_class_t the register is a member of.  */
+  uint32_t m_classes;
+};
+
+/* The local address space, returned for DW_ASPACE_AMDGPU_local.  */
+constexpr amd_dbgapi_address_space_id_t local_address_space{ 3 };
+
+constexpr amd_dbgapi_process_id_t process_id{ 1 };
+constexpr amd_dbgapi_breakpoint_id_t r_brk_breakpoint_id{ 1 };
+
+struct wave_t
+{
+  amd_dbgapi_wave_state_t m_state;
+  stop_reason_t m_stop_reason;
+};
+
+struct event_t
+{
+  amd_dbgapi_event_kind_t m_kind;
+  amd_dbgapi_wave_id_t m_wave_id;
+};
+
+struct loaded_code_object_t
+{
+  synthetic_code_object_t m_code_object;
+  std::string m_uri;
+  /* The handle of the code object's id, which changes when it is
+     reloaded.  */
+  uint64_t m_handle{ 0 };
+};
+
+/* The state of the simulated process.  */
+struct process_t
+{
+  config_t m_config;
+  const amd_dbgapi_callbacks_t *m_callbacks{ nullptr };
+  amd_dbgapi_client_process_id_t m_client_process_id{ nullptr };
+  bool m_attached{ false };
+
+  /* The registers of each architecture, the same for all of them.  */
+  std::vector<simulated_register_t> m_registers;
+
+  /* The code objects are loaded where their image is in host memory, which
+     is read with the xfer_global_memory callback.  */
+  std::vector<loaded_code_object_t> m_code_objects;
+  bool m_code_object_list_changed{ true };
+  uint64_t m_next_code_object_handle{ 1 };
+
+  /* Wave handles are not reused when the waves are replaced.  */
+  std::vector<wave_t> m_waves;
+  uint64_t m_first_wave_handle{ 1 };
+  size_t m_stopped_wave_count{ 0 };
+
+  uint64_t m_next_event_handle{ 1 };
+  std::deque<std::pair<uint64_t, event_t>> m_pending_events;
+  std::unordered_map<uint64_t, event_t> m_reported_events;
+  /* The read and write ends of the notifier pipe.  */
+  int m_notifier[2]{ -1, -1 };
+
+  amd_dbgapi_progress_t m_progress{ AMD_DBGAPI_PROGRESS_NORMAL };
+  amd_dbgapi_wave_creation_t m_wave_creation{
+    AMD_DBGAPI_WAVE_CREATION_NORMAL
+  };
+
+  statistics_t m_statistics;
+};
+
+std::mutex g_mutex;
+std::condition_variable g_running_cv;
+process_t g_process;
+
+/* Serialize the calls, like dbgapi does, and count them.  */
+class api_call_t
+{
+public:
+  api_call_t () : m_lock (g_mutex) { ++g_process.m_statistics.m_calls; }
+
+private:
+  std::lock_guard<std::mutex> m_lock;
+};
+
+bool
+is_running ()
+{
+  return g_process.m_attached && g_process.m_stopped_wave_count == 0
+         && g_process.m_pending_events.empty ()
+         && g_process.m_reported_events.empty ()
+         && g_process.m_progress == AMD_DBGAPI_PROGRESS_NORMAL
+         && g_process.m_wave_creation == AMD_DBGAPI_WAVE_CREATION_NORMAL;
+}
+
+void
+notify_if_running ()
+{
+  if (is_running ())
+    g_running_cv.notify_all ();
+}
+
+void
+queue_event (amd_dbgapi_event_kind_t kind,
+             amd_dbgapi_wave_id_t wave_id = AMD_DBGAPI_WAVE_NONE)
+{
+  g_process.m_pending_events.emplace_back (g_process.m_next_event_handle++,
+                                           event_t{ kind, wave_id });
+
+  if (write (g_process.m_notifier[1], "", 1) == -1)
+    {
+      /* The pipe is full, so the agent is notified already.  */
+    }
+}
+
+std::vector<simulated_register_t>
+make_registers (const config_t &config)
+{
+  std::vector<simulated_register_t> registers = {
+    { "pc", "uint64_t", 8, general },
+    { "exec", "uint64_t", 8, general | scalar },
+    { "status", "uint32_t", 4, system },
+    { "mode", "uint32_t", 4, system },
+    { "trapsts", "uint32_t", 4, system },
+    { "m0", "uint32_t", 4, general | scalar },
+  };
+
+  for (size_t i = 0; i < config.m_sgpr_count; ++i)
+    registers.push_back (
+        { "s" + std::to_string (i), "uint32_t", 4, general | scalar });
+
+  const std::string vector_type
+      = "int32_t[" + std::to_string (config.m_lane_count) + "]";
+  for (size_t i = 0; i < config.m_vgpr_count; ++i)
+    registers.push_back ({ "v" + std::to_string (i), vector_type,
+                           4 * config.m_lane_count, general | vector });
+
+  return registers;
+}
+
+const architecture_t *
+find_architecture (amd_dbgapi_architecture_id_t architecture_id)
+{
+  if (architecture_id.handle == 0
+      || architecture_id.handle > g_process.m_config.m_architecture_count
+      || architecture_id.handle > std::size (architectures))
+    return nullptr;
+
+  return &architectures[architecture_id.handle - 1];
+}
+
+/* Register and register class handles are the architecture handle in the high
+   32 bits, and the index in the low 32 bits.  */
+constexpr uint64_t
+make_handle (amd_dbgapi_architecture_id_t architecture_id, size_t index)
+{
+  return (architecture_id.handle << 32) | index;
+}
+
+bool
+split_handle (uint64_t handle, size_t count,
+              amd_dbgapi_architecture_id_t &architecture_id, size_t &index)
+{
+  architecture_id = { handle >> 32 };
+  index = handle & 0xffffffff;
+  return find_architecture (architecture_id) && index < count;
+}
+
+wave_t *
+find_wave (amd_dbgapi_wave_id_t wave_id)
+{
+  if (wave_id.handle < g_process.m_first_wave_handle
+      || (wave_id.handle - g_process.m_first_wave_handle)
+             >= g_process.m_waves.size ())
+    return nullptr;
+
+  return &g_process.m_waves[wave_id.handle - g_process.m_first_wave_handle];
+}
+
+size_t
+wave_index (amd_dbgapi_wave_id_t wave_id)
+{
+  return wave_id.handle - g_process.m_first_wave_handle;
+}
+
+/* The layout of the waves: the waves are assigned to dispatches, and the
+   dispatches to architectures and to the functions of the code objects, in
+   turn.  */
+
+size_t
+wave_dispatch (size_t wave_index)
+{
+  return wave_index / g_process.m_config.m_waves_per_dispatch;
+}
+
+size_t
+dispatch_count ()
+{
+  const size_t waves_per_dispatch = g_process.m_config.m_waves_per_dispatch;
+  return (g_process.m_waves.size () + waves_per_dispatch - 1)
+         / waves_per_dispatch;
+}
+
+amd_dbgapi_architecture_id_t
+dispatch_architecture (size_t dispatch)
+{
+  return { dispatch % g_process.m_config.m_architecture_count + 1 };
+}
+
+amd_dbgapi_global_address_t
+load_address (const loaded_code_object_t &code_object)
+{
+  return reinterpret_cast<uintptr_t> (
+      code_object.m_code_object.m_image.data ());
+}
+
+const synthetic_function_t &
+dispatch_function (size_t dispatch, amd_dbgapi_global_address_t *load_address_)
+{
+  const auto &code_object
+      = g_process.m_code_objects[dispatch % g_process.m_code_objects.size ()];
+  const auto &functions = code_object.m_code_object.m_functions;
+
+  *load_address_ = load_address (code_object);
+  return functions[(dispatch / g_process.m_code_objects.size ())
+                   % functions.size ()];
+}
+
+size_t
+wave_workgroup (size_t wave_index)
+{
+  return (wave_index % g_process.m_config.m_waves_per_dispatch)
+         / g_process.m_config.m_waves_per_workgroup;
+}
+
+amd_dbgapi_global_address_t
+wave_pc (size_t wave_index)
+{
+  amd_dbgapi_global_address_t load_address;
+  const synthetic_function_t &function
+      = dispatch_function (wave_dispatch (wave_index), &load_address);
+
+  /* The waves of a workgroup are stopped at different instructions.  */
+  const size_t block_count = function.m_size / synthetic_block_size;
+  const size_t block
+      = (wave_index % g_process.m_config.m_waves_per_workgroup * 2 + 1)
+        % block_count;
+
+  return load_address + function.m_address + block * synthetic_block_size;
+}
+
+/* Return the 32-bit word at INDEX of a register of a wave.  Half of the
+   vector registers have the same value in all the lanes.  */
+uint32_t
+register_word (uint64_t wave_handle, size_t register_index, size_t index)
+{
+  if (register_index % 2)
+    return static_cast<uint32_t> (wave_handle * 0x9e37 + register_index);
+
+  return static_cast<uint32_t> ((wave_handle << 8) + register_index * 0x100
+                                + index);
+}
+
+/* Return the 32-bit word at INDEX of the local memory of a workgroup.  Only
+   the first quarter of the local memory is not zero.  */
+uint32_t
+local_memory_word (size_t dispatch, size_t workgroup, size_t index)
+{
+  if (index >= g_process.m_config.m_local_memory_size / 16)
+    return 0;
+
+  return static_cast<uint32_t> ((dispatch << 24) ^ (workgroup << 12) ^ index);
+}
+
+template <typename T>
+amd_dbgapi_status_t
+get_info (size_t value_size, void *value, const T &result)
+{
+  if (!value)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+
+  if (value_size != sizeof (T))
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY;
+
+  std::memcpy (value, &result, sizeof (T));
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+get_string_info (size_t value_size, void *value, const std::string &result)
+{
+  if (!value)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+
+  if (value_size != sizeof (char *))
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY;
+
+  char *string = static_cast<char *> (
+      g_process.m_callbacks->allocate_memory (result.size () + 1));
+  std::memcpy (string, result.c_str (), result.size () + 1);
+
+  *static_cast<char **> (value) = string;
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+/* Return in *LIST a copy of ELEMENTS, allocated with the client's
+   allocate_memory callback.  */
+template <typename T>
+void
+allocate_list (const std::vector<T> &elements, size_t *count, T **list)
+{
+  *count = elements.size ();
+  *list = static_cast<T *> (
+      g_process.m_callbacks->allocate_memory (elements.size () * sizeof (T)));
+  std::copy (elements.begin (), elements.end (), *list);
+}
+
+#define CHECK_INITIALIZED()                                                   \
+  do                                                                          \
+    {                                                                         \
+      if (!g_process.m_callbacks)                                             \
+        return AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED;                       \
+    }                                                                         \
+  while (false)
+
+#define CHECK_PROCESS(process_id_)                                            \
+  do                                                                          \
+    {                                                                         \
+      CHECK_INITIALIZED ();                                                   \
+      if (!g_process.m_attached || (process_id_).handle != process_id.handle) \
+        return AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID;                    \
+    }                                                                         \
+  while (false)
+
+} /* namespace */
+
+namespace amd::debug_agent::fake_dbgapi
+{
+
+void
+configure (const config_t &config)
+{
+  std::lock_guard<std::mutex> lock (g_mutex);
+  g_process.m_config = config;
+
+  g_process.m_config.m_architecture_count
+      = std::clamp<size_t> (config.m_architecture_count, 1,
+                            std::size (architectures));
+  g_process.m_config.m_code_object_count
+      = std::max<size_t> (config.m_code_object_count, 1);
+  g_process.m_config.m_functions_per_code_object
+      = std::max<size_t> (config.m_functions_per_code_object, 1);
+  g_process.m_config.m_waves_per_workgroup
+      = std::max<size_t> (config.m_waves_per_workgroup, 1);
+  g_process.m_config.m_waves_per_dispatch
+      = std::max (config.m_waves_per_dispatch,
+                  g_process.m_config.m_waves_per_workgroup);
+}
+
+void
+create_waves (size_t wave_count)
+{
+  std::lock_guard<std::mutex> lock (g_mutex);
+
+  g_process.m_first_wave_handle += g_process.m_waves.size ();
+  g_process.m_waves.assign (wave_count,
+                            { AMD_DBGAPI_WAVE_STATE_RUN,
+                              AMD_DBGAPI_WAVE_STOP_REASON_NONE });
+  g_process.m_stopped_wave_count = 0;
+}
+
+void
+stop_waves (size_t wave_count, amd_dbgapi_wave_stop_reasons_t stop_reason)
+{
+  std::lock_guard<std::mutex> lock (g_mutex);
+
+  auto &waves = g_process.m_waves;
+  if (!wave_count || waves.empty ())
+    return;
+
+  const size_t stride = std::max<size_t> (waves.size () / wave_count, 1);
+  for (size_t i = 0; i < waves.size () && wave_count; i += stride)
+    {
+      if (waves[i].m_state != AMD_DBGAPI_WAVE_STATE_RUN)
+        continue;
+
+      waves[i] = { AMD_DBGAPI_WAVE_STATE_STOP,
+                   static_cast<stop_reason_t> (stop_reason) };
+      ++g_process.m_stopped_wave_count;
+      --wave_count;
+
+      queue_event (AMD_DBGAPI_EVENT_KIND_WAVE_STOP,
+                   { g_process.m_first_wave_handle + i });
+    }
+}
+
+void
+reload_code_object (size_t index)
+{
+  std::lock_guard<std::mutex> lock (g_mutex);
+
+  if (index >= g_process.m_code_objects.size ())
+    return;
+
+  g_process.m_code_objects[index].m_handle
+      = g_process.m_next_code_object_handle++;
+  g_process.m_code_object_list_changed = true;
+
+  if (g_process.m_attached)
+    queue_event (AMD_DBGAPI_EVENT_KIND_CODE_OBJECT_LIST_UPDATED);
+}
+
+void
+wait_until_running ()
+{
+  std::unique_lock<std::mutex> lock (g_mutex);
+  g_running_cv.wait (lock, is_running);
+}
+
+statistics_t
+statistics ()
+{
+  std::lock_guard<std::mutex> lock (g_mutex);
+  return g_process.m_statistics;
+}
+
+} /* namespace amd::debug_agent::fake_dbgapi */
+
+/* The dbgapi interface.  */
+
+amd_dbgapi_status_t
+amd_dbgapi_initialize (amd_dbgapi_callbacks_t *callbacks)
+{
+  api_call_t call;
+
+  if (g_process.m_callbacks)
+    return AMD_DBGAPI_STATUS_ERROR_ALREADY_INITIALIZED;
+
+  if (!callbacks)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+
+  g_process.m_callbacks = callbacks;
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_finalize ()
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  g_process.m_callbacks = nullptr;
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+void
+amd_dbgapi_set_log_level (amd_dbgapi_log_level_t level)
+{
+  api_call_t call;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_get_architecture (uint32_t elf_amdgpu_machine,
+                             amd_dbgapi_architecture_id_t *architecture_id)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  if (!architecture_id)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+
+  for (size_t i = 0; i < g_process.m_config.m_architecture_count; ++i)
+    if (architectures[i].m_elf_amdgpu_machine == elf_amdgpu_machine)
+      {
+        *architecture_id = { i + 1 };
+        return AMD_DBGAPI_STATUS_SUCCESS;
+      }
+
+  return AMD_DBGAPI_STATUS_ERROR_INVALID_ELF_AMDGPU_MACHINE;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_architecture_get_info (amd_dbgapi_architecture_id_t architecture_id,
+                                  amd_dbgapi_architecture_info_t query,
+                                  size_t value_size, void *value)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  const architecture_t *architecture = find_architecture (architecture_id);
+  if (!architecture)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARCHITECTURE_ID;
+
+  switch (query)
+    {
+    case AMD_DBGAPI_ARCHITECTURE_INFO_NAME:
+      return get_string_info (value_size, value, architecture->m_name);
+
+    case AMD_DBGAPI_ARCHITECTURE_INFO_ELF_AMDGPU_MACHINE:
+      return get_info (value_size, value, architecture->m_elf_amdgpu_machine);
+
+    case AMD_DBGAPI_ARCHITECTURE_INFO_LARGEST_INSTRUCTION_SIZE:
+      return get_info (value_size, value, largest_instruction_size);
+
+    default:
+      return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+    }
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_architecture_register_class_list (
+    amd_dbgapi_architecture_id_t architecture_id,
+    size_t *register_class_count,
+    amd_dbgapi_register_class_id_t **register_classes)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  if (!find_architecture (architecture_id))
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARCHITECTURE_ID;
+
+  if (!register_class_count || !register_classes)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+
+  std::vector<amd_dbgapi_register_class_id_t> class_ids;
+  for (size_t i = 0; i < std::size (register_class_names); ++i)
+    class_ids.push_back ({ make_handle (architecture_id, i) });
+
+  allocate_list (class_ids, register_class_count, register_classes);
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_architecture_register_class_get_info (
+    amd_dbgapi_register_class_id_t register_class_id,
+    amd_dbgapi_register_class_info_t query, size_t value_size, void *value)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  amd_dbgapi_architecture_id_t architecture_id;
+  size_t index;
+  if (!split_handle (register_class_id.handle,
+                     std::size (register_class_names),
+                     architecture_id, index))
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_REGISTER_CLASS_ID;
+
+  switch (query)
+    {
+    case AMD_DBGAPI_REGISTER_CLASS_INFO_ARCHITECTURE:
+      return get_info (value_size, value, architecture_id);
+
+    case AMD_DBGAPI_REGISTER_CLASS_INFO_NAME:
+      return get_string_info (value_size, value, register_class_names[index]);
+
+    default:
+      return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+    }
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_register_get_info (amd_dbgapi_register_id_t register_id,
+                              amd_dbgapi_register_info_t query,
+                              size_t value_size, void *value)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  amd_dbgapi_architecture_id_t architecture_id;
+  size_t index;
+  if (!split_handle (register_id.handle, g_process.m_registers.size (),
+                     architecture_id, index))
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_REGISTER_ID;
+
+  const simulated_register_t &register_ = g_process.m_registers[index];
+
+  switch (query)
+    {
+    case AMD_DBGAPI_REGISTER_INFO_ARCHITECTURE:
+      return get_info (value_size, value, architecture_id);
+
+    case AMD_DBGAPI_REGISTER_INFO_NAME:
+      return get_string_info (value_size, value, register_.m_name);
+
+    case AMD_DBGAPI_REGISTER_INFO_TYPE:
+      return get_string_info (value_size, value, register_.m_type);
+
+    case AMD_DBGAPI_REGISTER_INFO_SIZE:
+      return get_info (value_size, value, register_.m_size);
+
+    default:
+      return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+    }
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_register_is_in_register_class (
+    amd_dbgapi_register_class_id_t register_class_id,
+    amd_dbgapi_register_id_t register_id,
+    amd_dbgapi_register_class_state_t *register_class_state)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  amd_dbgapi_architecture_id_t class_architecture_id;
+  size_t class_index;
+  if (!split_handle (register_class_id.handle,
+                     std::size (register_class_names),
+                     class_architecture_id, class_index))
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_REGISTER_CLASS_ID;
+
+  amd_dbgapi_architecture_id_t architecture_id;
+  size_t index;
+  if (!split_handle (register_id.handle, g_process.m_registers.size (),
+                     architecture_id, index)
+      || architecture_id.handle != class_architecture_id.handle)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_REGISTER_ID;
+
+  if (!register_class_state)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+
+  *register_class_state
+      = (g_process.m_registers[index].m_classes & (1 << class_index))
+            ? AMD_DBGAPI_REGISTER_CLASS_STATE_MEMBER
+            : AMD_DBGAPI_REGISTER_CLASS_STATE_NOT_MEMBER;
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_wave_register_list (amd_dbgapi_wave_id_t wave_id,
+                               size_t *register_count,
+                               amd_dbgapi_register_id_t **registers)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  if (!find_wave (wave_id))
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID;
+
+  if (!register_count || !registers)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+
+  const amd_dbgapi_architecture_id_t architecture_id
+      = dispatch_architecture (wave_dispatch (wave_index (wave_id)));
+
+  std::vector<amd_dbgapi_register_id_t> register_ids;
+  for (size_t i = 0; i < g_process.m_registers.size (); ++i)
+    register_ids.push_back ({ make_handle (architecture_id, i) });
+
+  allocate_list (register_ids, register_count, registers);
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_read_register (amd_dbgapi_wave_id_t wave_id,
+                          amd_dbgapi_register_id_t register_id,
+                          amd_dbgapi_size_t offset,
+                          amd_dbgapi_size_t value_size, void *value)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  const wave_t *wave = find_wave (wave_id);
+  if (!wave)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID;
+
+  amd_dbgapi_architecture_id_t architecture_id;
+  size_t index;
+  if (!split_handle (register_id.handle, g_process.m_registers.size (),
+                     architecture_id, index)
+      || architecture_id.handle
+             != dispatch_architecture (wave_dispatch (wave_index (wave_id)))
+                    .handle)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_REGISTER_ID;
+
+  if (wave->m_state != AMD_DBGAPI_WAVE_STATE_STOP)
+    return AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED;
+
+  const simulated_register_t &register_ = g_process.m_registers[index];
+  if (!value || offset + value_size > register_.m_size)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY;
+
+  std::vector<uint32_t> words ((register_.m_size + 3) / 4);
+  if (register_.m_name == "pc")
+    {
+      uint64_t pc = wave_pc (wave_index (wave_id));
+      std::memcpy (words.data (), &pc, sizeof (pc));
+    }
+  else
+    for (size_t i = 0; i < words.size (); ++i)
+      words[i] = register_word (wave_id.handle, index, i);
+
+  std::memcpy (value, reinterpret_cast<char *> (words.data ()) + offset,
+               value_size);
+
+  g_process.m_statistics.m_register_bytes_read += value_size;
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_wave_get_info (amd_dbgapi_wave_id_t wave_id,
+                          amd_dbgapi_wave_info_t query, size_t value_size,
+                          void *value)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  const wave_t *wave = find_wave (wave_id);
+  if (!wave)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID;
+
+  const size_t index = wave_index (wave_id);
+
+  switch (query)
+    {
+    case AMD_DBGAPI_WAVE_INFO_STATE:
+      return get_info (value_size, value, wave->m_state);
+
+    case AMD_DBGAPI_WAVE_INFO_PROCESS:
+      return get_info (value_size, value, process_id);
+
+    case AMD_DBGAPI_WAVE_INFO_ARCHITECTURE:
+      return get_info (value_size, value,
+                       dispatch_architecture (wave_dispatch (index)));
+
+    case AMD_DBGAPI_WAVE_INFO_DISPATCH:
+      return get_info (value_size, value,
+                       amd_dbgapi_dispatch_id_t{ wave_dispatch (index) + 1 });
+
+    default:
+      break;
+    }
+
+  if (wave->m_state != AMD_DBGAPI_WAVE_STATE_STOP)
+    return AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED;
+
+  switch (query)
+    {
+    case AMD_DBGAPI_WAVE_INFO_STOP_REASON:
+      return get_info (value_size, value, wave->m_stop_reason);
+
+    case AMD_DBGAPI_WAVE_INFO_PC:
+      return get_info (value_size, value, wave_pc (index));
+
+    case AMD_DBGAPI_WAVE_INFO_WORKGROUP_COORD:
+      {
+        const uint32_t workgroup = wave_workgroup (index);
+        return get_info (value_size, value,
+                         std::array<uint32_t, 3>{ workgroup % 64,
+                                                  workgroup / 64 % 64,
+                                                  workgroup / 4096 });
+      }
+
+    default:
+      return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+    }
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_dispatch_get_info (amd_dbgapi_dispatch_id_t dispatch_id,
+                              amd_dbgapi_dispatch_info_t query,
+                              size_t value_size, void *value)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  if (dispatch_id.handle == 0 || dispatch_id.handle > dispatch_count ())
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_DISPATCH_ID;
+
+  switch (query)
+    {
+    case AMD_DBGAPI_DISPATCH_INFO_PROCESS:
+      return get_info (value_size, value, process_id);
+
+    case AMD_DBGAPI_DISPATCH_INFO_ARCHITECTURE:
+      return get_info (value_size, value,
+                       dispatch_architecture (dispatch_id.handle - 1));
+
+    case AMD_DBGAPI_DISPATCH_INFO_KERNEL_CODE_ENTRY_ADDRESS:
+      {
+        amd_dbgapi_global_address_t load_address;
+        const synthetic_function_t &function
+            = dispatch_function (dispatch_id.handle - 1, &load_address);
+        return get_info (value_size, value,
+                         load_address + function.m_address);
+      }
+
+    default:
+      return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+    }
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_dwarf_address_space_to_address_space (
+    amd_dbgapi_architecture_id_t architecture_id, uint64_t dwarf_address_space,
+    amd_dbgapi_address_space_id_t *address_space_id)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  if (!find_architecture (architecture_id))
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARCHITECTURE_ID;
+
+  if (!address_space_id)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+
+  switch (dwarf_address_space)
+    {
+    case 0x0 /* DW_ASPACE_none */:
+      *address_space_id = AMD_DBGAPI_ADDRESS_SPACE_GLOBAL;
+      return AMD_DBGAPI_STATUS_SUCCESS;
+
+    case 0x3 /* DW_ASPACE_AMDGPU_local */:
+      *address_space_id = local_address_space;
+      return AMD_DBGAPI_STATUS_SUCCESS;
+
+    default:
+      return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+    }
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_read_memory (amd_dbgapi_process_id_t process_id_,
+                        amd_dbgapi_wave_id_t wave_id,
+                        amd_dbgapi_lane_id_t lane_id,
+                        amd_dbgapi_address_space_id_t address_space_id,
+                        amd_dbgapi_segment_address_t segment_address,
+                        amd_dbgapi_size_t *value_size, void *value)
+{
+  api_call_t call;
+  CHECK_PROCESS (process_id_);
+
+  if (!value_size || !value)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+
+  if (address_space_id.handle == AMD_DBGAPI_ADDRESS_SPACE_GLOBAL.handle)
+    {
+      if (g_process.m_callbacks->xfer_global_memory (
+              g_process.m_client_process_id, segment_address, value_size,
+              value, nullptr)
+          != AMD_DBGAPI_STATUS_SUCCESS)
+        return AMD_DBGAPI_STATUS_ERROR_MEMORY_ACCESS;
+
+      g_process.m_statistics.m_memory_bytes_read += *value_size;
+      return AMD_DBGAPI_STATUS_SUCCESS;
+    }
+
+  if (address_space_id.handle != local_address_space.handle)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ADDRESS_SPACE_ID;
+
+  const wave_t *wave = find_wave (wave_id);
+  if (!wave)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID;
+
+  if (wave->m_state != AMD_DBGAPI_WAVE_STATE_STOP)
+    return AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED;
+
+  const size_t local_memory_size = g_process.m_config.m_local_memory_size;
+  if (segment_address >= local_memory_size)
+    return AMD_DBGAPI_STATUS_ERROR_MEMORY_ACCESS;
+
+  const size_t index = wave_index (wave_id);
+  const size_t dispatch = wave_dispatch (index);
+  const size_t workgroup = wave_workgroup (index);
+
+  *value_size = std::min (*value_size, local_memory_size - segment_address);
+  auto *bytes = static_cast<uint8_t *> (value);
+  for (size_t i = 0; i < *value_size; ++i)
+    {
+      const size_t address = segment_address + i;
+      bytes[i] = local_memory_word (dispatch, workgroup, address / 4)
+                 >> (address % 4 * 8);
+    }
+
+  g_process.m_statistics.m_memory_bytes_read += *value_size;
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_next_pending_event (amd_dbgapi_process_id_t process_id_,
+                                       amd_dbgapi_event_id_t *event_id,
+                                       amd_dbgapi_event_kind_t *kind)
+{
+  api_call_t call;
+  CHECK_PROCESS (process_id_);
+
+  if (!event_id || !kind)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+
+  auto &pending_events = g_process.m_pending_events;
+  if (pending_events.empty ())
+    {
+      *event_id = AMD_DBGAPI_EVENT_NONE;
+      *kind = AMD_DBGAPI_EVENT_KIND_NONE;
+      return AMD_DBGAPI_STATUS_SUCCESS;
+    }
+
+  auto [handle, event] = pending_events.front ();
+  pending_events.pop_front ();
+  g_process.m_reported_events.emplace (handle, event);
+
+  *event_id = { handle };
+  *kind = event.m_kind;
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_event_get_info (amd_dbgapi_event_id_t event_id,
+                           amd_dbgapi_event_info_t query, size_t value_size,
+                           void *value)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  auto it = g_process.m_reported_events.find (event_id.handle);
+  if (it == g_process.m_reported_events.end ())
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_EVENT_ID;
+
+  const event_t &event = it->second;
+
+  switch (query)
+    {
+    case AMD_DBGAPI_EVENT_INFO_PROCESS:
+      return get_info (value_size, value, process_id);
+
+    case AMD_DBGAPI_EVENT_INFO_KIND:
+      return get_info (value_size, value, event.m_kind);
+
+    case AMD_DBGAPI_EVENT_INFO_WAVE:
+      if (event.m_kind != AMD_DBGAPI_EVENT_KIND_WAVE_STOP)
+        return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+      return get_info (value_size, value, event.m_wave_id);
+
+    case AMD_DBGAPI_EVENT_INFO_RUNTIME_STATE:
+      if (event.m_kind != AMD_DBGAPI_EVENT_KIND_RUNTIME)
+        return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+      return get_info (value_size, value,
+                       AMD_DBGAPI_RUNTIME_STATE_LOADED_SUCCESS);
+
+    default:
+      return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+    }
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_event_processed (amd_dbgapi_event_id_t event_id)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  if (!g_process.m_reported_events.erase (event_id.handle))
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_EVENT_ID;
+
+  notify_if_running ();
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_wave_list (amd_dbgapi_process_id_t process_id_,
+                              size_t *wave_count,
+                              amd_dbgapi_wave_id_t **waves,
+                              amd_dbgapi_changed_t *changed)
+{
+  api_call_t call;
+  CHECK_PROCESS (process_id_);
+
+  if (!wave_count || !waves)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+
+  if (changed)
+    *changed = AMD_DBGAPI_CHANGED_YES;
+
+  *wave_count = g_process.m_waves.size ();
+  *waves = static_cast<amd_dbgapi_wave_id_t *> (
+      g_process.m_callbacks->allocate_memory (*wave_count
+                                              * sizeof (**waves)));
+  for (size_t i = 0; i < *wave_count; ++i)
+    (*waves)[i] = { g_process.m_first_wave_handle + i };
+
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_code_object_list (
+    amd_dbgapi_process_id_t process_id_, size_t *code_object_count,
+    amd_dbgapi_code_object_id_t **code_objects, amd_dbgapi_changed_t *changed)
+{
+  api_call_t call;
+  CHECK_PROCESS (process_id_);
+
+  if (!code_object_count || !code_objects)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+
+  if (changed)
+    {
+      *changed = g_process.m_code_object_list_changed
+                     ? AMD_DBGAPI_CHANGED_YES
+                     : AMD_DBGAPI_CHANGED_NO;
+      if (!g_process.m_code_object_list_changed)
+        return AMD_DBGAPI_STATUS_SUCCESS;
+    }
+  g_process.m_code_object_list_changed = false;
+
+  std::vector<amd_dbgapi_code_object_id_t> code_object_ids;
+  for (auto &&code_object : g_process.m_code_objects)
+    code_object_ids.push_back ({ code_object.m_handle });
+
+  allocate_list (code_object_ids, code_object_count, code_objects);
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_code_object_get_info (amd_dbgapi_code_object_id_t code_object_id,
+                                 amd_dbgapi_code_object_info_t query,
+                                 size_t value_size, void *value)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  auto it = std::find_if (g_process.m_code_objects.begin (),
+                          g_process.m_code_objects.end (),
+                          [&] (const loaded_code_object_t &code_object) {
+                            return code_object.m_handle
+                                   == code_object_id.handle;
+                          });
+  if (it == g_process.m_code_objects.end ())
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_CODE_OBJECT_ID;
+
+  const loaded_code_object_t &code_object = *it;
+
+  switch (query)
+    {
+    case AMD_DBGAPI_CODE_OBJECT_INFO_PROCESS:
+      return get_info (value_size, value, process_id);
+
+    case AMD_DBGAPI_CODE_OBJECT_INFO_URI_NAME:
+      return get_string_info (value_size, value, code_object.m_uri);
+
+    case AMD_DBGAPI_CODE_OBJECT_INFO_LOAD_ADDRESS:
+      return get_info (value_size, value, load_address (code_object));
+
+    default:
+      return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+    }
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_wave_stop (amd_dbgapi_wave_id_t wave_id)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  wave_t *wave = find_wave (wave_id);
+  if (!wave)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID;
+
+  if (wave->m_state == AMD_DBGAPI_WAVE_STATE_STOP)
+    return AMD_DBGAPI_STATUS_ERROR_WAVE_STOPPED;
+
+  /* The wave stops immediately, and reports it with an event.  */
+  *wave = { AMD_DBGAPI_WAVE_STATE_STOP, AMD_DBGAPI_WAVE_STOP_REASON_NONE };
+  ++g_process.m_stopped_wave_count;
+  queue_event (AMD_DBGAPI_EVENT_KIND_WAVE_STOP, wave_id);
+
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_wave_resume (amd_dbgapi_wave_id_t wave_id,
+                        amd_dbgapi_resume_mode_t resume_mode,
+                        amd_dbgapi_exceptions_t exceptions)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  wave_t *wave = find_wave (wave_id);
+  if (!wave)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID;
+
+  if (wave->m_state != AMD_DBGAPI_WAVE_STATE_STOP)
+    return AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED;
+
+  /* The exceptions would be delivered to the runtime, which would abort the
+     process.  The simulated process keeps running instead.  */
+  if (exceptions != AMD_DBGAPI_EXCEPTION_NONE)
+    ++g_process.m_statistics.m_exceptions_delivered;
+
+  *wave = { AMD_DBGAPI_WAVE_STATE_RUN, AMD_DBGAPI_WAVE_STOP_REASON_NONE };
+  --g_process.m_stopped_wave_count;
+
+  notify_if_running ();
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_set_progress (amd_dbgapi_process_id_t process_id_,
+                                 amd_dbgapi_progress_t progress)
+{
+  api_call_t call;
+  CHECK_PROCESS (process_id_);
+
+  g_process.m_progress = progress;
+  notify_if_running ();
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_set_wave_creation (amd_dbgapi_process_id_t process_id_,
+                                      amd_dbgapi_wave_creation_t creation)
+{
+  api_call_t call;
+  CHECK_PROCESS (process_id_);
+
+  g_process.m_wave_creation = creation;
+  notify_if_running ();
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_attach (amd_dbgapi_client_process_id_t client_process_id,
+                           amd_dbgapi_process_id_t *process_id_)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  if (g_process.m_attached)
+    return AMD_DBGAPI_STATUS_ERROR_ALREADY_ATTACHED;
+
+  if (!process_id_)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+
+  if (pipe2 (g_process.m_notifier, O_CLOEXEC | O_NONBLOCK) == -1)
+    return AMD_DBGAPI_STATUS_ERROR;
+
+  const config_t &config = g_process.m_config;
+  g_process.m_client_process_id = client_process_id;
+  g_process.m_registers = make_registers (config);
+
+  if (g_process.m_code_objects.empty ())
+    for (size_t i = 0; i < config.m_code_object_count; ++i)
+      {
+        loaded_code_object_t &code_object
+            = g_process.m_code_objects.emplace_back ();
+        code_object.m_code_object = make_synthetic_code_object (
+            { config.m_functions_per_code_object, config.m_function_size,
+              architectures[i % config.m_architecture_count]
+                  .m_elf_amdgpu_machine });
+
+        char uri[64];
+        std::snprintf (uri, sizeof (uri), "memory://%d#offset=0x%lx&size=%zu",
+                       getpid (), load_address (code_object),
+                       code_object.m_code_object.m_image.size ());
+        code_object.m_uri = uri;
+        code_object.m_handle = g_process.m_next_code_object_handle++;
+      }
+  g_process.m_code_object_list_changed = true;
+
+  if (config.m_r_brk)
+    g_process.m_callbacks->insert_breakpoint (
+        client_process_id, config.m_r_brk, r_brk_breakpoint_id);
+
+  g_process.m_attached = true;
+  queue_event (AMD_DBGAPI_EVENT_KIND_RUNTIME);
+  queue_event (AMD_DBGAPI_EVENT_KIND_CODE_OBJECT_LIST_UPDATED);
+
+  *process_id_ = process_id;
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_detach (amd_dbgapi_process_id_t process_id_)
+{
+  api_call_t call;
+  CHECK_PROCESS (process_id_);
+
+  if (g_process.m_config.m_r_brk)
+    g_process.m_callbacks->remove_breakpoint (g_process.m_client_process_id,
+                                              r_brk_breakpoint_id);
+
+  close (g_process.m_notifier[0]);
+  close (g_process.m_notifier[1]);
+  g_process.m_pending_events.clear ();
+  g_process.m_reported_events.clear ();
+  g_process.m_attached = false;
+
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_process_get_info (amd_dbgapi_process_id_t process_id_,
+                             amd_dbgapi_process_info_t query,
+                             size_t value_size, void *value)
+{
+  api_call_t call;
+  CHECK_PROCESS (process_id_);
+
+  switch (query)
+    {
+    case AMD_DBGAPI_PROCESS_INFO_NOTIFIER:
+      return get_info (value_size, value,
+                       amd_dbgapi_notifier_t{ g_process.m_notifier[0] });
+
+    case AMD_DBGAPI_PROCESS_INFO_OS_ID:
+      return get_info (value_size, value,
+                       amd_dbgapi_os_process_id_t{ getpid () });
+
+    default:
+      return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+    }
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_set_memory_precision (amd_dbgapi_process_id_t process_id_,
+                                 amd_dbgapi_memory_precision_t precision)
+{
+  api_call_t call;
+  CHECK_PROCESS (process_id_);
+
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_report_breakpoint_hit (
+    amd_dbgapi_breakpoint_id_t breakpoint_id,
+    amd_dbgapi_client_thread_id_t client_thread_id,
+    amd_dbgapi_breakpoint_action_t *breakpoint_action)
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  if (!g_process.m_attached || !g_process.m_config.m_r_brk
+      || breakpoint_id.handle != r_brk_breakpoint_id.handle)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_BREAKPOINT_ID;
+
+  if (!breakpoint_action)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+
+  /* The simulated code object list does not change.  */
+  ++g_process.m_statistics.m_breakpoint_hits;
+  *breakpoint_action = AMD_DBGAPI_BREAKPOINT_ACTION_RESUME;
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+amd_dbgapi_status_t
+amd_dbgapi_disassemble_instruction (
+    amd_dbgapi_architecture_id_t architecture_id,
+    amd_dbgapi_global_address_t address, amd_dbgapi_size_t *size,
+    const void *memory, char **instruction_text,
+    amd_dbgapi_symbolizer_id_t symbolizer_id,
+    amd_dbgapi_status_t (*symbolizer) (
+        amd_dbgapi_symbolizer_id_t symbolizer_id,
+        amd_dbgapi_global_address_t address, char **symbol_text))
+{
+  api_call_t call;
+  CHECK_INITIALIZED ();
+
+  if (!find_architecture (architecture_id))
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARCHITECTURE_ID;
+
+  if (!size || !memory)
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
+
+  if (*size < 4)
+    return AMD_DBGAPI_STATUS_ERROR_ILLEGAL_INSTRUCTION;
+
+  uint32_t word;
+  std::memcpy (&word, memory, sizeof (word));
+  const auto opcode = static_cast<synthetic_opcode_t> (word >> 24);
+  const uint32_t operand = word & 0xffff;
+
+  if (*size < synthetic_instruction_size (opcode))
+    return AMD_DBGAPI_STATUS_ERROR_ILLEGAL_INSTRUCTION;
+  *size = synthetic_instruction_size (opcode);
+
+  ++g_process.m_statistics.m_instructions_disassembled;
+  if (!instruction_text)
+    return AMD_DBGAPI_STATUS_SUCCESS;
+
+  char text[128];
+  switch (opcode)
+    {
+    case synthetic_opcode_t::s_nop:
+      std::snprintf (text, sizeof (text), "s_nop 0");
+      break;
+
+    case synthetic_opcode_t::s_load:
+      std::snprintf (text, sizeof (text),
+                     "s_load_dwordx2 s[4:5], s[0:1], 0x%x", operand * 8);
+      break;
+
+    case synthetic_opcode_t::v_add:
+      std::snprintf (text, sizeof (text), "v_add_u32_e32 v%u, v%u, v%u",
+                     operand, operand + 1, operand + 2);
+      break;
+
+    case synthetic_opcode_t::global_load:
+      std::snprintf (text, sizeof (text),
+                     "global_load_dword v1, v[2:3], off offset:%u",
+                     operand * 4);
+      break;
+
+    case synthetic_opcode_t::s_branch:
+      {
+        const amd_dbgapi_global_address_t target
+            = address + 4 + static_cast<int16_t> (operand) * 4;
+
+        char *symbol_text = nullptr;
+        if (symbolizer
+            && symbolizer (symbolizer_id, target, &symbol_text)
+                   == AMD_DBGAPI_STATUS_SUCCESS)
+          {
+            std::snprintf (text, sizeof (text), "s_branch %s", symbol_text);
+            g_process.m_callbacks->deallocate_memory (symbol_text);
+          }
+        else
+          std::snprintf (text, sizeof (text), "s_branch 0x%lx", target);
+        break;
+      }
+
+    case synthetic_opcode_t::s_endpgm:
+      std::snprintf (text, sizeof (text), "s_endpgm");
+      break;
+
+    default:
+      std::snprintf (text, sizeof (text), ".long 0x%08x", word);
+      break;
+    }
+
+  return get_string_info (sizeof (char *), instruction_text, text);
+}
@@ -0,0 +1,112 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#ifndef _ROCM_DEBUG_AGENT_FAKE_DBGAPI_H
+#define _ROCM_DEBUG_AGENT_FAKE_DBGAPI_H 1
+
+#include <amd-dbgapi/amd-dbgapi.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/* Control of the fake libamd-dbgapi.
+
+   The fake library implements the subset of the dbgapi interface used by the
+   agent.  Instead of debugging the GPUs of the process, it simulates in host
+   memory a process whose wavefronts, architectures, registers, local memory,
+   code objects and events are configured with these functions.  The
+   wavefronts run until they are stopped by stop_waves or by the agent.  */
+
+namespace amd::debug_agent::fake_dbgapi
+{
+
+struct config_t
+{
+  /* The architectures are taken in order from gfx90a, gfx942, gfx1100 and
+     gfx1200.  The dispatches are assigned to them in turn.  */
+  size_t m_architecture_count{ 1 };
+  size_t m_sgpr_count{ 16 };
+  size_t m_vgpr_count{ 16 };
+  size_t m_lane_count{ 64 };
+
+  size_t m_code_object_count{ 4 };
+  size_t m_functions_per_code_object{ 64 };
+  size_t m_function_size{ 1024 };
+
+  size_t m_waves_per_workgroup{ 4 };
+  size_t m_waves_per_dispatch{ 1024 };
+  /* The size in bytes of the local memory of each workgroup.  */
+  size_t m_local_memory_size{ 4096 };
+
+  /* The address of the runtime's r_debug breakpoint, inserted with the
+     agent's insert_breakpoint callback when it attaches.  */
+  amd_dbgapi_global_address_t m_r_brk{ 0 };
+};
+
+struct statistics_t
+{
+  /* The number of calls to the dbgapi interface.  */
+  uint64_t m_calls{ 0 };
+  uint64_t m_register_bytes_read{ 0 };
+  uint64_t m_memory_bytes_read{ 0 };
+  uint64_t m_instructions_disassembled{ 0 };
+  /* The number of waves resumed with an exception delivered to the
+     runtime.  */
+  uint64_t m_exceptions_delivered{ 0 };
+  uint64_t m_breakpoint_hits{ 0 };
+};
+
+/* Set the configuration of the simulated process.  Must be called before the
+   agent attaches.  */
+void configure (const config_t &config);
+
+/* Replace the wavefronts of the process with WAVE_COUNT running
+   wavefronts.  */
+void create_waves (size_t wave_count);
+
+/* Stop WAVE_COUNT of the running wavefronts, spread over the wave list, with
+   STOP_REASON, and report their stop events to the agent.  */
+void stop_waves (size_t wave_count,
+                 amd_dbgapi_wave_stop_reasons_t stop_reason);
+
+/* Unload the INDEXth code object, and load it again at the same address
+   with a new code object id, as the runtime may do when an executable is
+   destroyed and another one is frozen.  */
+void reload_code_object (size_t index);
+
+/* Wait until the agent has attached, processed all the events, resumed all
+   the wavefronts, and restored the progress of the process.  */
+void wait_until_running ();
+
+statistics_t statistics ();
+
+} /* namespace amd::debug_agent::fake_dbgapi */
+
+#endif /* _ROCM_DEBUG_AGENT_FAKE_DBGAPI_H */
@@ -0,0 +1,300 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+/* Check the line table lookups, and that inserting the fragments of a line
+   table one at a time, as the line tables of the compilation units are
+   decoded on demand, builds the same table as merging them all and
+   finalizing the table.
+
+   Usage: line-table-test  */
+
+#include "line_table.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace amd::debug_agent;
+
+namespace
+{
+
+bool g_failed = false;
+
+void
+check (bool condition, const char *what)
+{
+  if (condition)
+    return;
+
+  std::cerr << "FAIL: " << what << std::endl;
+  g_failed = true;
+}
+
+/* Check the rows of two fragments with sequence ends, rows without a line
+   number, and rows of the same file and address.  */
+void
+check_rows ()
+{
+  line_table_t::fragment_t first;
+  first.add (0x1000, "a.cpp", 1);
+  first.add (0x1010, "a.cpp", 2);
+  first.add (0x1020, "b.h", 10);
+  /* A row without a line number.  */
+  first.add_end (0x1030);
+  first.add (0x1040, "a.cpp", 3);
+  /* The end of the sequence.  */
+  first.add_end (0x1050);
+
+  line_table_t::fragment_t second;
+  /* The fragments have rows for the same address.  */
+  second.add (0x1000, "b.h", 20);
+  second.add (0x2000, "b.h", 11);
+  second.add (0x2010, nullptr, 12);
+  second.add_end (0x2020);
+
+  line_table_t table;
+  table.merge (first);
+  table.merge (second);
+  table.finalize ();
+
+  check (table.size () == 6,
+         "the table has a row per address, and no row for the ends");
+
+  auto a = table.find_file ("a.cpp");
+  auto b = table.find_file ("b.h");
+  check (a.has_value () && b.has_value () && table.find_file (""),
+         "the file names of the fragments are interned");
+  check (!table.find_file ("c.cpp"), "no other file name is interned");
+  if (!a || !b)
+    return;
+
+  check (table.file_name (*a) == "a.cpp" && table.file_name (*b) == "b.h",
+         "the file indices refer to their names");
+
+  auto row = table.find (0x1000);
+  check (row && table.file (*row) == *a && table.line (*row) == 1,
+         "the first row merged for an address is kept");
+  row = table.find (0x1020);
+  check (row && table.file (*row) == *b && table.line (*row) == 10,
+         "a row is found by its address");
+  row = table.find (0x2000);
+  check (row && table.file (*row) == *b && table.line (*row) == 11,
+         "the file indices of the second fragment are remapped");
+
+  check (!table.find (0x1008), "no row is found inside another row");
+  check (!table.find (0x1030), "a row without a line number is no row");
+  check (!table.find (0x1050), "the end of a sequence is no row");
+
+  check (table.upper_bound (0xfff) == 0, "the upper bound of a low address");
+  check (table.upper_bound (0x1000) == 1, "the upper bound of a row");
+  check (table.upper_bound (0x1038) == 3,
+         "the upper bound after a row without a line number");
+  check (table.upper_bound (0x2020) == table.size (),
+         "the upper bound past the last row");
+}
+
+/* Check the address ranges of the lines, which end at the next row, or at
+   the end of their sequence.  */
+void
+check_line_index ()
+{
+  line_table_t::fragment_t fragment;
+  fragment.add (0x1000, "a.cpp", 1);
+  fragment.add (0x1010, "a.cpp", 2);
+  fragment.add (0x1020, "a.cpp", 1);
+  fragment.add (0x1030, "a.cpp", 1);
+  fragment.add (0x1040, "b.h", 1);
+  fragment.add_end (0x1048);
+  fragment.add (0x2000, "a.cpp", 2);
+  fragment.add (0x2010, "a.cpp", 3);
+  fragment.add (0x3000, "a.cpp", 5);
+  fragment.add_end (0x3008);
+  fragment.add (0x3100, "a.cpp", 6);
+  fragment.add_end (0x3110);
+  /* The last row, which is not followed by the end of its sequence.  */
+  fragment.add (0x4000, "a.cpp", 7);
+
+  line_table_t table;
+  table.merge (fragment);
+  table.finalize ();
+
+  auto a = table.find_file ("a.cpp");
+  auto b = table.find_file ("b.h");
+  check (a.has_value () && b.has_value (), "the files are found");
+  if (!a || !b)
+    return;
+
+  using ranges_t
+      = std::vector<std::pair<line_table_t::address_t,
+                              line_table_t::address_t>>;
+
+  check (table.address_ranges (*a, 1)
+             == ranges_t{ { 0x1000, 0x1010 }, { 0x1020, 0x1040 } },
+         "contiguous rows of a line are coalesced");
+  check (table.address_ranges (*a, 2)
+             == ranges_t{ { 0x1010, 0x1020 }, { 0x2000, 0x2010 } },
+         "the ranges of a line are sorted by address");
+  check (table.address_ranges (*b, 1) == ranges_t{ { 0x1040, 0x1048 } },
+         "a line of another file ends at the end of its sequence");
+  check (table.address_ranges (*a, 3) == ranges_t{ { 0x2010, 0x3000 } },
+         "a line ends at the next row");
+  check (table.address_ranges (*a, 5) == ranges_t{ { 0x3000, 0x3008 } },
+         "a line ends at the end of its sequence, before the next row");
+  check (table.address_ranges (*a, 7) == ranges_t{ { 0x4000, 0x4000 } },
+         "the last row without an end has an empty range");
+  check (table.address_ranges (*a, 4).empty (), "a line without code");
+
+  check (table.contains (*a, 1, 0x1000, 0x1010),
+         "a line has code in its range");
+  check (!table.contains (*a, 1, 0x1010, 0x1020),
+         "a line has no code in the range of another line");
+  check (table.contains (*a, 1, 0x1030, 0x1031),
+         "the start of a row is in a range");
+  check (!table.contains (*a, 1, 0x1031, 0x1040),
+         "only the start of a row is checked");
+  check (!table.contains (*b, 1, 0, 0x1040),
+         "a line has no code before its range");
+  check (!table.contains (*a, 4, 0, UINT64_MAX), "a line without code");
+}
+
+constexpr size_t file_count = 4;
+constexpr line_table_t::line_number_t line_count = 32;
+
+/* Return FRAGMENT_COUNT fragments of random rows.  Their addresses overlap,
+   so that some addresses have rows in more than one fragment.  */
+std::vector<line_table_t::fragment_t>
+random_fragments (std::mt19937_64 &rng, size_t fragment_count)
+{
+  std::uniform_int_distribution<line_table_t::address_t> address_dist (
+      0x1000, 0x1000 + 64 * fragment_count);
+  std::uniform_int_distribution<size_t> file_dist (0, file_count - 1);
+  std::uniform_int_distribution<line_table_t::line_number_t> line_dist (
+      1, line_count);
+  std::uniform_int_distribution<int> end_dist (0, 7);
+
+  std::vector<line_table_t::fragment_t> fragments (fragment_count);
+  for (auto &&fragment : fragments)
+    for (size_t i = 0; i < 32; ++i)
+      {
+        const line_table_t::address_t address = address_dist (rng) & ~3;
+        if (!end_dist (rng))
+          {
+            fragment.add_end (address);
+            continue;
+          }
+
+        const std::string file_name
+            = "file_" + std::to_string (file_dist (rng));
+        fragment.add (address, file_name.c_str (), line_dist (rng));
+      }
+
+  return fragments;
+}
+
+/* Check that TABLE and EXPECTED have the same rows, and answer the same
+   lookups.  */
+void
+check_same (const line_table_t &table, const line_table_t &expected)
+{
+  check (table.size () == expected.size (), "the tables have the same size");
+  if (table.size () != expected.size ())
+    return;
+
+  for (size_t row = 0; row < table.size (); ++row)
+    {
+      check (table.address (row) == expected.address (row),
+             "the rows have the same address");
+      check (table.file_name (table.file (row))
+                 == expected.file_name (expected.file (row)),
+             "the rows have the same file");
+      check (table.line (row) == expected.line (row),
+             "the rows have the same line");
+    }
+
+  for (size_t i = 0; i < file_count; ++i)
+    {
+      const std::string file_name = "file_" + std::to_string (i);
+      auto file = table.find_file (file_name);
+      auto expected_file = expected.find_file (file_name);
+      check (file.has_value () == expected_file.has_value (),
+             "the tables have the same files");
+      if (!file || !expected_file)
+        continue;
+
+      for (line_table_t::line_number_t line = 1; line <= line_count; ++line)
+        {
+          check (table.address_ranges (*file, line)
+                     == expected.address_ranges (*expected_file, line),
+                 "a line has the same address ranges");
+          check (table.contains (*file, line, 0x1000, 0x1100)
+                     == expected.contains (*expected_file, line, 0x1000,
+                                           0x1100),
+                 "a line has code in the same address range");
+        }
+    }
+}
+
+} /* namespace */
+
+int
+main ()
+{
+  check_rows ();
+  check_line_index ();
+
+  std::mt19937_64 rng (1);
+
+  for (size_t fragment_count : { 1, 2, 5, 40 })
+    {
+      auto fragments = random_fragments (rng, fragment_count);
+
+      line_table_t expected;
+      for (auto &&fragment : fragments)
+        expected.merge (fragment);
+      expected.finalize ();
+
+      line_table_t table;
+      for (auto &&fragment : fragments)
+        table.insert (fragment);
+
+      check_same (table, expected);
+    }
+
+  if (g_failed)
+    return EXIT_FAILURE;
+
+  std::cout << "PASS" << std::endl;
+  return EXIT_SUCCESS;
+}
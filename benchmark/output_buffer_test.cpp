@@ -0,0 +1,248 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+/* Check the asynchronous output buffer: flushing it while the background
+   thread is writing the other buffer to a slow reader, and appending lines
+   from another thread while characters are inserted in the stream.
+
+   Usage: output-buffer-test  */
+
+#include "output_buffer.h"
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <initializer_list>
+#include <iostream>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace amd::debug_agent;
+
+namespace
+{
+
+bool g_failed = false;
+
+void
+check (bool condition, const char *what)
+{
+  if (condition)
+    return;
+
+  std::cerr << "FAIL: " << what << std::endl;
+  g_failed = true;
+}
+
+/* Reads a pipe slowly, so that the background thread of the buffer writing
+   to it is often blocked in a write.  */
+class slow_reader_t
+{
+public:
+  explicit slow_reader_t (int fd) : m_fd (fd)
+  {
+    m_thread = std::thread ([this] () { read_all (); });
+  }
+
+  ~slow_reader_t ()
+  {
+    if (m_thread.joinable ())
+      m_thread.join ();
+  }
+
+  /* The number of characters written to the pipe so far: read, or still in
+     the pipe.  */
+  size_t written_count ()
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    int pending = 0;
+    if (ioctl (m_fd, FIONREAD, &pending) == -1)
+      pending = 0;
+    return m_data.size () + pending;
+  }
+
+  /* Wait until the write end of the pipe is closed, and return all the
+     characters read.  */
+  std::string data ()
+  {
+    if (m_thread.joinable ())
+      m_thread.join ();
+    return m_data;
+  }
+
+private:
+  void read_all ()
+  {
+    while (true)
+      {
+        char buffer[4096];
+        ssize_t count;
+        {
+          std::lock_guard<std::mutex> lock (m_mutex);
+          count = read (m_fd, buffer, sizeof (buffer));
+          if (count > 0)
+            m_data.append (buffer, count);
+        }
+
+        if (!count || (count == -1 && errno != EAGAIN && errno != EINTR))
+          return;
+
+        std::this_thread::sleep_for (std::chrono::milliseconds (1));
+      }
+  }
+
+  int const m_fd;
+  std::mutex m_mutex;
+  std::string m_data;
+  std::thread m_thread;
+};
+
+/* Check that the lines of DATA are PREFIX followed by their number, from 0
+   to LINE_COUNT, for each prefix of PREFIXES.  */
+void
+check_lines (const std::string &data,
+             std::initializer_list<const char *> prefixes, size_t line_count)
+{
+  std::vector<size_t> next (prefixes.size ());
+
+  std::istringstream lines (data);
+  for (std::string line; std::getline (lines, line);)
+    {
+      size_t prefix_index = 0;
+      for (const char *prefix : prefixes)
+        {
+          if (!line.compare (0, std::char_traits<char>::length (prefix),
+                             prefix))
+            break;
+          ++prefix_index;
+        }
+
+      if (prefix_index == prefixes.size ())
+        {
+          check (false, "each line is written whole");
+          return;
+        }
+
+      const char *prefix = prefixes.begin ()[prefix_index];
+      check (line.substr (std::char_traits<char>::length (prefix))
+                 == std::to_string (next[prefix_index]++),
+             "the lines of each thread are written in order");
+    }
+
+  for (size_t count : next)
+    check (count == line_count, "all the lines are written");
+}
+
+void
+check_flush_while_writing (size_t line_count)
+{
+  int fds[2];
+  if (pipe (fds) == -1 || fcntl (fds[0], F_SETFL, O_NONBLOCK) == -1)
+    {
+      check (false, "a pipe is created");
+      return;
+    }
+
+  slow_reader_t reader (fds[0]);
+
+  {
+    /* Small buffers, so that they are swapped often.  */
+    async_output_buffer_t buffer (fds[1], 512);
+    std::ostream out (&buffer);
+
+    std::atomic<bool> appending{ true };
+    std::thread appender ([&] () {
+      for (size_t i = 0; i < line_count; ++i)
+        {
+          std::string line = "append " + std::to_string (i) + "\n";
+          buffer.append (line.data (), line.size ());
+        }
+      appending = false;
+    });
+
+    bool flushed_while_appending = false;
+    for (size_t i = 0; i < line_count; ++i)
+      {
+        out << "insert " << i << '\n';
+
+        /* Flushing the stream does not wait for the writes.  */
+        if (i % 10 == 9)
+          out.flush ();
+
+        /* The background thread is likely blocked writing the back buffer
+           to the pipe, as the reader is slow.  */
+        if (i % 100 == 99)
+          {
+            /* The appending thread puts more characters meanwhile.  */
+            const size_t put_count = buffer.put_count ();
+            buffer.flush ();
+            check (reader.written_count () >= put_count,
+                   "flush waits until all the characters are written");
+            flushed_while_appending |= appending;
+          }
+      }
+
+    appender.join ();
+
+    buffer.flush ();
+    check (reader.written_count () == buffer.put_count (),
+           "flush waits until all the characters are written");
+
+    if (!flushed_while_appending)
+      std::cerr << "note: the appending thread finished early" << std::endl;
+  }
+
+  close (fds[1]);
+  check_lines (reader.data (), { "insert ", "append " }, line_count);
+  close (fds[0]);
+}
+
+} /* namespace */
+
+int
+main ()
+{
+  check_flush_while_writing (5000);
+
+  if (g_failed)
+    return EXIT_FAILURE;
+
+  std::cout << "PASS" << std::endl;
+  return EXIT_SUCCESS;
+}
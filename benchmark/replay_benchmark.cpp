@@ -0,0 +1,203 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+/* Replay a trace of the dbgapi calls made by the ROCdebug-agent, recorded
+   with the recording libamd-dbgapi, and measure the time the agent takes to
+   process it.  The agent is built from its sources into this program, and
+   linked with the replay libamd-dbgapi.
+
+   Usage: replay-benchmark [OPTION]... TRACE
+
+   To record a trace, run the application with the ROCdebug-agent and the
+   recording library preloaded:
+
+     ROCM_DEBUG_AGENT_DBGAPI_TRACE=report.trace \
+     LD_PRELOAD=libamd-dbgapi-record.so HSA_TOOLS_LIB=librocm-debug-agent.so \
+     APPLICATION
+
+   The agent is given the recorded ROCM_DEBUG_AGENT_OPTIONS, followed by
+   --output=/dev/null, unless ROCM_DEBUG_AGENT_OPTIONS is set.  The results
+   are printed as a JSON object.  */
+
+#include "dbgapi_replay.h"
+#include "json_writer.h"
+
+#include <hsa/hsa.h>
+#include <hsa/hsa_api_trace.h>
+
+#include <getopt.h>
+#include <link.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+/* Defined by the ROCm runtime, which the agent is not linked with here.  The
+   agent only uses it to recognize the runtime's breakpoint.  */
+r_debug _amdgpu_r_debug;
+
+extern "C" bool OnLoad (void *table, uint64_t runtime_version,
+                        uint64_t failed_tool_count,
+                        const char *const *failed_tool_names);
+extern "C" void OnUnload ();
+
+using namespace amd::debug_agent;
+
+namespace
+{
+
+using clock_type = std::chrono::steady_clock;
+
+hsa_status_t
+executable_freeze (hsa_executable_t executable, const char *options)
+{
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t
+executable_destroy (hsa_executable_t executable)
+{
+  return HSA_STATUS_SUCCESS;
+}
+
+void
+print_usage ()
+{
+  std::cerr << "usage: replay-benchmark [OPTION]... TRACE" << std::endl
+            << std::endl;
+  std::cerr << "  --timeout=SECONDS           "
+               "Maximum replay time (default 600)."
+            << std::endl;
+}
+
+} /* namespace */
+
+int
+main (int argc, char **argv)
+{
+  std::chrono::seconds timeout{ 600 };
+
+  enum : int
+  {
+    option_timeout = 256
+  };
+
+  static struct option long_options[]
+      = { { "timeout", required_argument, nullptr, option_timeout },
+          { "help", no_argument, nullptr, 'h' },
+          { 0 } };
+
+  while (int c = getopt_long (argc, argv, "h", long_options, nullptr))
+    {
+      if (c == -1)
+        break;
+
+      switch (c)
+        {
+        case option_timeout:
+          timeout = std::chrono::seconds (std::strtoul (optarg, nullptr, 0));
+          break;
+        case 'h':
+          print_usage ();
+          return EXIT_SUCCESS;
+        default:
+          print_usage ();
+          return EXIT_FAILURE;
+        }
+    }
+
+  if (optind + 1 != argc)
+    {
+      print_usage ();
+      return EXIT_FAILURE;
+    }
+
+  const std::string trace_path = argv[optind];
+  if (!dbgapi_replay::load (trace_path))
+    {
+      std::cerr << "error: could not read the trace " << trace_path
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  auto breakpoint_address = dbgapi_replay::breakpoint_address ();
+  if (!breakpoint_address)
+    {
+      std::cerr << "error: the trace has no runtime breakpoint" << std::endl;
+      return EXIT_FAILURE;
+    }
+  _amdgpu_r_debug.r_brk = *breakpoint_address;
+
+  const std::string agent_options
+      = dbgapi_replay::agent_options () + " --output=/dev/null";
+  setenv ("ROCM_DEBUG_AGENT_OPTIONS", agent_options.c_str (), 0);
+
+  CoreApiTable core_table{};
+  core_table.hsa_executable_freeze_fn = executable_freeze;
+  core_table.hsa_executable_destroy_fn = executable_destroy;
+  HsaApiTable table{};
+  table.core_ = &core_table;
+
+  auto start = clock_type::now ();
+
+  if (!OnLoad (&table, 0, 0, nullptr))
+    {
+      std::cerr << "error: the agent failed to load" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  const bool replayed = dbgapi_replay::wait_until_replayed (timeout);
+  const uint64_t elapsed_ns
+      = std::chrono::duration_cast<std::chrono::nanoseconds> (
+            clock_type::now () - start)
+            .count ();
+
+  OnUnload ();
+
+  if (!replayed)
+    std::cerr << "warning: the replay timed out" << std::endl;
+
+  dbgapi_replay::statistics_t statistics = dbgapi_replay::statistics ();
+
+  json_writer_t json (std::cout);
+  json.begin_object ();
+  json.key ("trace").value (trace_path);
+  json.key ("replayed").value (replayed);
+  json.key ("calls").value (statistics.m_calls);
+  json.key ("missing_calls").value (statistics.m_missing_calls);
+  json.key ("unused_records").value (statistics.m_unused_records);
+  json.key ("elapsed_ns").value (elapsed_ns);
+  json.end_object ();
+  std::cout << std::endl;
+
+  return replayed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,279 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+/* Measure the time the ROCdebug-agent takes to report wavefronts, without a
+   GPU.  The agent is built from its sources into this program, and linked
+   with the fake libamd-dbgapi, which simulates the process' wavefronts.
+
+   Usage: report-benchmark [OPTION]... [WAVE_COUNT...]
+
+   For each WAVE_COUNT (10000 and 100000 by default), the simulated process
+   is given that many wavefronts.  One of them is repeatedly stopped with a
+   memory violation, and the time until the agent has reported it and
+   resumed the process is measured.  The agent reads its options from
+   ROCM_DEBUG_AGENT_OPTIONS as usual, "--all --output=/dev/null" if it is not
+   set, so that all the wavefronts are stopped and reported.  */
+
+#include "fake_dbgapi.h"
+
+#include <hsa/hsa.h>
+#include <hsa/hsa_api_trace.h>
+
+#include <getopt.h>
+#include <link.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/* Defined by the ROCm runtime, which the agent is not linked with here.  The
+   agent only uses it to recognize the runtime's breakpoint.  */
+r_debug _amdgpu_r_debug;
+
+extern "C" bool OnLoad (void *table, uint64_t runtime_version,
+                        uint64_t failed_tool_count,
+                        const char *const *failed_tool_names);
+extern "C" void OnUnload ();
+
+using namespace amd::debug_agent;
+
+namespace
+{
+
+using clock_type = std::chrono::steady_clock;
+
+hsa_status_t
+executable_freeze (hsa_executable_t executable, const char *options)
+{
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t
+executable_destroy (hsa_executable_t executable)
+{
+  return HSA_STATUS_SUCCESS;
+}
+
+void
+print_usage ()
+{
+  std::cerr << "usage: report-benchmark [OPTION]... [WAVE_COUNT...]"
+            << std::endl
+            << std::endl;
+  std::cerr << "  --architectures=N           "
+               "Number of architectures (1 to 4, default 1)."
+            << std::endl;
+  std::cerr << "  --sgprs=N, --vgprs=N        "
+               "Number of scalar and vector registers (default 16)."
+            << std::endl;
+  std::cerr << "  --local-memory=BYTES        "
+               "Local memory size of each workgroup (default 4096)."
+            << std::endl;
+  std::cerr << "  --code-objects=N            "
+               "Number of code objects (default 4)."
+            << std::endl;
+  std::cerr << "  --reports=N                 "
+               "Number of reports per wave count (default 3)."
+            << std::endl;
+  std::cerr << "  --debug-traps               "
+               "Stop the wavefronts on debug traps instead, which"
+            << std::endl
+            << "                              "
+               "are resumed without a report."
+            << std::endl;
+}
+
+/* Parse ARG as a count of at least MIN into COUNT.  Return false if ARG is
+   not a number, or is out of range.  */
+bool
+parse_count (const char *arg, size_t &count, size_t min = 0)
+{
+  char *end;
+  errno = 0;
+  const unsigned long value = std::strtoul (arg, &end, 0);
+
+  if (end == arg || *end != '\0' || *arg == '-' || errno == ERANGE
+      || value < min)
+    {
+      std::cerr << "error: invalid count `" << arg << "'";
+      if (min)
+        std::cerr << ", expected a number of at least " << min;
+      std::cerr << std::endl;
+      return false;
+    }
+
+  count = value;
+  return true;
+}
+
+} /* namespace */
+
+int
+main (int argc, char **argv)
+{
+  fake_dbgapi::config_t config;
+  size_t report_count = 3;
+  amd_dbgapi_wave_stop_reasons_t stop_reason
+      = AMD_DBGAPI_WAVE_STOP_REASON_MEMORY_VIOLATION;
+
+  enum : int
+  {
+    option_architectures = 256,
+    option_sgprs,
+    option_vgprs,
+    option_local_memory,
+    option_code_objects,
+    option_reports,
+    option_debug_traps
+  };
+
+  static struct option long_options[]
+      = { { "architectures", required_argument, nullptr,
+            option_architectures },
+          { "sgprs", required_argument, nullptr, option_sgprs },
+          { "vgprs", required_argument, nullptr, option_vgprs },
+          { "local-memory", required_argument, nullptr, option_local_memory },
+          { "code-objects", required_argument, nullptr, option_code_objects },
+          { "reports", required_argument, nullptr, option_reports },
+          { "debug-traps", no_argument, nullptr, option_debug_traps },
+          { "help", no_argument, nullptr, 'h' },
+          { 0 } };
+
+  while (int c = getopt_long (argc, argv, "h", long_options, nullptr))
+    {
+      if (c == -1)
+        break;
+
+      switch (c)
+        {
+        case option_architectures:
+          if (!parse_count (optarg, config.m_architecture_count))
+            return EXIT_FAILURE;
+          break;
+        case option_sgprs:
+          if (!parse_count (optarg, config.m_sgpr_count))
+            return EXIT_FAILURE;
+          break;
+        case option_vgprs:
+          if (!parse_count (optarg, config.m_vgpr_count))
+            return EXIT_FAILURE;
+          break;
+        case option_local_memory:
+          if (!parse_count (optarg, config.m_local_memory_size))
+            return EXIT_FAILURE;
+          break;
+        case option_code_objects:
+          if (!parse_count (optarg, config.m_code_object_count))
+            return EXIT_FAILURE;
+          break;
+        case option_reports:
+          if (!parse_count (optarg, report_count, 1))
+            return EXIT_FAILURE;
+          break;
+        case option_debug_traps:
+          stop_reason = AMD_DBGAPI_WAVE_STOP_REASON_DEBUG_TRAP;
+          break;
+        case 'h':
+          print_usage ();
+          return EXIT_SUCCESS;
+        default:
+          print_usage ();
+          return EXIT_FAILURE;
+        }
+    }
+
+  std::vector<size_t> wave_counts;
+  for (int i = optind; i < argc; ++i)
+    if (!parse_count (argv[i], wave_counts.emplace_back (), 1))
+      return EXIT_FAILURE;
+
+  if (wave_counts.empty ())
+    wave_counts = { 10000, 100000 };
+
+  /* Any address will do, as long as the agent and the fake library agree on
+     it.  */
+  _amdgpu_r_debug.r_brk = reinterpret_cast<ElfW (Addr)> (&executable_freeze);
+  config.m_r_brk = _amdgpu_r_debug.r_brk;
+  fake_dbgapi::configure (config);
+
+  setenv ("ROCM_DEBUG_AGENT_OPTIONS", "--all --output=/dev/null", 0);
+
+  CoreApiTable core_table{};
+  core_table.hsa_executable_freeze_fn = executable_freeze;
+  core_table.hsa_executable_destroy_fn = executable_destroy;
+  HsaApiTable table{};
+  table.core_ = &core_table;
+
+  if (!OnLoad (&table, 0, 0, nullptr))
+    {
+      std::cerr << "error: the agent failed to load" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  /* Wait for the agent to attach, and to process the initial events.  */
+  fake_dbgapi::wait_until_running ();
+
+  std::cout << std::right << std::setw (10) << "waves" << std::setw (14)
+            << "ms/report" << std::setw (14) << "waves/s" << std::setw (16)
+            << "calls/report" << std::endl;
+
+  for (auto wave_count : wave_counts)
+    {
+      fake_dbgapi::create_waves (wave_count);
+      const uint64_t calls = fake_dbgapi::statistics ().m_calls;
+
+      auto start = clock_type::now ();
+      for (size_t i = 0; i < report_count; ++i)
+        {
+          fake_dbgapi::stop_waves (1, stop_reason);
+          fake_dbgapi::wait_until_running ();
+        }
+      const double report_ns
+          = std::chrono::duration<double, std::nano> (clock_type::now ()
+                                                      - start)
+                .count ()
+            / report_count;
+
+      std::cout << std::setw (10) << wave_count << std::fixed
+                << std::setprecision (2) << std::setw (14) << report_ns / 1e6
+                << std::setprecision (0) << std::setw (14)
+                << wave_count / report_ns * 1e9 << std::setw (16)
+                << (fake_dbgapi::statistics ().m_calls - calls) / report_count
+                << std::endl;
+    }
+
+  OnUnload ();
+  return EXIT_SUCCESS;
+}
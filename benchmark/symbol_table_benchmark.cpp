@@ -0,0 +1,209 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+/* Compare the lookup performance of symbol_table_t with the std::map based
+   symbol map it replaced.
+
+   Usage: symbol-table-benchmark [SYMBOL_COUNT...]
+
+   For each SYMBOL_COUNT (100000 and 1000000 by default), a table of
+   synthetic function symbols with mangled-looking names is built, and random
+   addresses, most of them inside a function, are looked up.  */
+
+#include "symbol_table.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace amd::debug_agent;
+
+namespace
+{
+
+using address_t = symbol_table_t::address_t;
+using clock_type = std::chrono::steady_clock;
+
+struct synthetic_symbol_t
+{
+  address_t address;
+  address_t size;
+  std::string name;
+};
+
+std::vector<synthetic_symbol_t>
+generate_symbols (size_t count, std::mt19937_64 &rng)
+{
+  std::uniform_int_distribution<address_t> size_dist (16, 4096);
+  std::vector<synthetic_symbol_t> symbols;
+  symbols.reserve (count);
+
+  address_t address = 0x7f0000000000;
+  for (size_t i = 0; i < count; ++i)
+    {
+      address_t size = size_dist (rng) & ~address_t{ 3 };
+      std::string name = "_Z" + std::to_string (i + 17) + "synthetic_kernel_"
+                         + std::to_string (i) + "PiS_S_";
+
+      symbols.push_back ({ address, size, std::move (name) });
+      /* Leave a gap between some functions so that some lookups miss.  */
+      address += size + ((i % 8) ? 0 : 256);
+    }
+
+  /* Symbols are not sorted in an ELF symbol table.  */
+  std::shuffle (symbols.begin (), symbols.end (), rng);
+  return symbols;
+}
+
+template <typename Function>
+double
+time_ns (Function &&function)
+{
+  auto start = clock_type::now ();
+  function ();
+  return std::chrono::duration<double, std::nano> (clock_type::now () - start)
+      .count ();
+}
+
+void
+run (size_t symbol_count, size_t lookup_count)
+{
+  std::mt19937_64 rng (symbol_count);
+  auto symbols = generate_symbols (symbol_count, rng);
+
+  /* Build a string table, like the one found in the ELF .strtab section.  */
+  std::string strtab (1, '\0');
+  std::vector<size_t> name_offsets;
+  name_offsets.reserve (symbols.size ());
+  for (auto &&symbol : symbols)
+    {
+      name_offsets.push_back (strtab.size ());
+      strtab.append (symbol.name).push_back ('\0');
+    }
+
+  address_t low = symbols.front ().address, high = low;
+  for (auto &&symbol : symbols)
+    {
+      low = std::min (low, symbol.address);
+      high = std::max (high, symbol.address + symbol.size);
+    }
+
+  std::uniform_int_distribution<address_t> address_dist (low, high);
+  std::vector<address_t> lookups (lookup_count);
+  for (auto &&lookup : lookups)
+    lookup = address_dist (rng);
+
+  /* The std::map based symbol map.  */
+  std::map<address_t, std::pair<std::string, address_t>> symbol_map;
+  double map_build_ns = time_ns ([&] () {
+    for (size_t i = 0; i < symbols.size (); ++i)
+      symbol_map.emplace (
+          symbols[i].address,
+          std::make_pair (std::string (&strtab[name_offsets[i]]),
+                          symbols[i].size));
+  });
+
+  size_t map_hits = 0;
+  double map_lookup_ns = time_ns ([&] () {
+    for (auto address : lookups)
+      if (auto it = symbol_map.upper_bound (address);
+          it != symbol_map.begin ())
+        if (auto &&[value, symbol] = *std::prev (it);
+            address < (value + symbol.second))
+          map_hits += symbol.first.size () != 0;
+  });
+
+  /* The flat symbol table.  */
+  symbol_table_t symbol_table;
+  double table_build_ns = time_ns ([&] () {
+    size_t base
+        = symbol_table.add_string_table (strtab.data (), strtab.size ());
+    for (size_t i = 0; i < symbols.size (); ++i)
+      symbol_table.add (symbols[i].address, symbols[i].size,
+                        base + name_offsets[i]);
+    symbol_table.finalize ();
+  });
+
+  size_t table_hits = 0;
+  double table_lookup_ns = time_ns ([&] () {
+    for (auto address : lookups)
+      if (auto index = symbol_table.find (address))
+        table_hits += *symbol_table.name (*index) != '\0';
+  });
+
+  if (map_hits != table_hits)
+    {
+      std::cerr << "error: lookup results differ (" << map_hits
+                << " != " << table_hits << ")" << std::endl;
+      std::exit (EXIT_FAILURE);
+    }
+
+  auto print = [&] (const char *name, double build_ns, double lookup_ns) {
+    std::cout << std::left << std::setw (14) << name << std::right
+              << std::setw (10) << symbol_count << std::fixed
+              << std::setprecision (2) << std::setw (14) << build_ns / 1e6
+              << std::setw (14) << lookup_ns / lookup_count << std::setw (14)
+              << lookup_count / (lookup_ns / 1e9) / 1e6 << std::endl;
+  };
+
+  print ("std::map", map_build_ns, map_lookup_ns);
+  print ("symbol_table", table_build_ns, table_lookup_ns);
+}
+
+} /* namespace */
+
+int
+main (int argc, char **argv)
+{
+  std::vector<size_t> symbol_counts;
+  for (int i = 1; i < argc; ++i)
+    symbol_counts.push_back (std::strtoul (argv[i], nullptr, 0));
+
+  if (symbol_counts.empty ())
+    symbol_counts = { 100000, 1000000 };
+
+  std::cout << std::left << std::setw (14) << "table" << std::right
+            << std::setw (10) << "symbols" << std::setw (14) << "build (ms)"
+            << std::setw (14) << "ns/lookup" << std::setw (14)
+            << "Mlookups/s" << std::endl;
+
+  for (auto symbol_count : symbol_counts)
+    run (symbol_count, 4 * 1000 * 1000);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,166 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+/* Check the symbol table lookups at the first and last addresses of the
+   symbols, and just past their end.
+
+   Usage: symbol-table-test  */
+
+#include "symbol_table.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <string_view>
+
+using namespace amd::debug_agent;
+
+namespace
+{
+
+bool g_failed = false;
+
+void
+check (bool condition, const char *what)
+{
+  if (condition)
+    return;
+
+  std::cerr << "FAIL: " << what << std::endl;
+  g_failed = true;
+}
+
+/* Check that the symbol containing ADDRESS in TABLE is named NAME, or that
+   there is none if NAME is null.  */
+void
+check_find (const symbol_table_t &table, symbol_table_t::address_t address,
+            const char *name, const char *what)
+{
+  std::optional<size_t> index = table.find (address);
+  if (!name)
+    check (!index.has_value (), what);
+  else
+    check (index.has_value () && !strcmp (table.name (*index), name), what);
+}
+
+/* Symbols of various layouts: adjacent, followed by a gap, empty, sharing
+   their address, and ending at the end of the address space.  */
+void
+check_symbol_ends ()
+{
+  static const char strings[]
+      = "\0adjacent\0after_adjacent\0before_gap\0empty\0small\0large\0last";
+
+  symbol_table_t table;
+  size_t offset = table.add_string_table (strings, sizeof (strings));
+  auto name_offset = [&] (const char *name) {
+    return offset + (std::string_view (strings, sizeof (strings)).find (name));
+  };
+
+  table.add (0x1000, 0x100, name_offset ("adjacent"));
+  table.add (0x1100, 0x80, name_offset ("after_adjacent"));
+  table.add (0x1200, 0x10, name_offset ("before_gap"));
+  table.add (0x1300, 0, name_offset ("empty"));
+  table.add (0x1400, 0x10, name_offset ("small"));
+  table.add (0x1400, 0x40, name_offset ("large"));
+  table.add (UINT64_MAX - 0xf, 0x10, name_offset ("last"));
+  table.finalize ();
+
+  check_find (table, 0xfff, nullptr, "no symbol before the first one");
+  check_find (table, 0x1000, "adjacent", "a symbol's first address");
+  check_find (table, 0x10ff, "adjacent", "a symbol's last address");
+  check_find (table, 0x1100, "after_adjacent",
+              "the end of a symbol followed by another one");
+  check_find (table, 0x117f, "after_adjacent", "a symbol's last address");
+  check_find (table, 0x1180, nullptr, "the end of a symbol before a gap");
+  check_find (table, 0x11ff, nullptr, "the end of a gap");
+  check_find (table, 0x120f, "before_gap", "a symbol's last address");
+  check_find (table, 0x1210, nullptr, "the end of a symbol before a gap");
+  check_find (table, 0x1300, nullptr, "an empty symbol");
+  check_find (table, 0x1400, "large",
+              "the largest symbol sharing an address");
+  check_find (table, 0x143f, "large",
+              "the last address of the largest symbol sharing an address");
+  check_find (table, 0x1440, nullptr, "the end of a symbol before a gap");
+  check_find (table, UINT64_MAX - 0xf, "last",
+              "the first address of the last symbol");
+  check_find (table, UINT64_MAX, "last",
+              "a symbol ending at the end of the address space");
+}
+
+/* The lookup runs a number of iterations that depends on the table size.
+   Check the ends of each symbol in tables of adjacent symbols of each size
+   up to SYMBOL_COUNT.  */
+void
+check_table_sizes (size_t symbol_count)
+{
+  static const char strings[] = "\0symbol";
+
+  for (size_t size = 1; size <= symbol_count; ++size)
+    {
+      symbol_table_t table;
+      size_t offset = table.add_string_table (strings, sizeof (strings));
+
+      /* Add the symbols in reverse order, as finalize sorts them.  */
+      for (size_t i = size; i-- > 0;)
+        table.add (0x1000 + i * 0x10, 0x10, offset + 1);
+      table.finalize ();
+
+      check (table.size () == size, "all the symbols are in the table");
+      check (!table.find (0xfff), "no symbol before the first one");
+
+      for (size_t i = 0; i < size; ++i)
+        {
+          const symbol_table_t::address_t start = 0x1000 + i * 0x10;
+          check (table.find (start) == i, "a symbol's first address");
+          check (table.find (start + 0xf) == i, "a symbol's last address");
+        }
+
+      check (!table.find (0x1000 + size * 0x10),
+             "no symbol after the last one");
+    }
+}
+
+} /* namespace */
+
+int
+main ()
+{
+  check_symbol_ends ();
+  check_table_sizes (33);
+
+  if (g_failed)
+    return EXIT_FAILURE;
+
+  std::cout << "PASS" << std::endl;
+  return EXIT_SUCCESS;
+}
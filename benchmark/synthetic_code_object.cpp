@@ -0,0 +1,492 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#include "synthetic_code_object.h"
+
+#include <elf.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace amd::debug_agent
+{
+
+namespace
+{
+
+/* Not defined by all the versions of elf.h.  */
+constexpr uint8_t elfosabi_amdgpu_hsa = 64;
+constexpr uint8_t elfabiversion_amdgpu_hsa_v5 = 3;
+constexpr uint16_t em_amdgpu = 224;
+
+size_t
+align_up (size_t value, size_t alignment)
+{
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+template <typename T>
+void
+write (std::vector<char> &image, size_t offset, const T &value)
+{
+  std::memcpy (&image[offset], &value, sizeof (value));
+}
+
+void
+write_instruction (std::vector<char> &image, size_t &offset,
+                   synthetic_opcode_t opcode, uint32_t operand = 0)
+{
+  write<uint32_t> (image, offset,
+                   (static_cast<uint32_t> (opcode) << 24) | operand);
+  if (synthetic_instruction_size (opcode) == 8)
+    write<uint32_t> (image, offset + 4, operand);
+  offset += synthetic_instruction_size (opcode);
+}
+
+/* Write the instructions of a function of SIZE bytes at OFFSET.  */
+void
+write_function (std::vector<char> &image, size_t offset, size_t size)
+{
+  const size_t start = offset;
+  const size_t block_count = size / synthetic_block_size;
+
+  for (size_t block = 0; block < block_count; ++block)
+    {
+      const size_t block_start = offset;
+
+      if (block == block_count - 1)
+        write_instruction (image, offset, synthetic_opcode_t::s_endpgm);
+      else
+        switch (block % 4)
+          {
+          case 0:
+            write_instruction (image, offset, synthetic_opcode_t::global_load,
+                               block);
+            write_instruction (image, offset, synthetic_opcode_t::v_add, 1);
+            break;
+
+          case 1:
+            write_instruction (image, offset, synthetic_opcode_t::s_load,
+                               block);
+            write_instruction (image, offset, synthetic_opcode_t::v_add, 2);
+            break;
+
+          case 2:
+            {
+              /* Branch back to the start of the function, or of this block
+                 if the start of the function is out of range.  */
+              int64_t words = (static_cast<int64_t> (start)
+                               - static_cast<int64_t> (offset + 4))
+                              / 4;
+              if (words < INT16_MIN)
+                words = (static_cast<int64_t> (block_start)
+                         - static_cast<int64_t> (offset + 4))
+                        / 4;
+              write_instruction (image, offset, synthetic_opcode_t::s_branch,
+                                 static_cast<uint16_t> (words));
+              break;
+            }
+
+          default:
+            write_instruction (image, offset, synthetic_opcode_t::v_add, 3);
+            break;
+          }
+
+      while (offset < block_start + synthetic_block_size)
+        write_instruction (image, offset, synthetic_opcode_t::s_nop);
+    }
+}
+
+void
+append_uleb128 (std::string &out, uint64_t value)
+{
+  do
+    {
+      uint8_t byte = value & 0x7f;
+      value >>= 7;
+      out.push_back (value ? byte | 0x80 : byte);
+    }
+  while (value);
+}
+
+void
+append_sleb128 (std::string &out, int64_t value)
+{
+  while (true)
+    {
+      uint8_t byte = value & 0x7f;
+      value >>= 7;
+      if ((value == 0 && !(byte & 0x40)) || (value == -1 && (byte & 0x40)))
+        {
+          out.push_back (byte);
+          return;
+        }
+      out.push_back (byte | 0x80);
+    }
+}
+
+template <typename T>
+void
+append (std::string &out, const T &value)
+{
+  out.append (reinterpret_cast<const char *> (&value), sizeof (value));
+}
+
+template <typename T>
+void
+patch (std::string &out, size_t offset, const T &value)
+{
+  std::memcpy (&out[offset], &value, sizeof (value));
+}
+
+/* The DWARF constants used by the generator, defined here so that it does
+   not depend on libdw's <dwarf.h>.  */
+constexpr uint8_t dw_tag_compile_unit = 0x11;
+constexpr uint8_t dw_at_name = 0x03;
+constexpr uint8_t dw_at_stmt_list = 0x10;
+constexpr uint8_t dw_at_low_pc = 0x11;
+constexpr uint8_t dw_at_high_pc = 0x12;
+constexpr uint8_t dw_at_comp_dir = 0x1b;
+constexpr uint8_t dw_form_addr = 0x01;
+constexpr uint8_t dw_form_data8 = 0x07;
+constexpr uint8_t dw_form_string = 0x08;
+constexpr uint8_t dw_form_sec_offset = 0x17;
+constexpr uint8_t dw_lns_copy = 0x01;
+constexpr uint8_t dw_lns_advance_pc = 0x02;
+constexpr uint8_t dw_lns_advance_line = 0x03;
+constexpr uint8_t dw_lne_end_sequence = 0x01;
+constexpr uint8_t dw_lne_set_address = 0x02;
+
+struct section_t
+{
+  const char *m_name;
+  Elf64_Word m_type;
+  Elf64_Xword m_flags;
+  std::string m_contents;
+  Elf64_Xword m_addralign;
+  Elf64_Xword m_entsize{ 0 };
+  Elf64_Word m_link{ 0 };
+  Elf64_Word m_info{ 0 };
+};
+
+/* Return the .debug_abbrev contents, with the single abbreviation used by
+   the compilation units.  */
+std::string
+make_debug_abbrev ()
+{
+  std::string abbrev;
+  append_uleb128 (abbrev, 1);
+  append_uleb128 (abbrev, dw_tag_compile_unit);
+  abbrev.push_back (0 /* DW_CHILDREN_no */);
+  for (auto [attribute, form] :
+       { std::pair{ dw_at_name, dw_form_string },
+         std::pair{ dw_at_comp_dir, dw_form_string },
+         std::pair{ dw_at_stmt_list, dw_form_sec_offset },
+         std::pair{ dw_at_low_pc, dw_form_addr },
+         std::pair{ dw_at_high_pc, dw_form_data8 } })
+    {
+      append_uleb128 (abbrev, attribute);
+      append_uleb128 (abbrev, form);
+    }
+  abbrev.append (3, '\0');
+  return abbrev;
+}
+
+/* Append to INFO and LINE the compilation unit FILE_NAME covering the
+   functions [FIRST, LAST) of FUNCTIONS, and record the functions' rows.  */
+void
+append_compilation_unit (std::string &info, std::string &line,
+                         const std::string &file_name,
+                         std::vector<synthetic_function_t> &functions,
+                         size_t first, size_t last, size_t row_count)
+{
+  const uint64_t low_pc = functions[first].m_address;
+  const uint64_t high_pc
+      = functions[last - 1].m_address + functions[last - 1].m_size;
+
+  /* The compilation unit's header and DIE.  */
+  const size_t info_start = info.size ();
+  append<uint32_t> (info, 0);
+  append<uint16_t> (info, 4);
+  append<uint32_t> (info, 0);
+  info.push_back (sizeof (uint64_t));
+  append_uleb128 (info, 1);
+  info.append (file_name).push_back ('\0');
+  info.append (synthetic_compilation_directory).push_back ('\0');
+  append<uint32_t> (info, line.size ());
+  append<uint64_t> (info, low_pc);
+  append<uint64_t> (info, high_pc - low_pc);
+  patch<uint32_t> (info, info_start, info.size () - info_start - 4);
+
+  /* The line program's header.  */
+  const size_t line_start = line.size ();
+  append<uint32_t> (line, 0);
+  append<uint16_t> (line, 4);
+  const size_t header_length_offset = line.size ();
+  append<uint32_t> (line, 0);
+  line.push_back (1);  /* minimum_instruction_length  */
+  line.push_back (1);  /* maximum_operations_per_instruction  */
+  line.push_back (1);  /* default_is_stmt  */
+  line.push_back (-5); /* line_base  */
+  line.push_back (14); /* line_range  */
+  line.push_back (13); /* opcode_base  */
+  for (uint8_t length : { 0, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1 })
+    line.push_back (length);
+  line.push_back ('\0'); /* No include_directories.  */
+  line.append (file_name).push_back ('\0');
+  line.append (3, '\0'); /* Directory, time and length.  */
+  line.push_back ('\0');
+  patch<uint32_t> (line, header_length_offset,
+                   line.size () - header_length_offset - 4);
+
+  /* The line program.  Each function starts a few lines after the end of
+     the previous one, and its rows start evenly spaced blocks.  */
+  line.push_back (0);
+  append_uleb128 (line, 1 + sizeof (uint64_t));
+  line.push_back (dw_lne_set_address);
+  append<uint64_t> (line, low_pc);
+
+  uint64_t address = low_pc;
+  int64_t line_number = 1;
+  for (size_t i = first; i < last; ++i)
+    {
+      const size_t block_count = functions[i].m_size / synthetic_block_size;
+      const size_t rows = std::clamp<size_t> (row_count, 1, block_count);
+      functions[i].m_first_line = 1 + (i - first) * (row_count + 4);
+
+      for (size_t row = 0; row < rows; ++row)
+        {
+          const uint64_t row_address
+              = functions[i].m_address
+                + row * block_count / rows * synthetic_block_size;
+          const int64_t row_line = 1 + (i - first) * (row_count + 4) + row;
+
+          if (row_address != address)
+            {
+              line.push_back (dw_lns_advance_pc);
+              append_uleb128 (line, row_address - address);
+            }
+          if (row_line != line_number)
+            {
+              line.push_back (dw_lns_advance_line);
+              append_sleb128 (line, row_line - line_number);
+            }
+          line.push_back (dw_lns_copy);
+          functions[i].m_row_addresses.push_back (row_address);
+
+          address = row_address;
+          line_number = row_line;
+        }
+    }
+
+  line.push_back (dw_lns_advance_pc);
+  append_uleb128 (line, high_pc - address);
+  line.push_back (0);
+  append_uleb128 (line, 1);
+  line.push_back (dw_lne_end_sequence);
+
+  patch<uint32_t> (line, line_start, line.size () - line_start - 4);
+}
+
+} /* namespace */
+
+synthetic_code_object_t
+make_synthetic_code_object (const synthetic_code_object_options_t &options)
+{
+  synthetic_code_object_t code_object;
+
+  const size_t function_size = std::max (
+      align_up (options.m_function_size, synthetic_block_size),
+      synthetic_block_size);
+
+  const size_t cu_count
+      = std::min (options.m_compilation_unit_count, options.m_function_count);
+  const size_t cu_gap
+      = align_up (options.m_compilation_unit_gap, synthetic_block_size);
+
+  /* The functions [first, last) of compilation unit CU.  */
+  auto cu_functions = [&] (size_t cu) {
+    return std::make_pair (cu * options.m_function_count / cu_count,
+                           (cu + 1) * options.m_function_count / cu_count);
+  };
+
+  /* The offset of each function, after the gaps before its compilation
+     unit.  */
+  std::vector<size_t> function_offsets (options.m_function_count);
+  for (size_t i = 0; i < options.m_function_count; ++i)
+    function_offsets[i] = i * function_size;
+  for (size_t cu = 1; cu < cu_count; ++cu)
+    {
+      const auto [first, last] = cu_functions (cu);
+      for (size_t i = first; i < last; ++i)
+        function_offsets[i] += cu * cu_gap;
+    }
+
+  /* The text starts after the ELF and program headers.  */
+  const size_t text_offset = 0x100;
+  const size_t text_size = options.m_function_count * function_size
+                           + (cu_count ? cu_count - 1 : 0) * cu_gap;
+
+  std::string strtab (1, '\0');
+  std::string symtab (sizeof (Elf64_Sym), '\0');
+  for (size_t i = 0; i < options.m_function_count; ++i)
+    {
+      /* Mangled names of "synthetic_kernel_N(int*, int*, int*)".  */
+      std::string name = "synthetic_kernel_" + std::to_string (i);
+      name = "_Z" + std::to_string (name.size ()) + name + "PiS_S_";
+
+      Elf64_Sym sym{};
+      sym.st_name = strtab.size ();
+      sym.st_info = ELF64_ST_INFO (STB_GLOBAL, STT_FUNC);
+      sym.st_shndx = 1;
+      sym.st_value = text_offset + function_offsets[i];
+      sym.st_size = function_size;
+      append (symtab, sym);
+
+      strtab.append (name).push_back ('\0');
+      code_object.m_functions.push_back (
+          { std::move (name), sym.st_value, sym.st_size, {} });
+    }
+
+  /* Sections are numbered from 1 in the order of this list, the section
+     header string table last.  */
+  std::vector<section_t> sections;
+  sections.push_back ({ ".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR,
+                        std::string (text_size, '\0'), synthetic_block_size });
+  sections.push_back ({ ".symtab", SHT_SYMTAB, 0, std::move (symtab), 8,
+                        sizeof (Elf64_Sym), 3, 1 });
+  sections.push_back ({ ".strtab", SHT_STRTAB, 0, std::move (strtab), 1 });
+
+  if (cu_count)
+    {
+      std::string info, line;
+      for (size_t cu = 0; cu < cu_count; ++cu)
+        {
+          const auto [first, last] = cu_functions (cu);
+          const std::string file_name
+              = "synthetic_" + std::to_string (cu) + ".cpp";
+
+          append_compilation_unit (info, line, file_name,
+                                   code_object.m_functions, first, last,
+                                   options.m_line_rows_per_function);
+          for (size_t i = first; i < last; ++i)
+            code_object.m_functions[i].m_file_name = file_name;
+        }
+
+      sections.push_back (
+          { ".debug_abbrev", SHT_PROGBITS, 0, make_debug_abbrev (), 1 });
+      sections.push_back ({ ".debug_info", SHT_PROGBITS, 0, std::move (info),
+                            1 });
+      sections.push_back ({ ".debug_line", SHT_PROGBITS, 0, std::move (line),
+                            1 });
+    }
+
+  std::string shstrtab (1, '\0');
+  std::vector<size_t> section_names;
+  sections.push_back ({ ".shstrtab", SHT_STRTAB, 0, {}, 1 });
+  for (auto &&section : sections)
+    {
+      section_names.emplace_back (shstrtab.size ());
+      shstrtab.append (section.m_name).push_back ('\0');
+    }
+  sections.back ().m_contents = std::move (shstrtab);
+
+  /* The layout of the image.  */
+  std::vector<size_t> section_offsets;
+  size_t offset = text_offset;
+  for (auto &&section : sections)
+    {
+      offset = align_up (offset, section.m_addralign);
+      section_offsets.emplace_back (offset);
+      offset += section.m_contents.size ();
+    }
+  const size_t shdr_offset = align_up (offset, 8);
+  const size_t shdr_count = sections.size () + 1;
+
+  std::vector<char> &image = code_object.m_image;
+  image.resize (shdr_offset + shdr_count * sizeof (Elf64_Shdr));
+
+  Elf64_Ehdr ehdr{};
+  std::memcpy (ehdr.e_ident, ELFMAG, SELFMAG);
+  ehdr.e_ident[EI_CLASS] = ELFCLASS64;
+  ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+  ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+  ehdr.e_ident[EI_OSABI] = elfosabi_amdgpu_hsa;
+  ehdr.e_ident[EI_ABIVERSION] = elfabiversion_amdgpu_hsa_v5;
+  ehdr.e_type = ET_DYN;
+  ehdr.e_machine = em_amdgpu;
+  ehdr.e_version = EV_CURRENT;
+  ehdr.e_phoff = sizeof (Elf64_Ehdr);
+  ehdr.e_shoff = shdr_offset;
+  ehdr.e_flags = options.m_elf_amdgpu_machine;
+  ehdr.e_ehsize = sizeof (Elf64_Ehdr);
+  ehdr.e_phentsize = sizeof (Elf64_Phdr);
+  ehdr.e_phnum = 1;
+  ehdr.e_shentsize = sizeof (Elf64_Shdr);
+  ehdr.e_shnum = shdr_count;
+  ehdr.e_shstrndx = shdr_count - 1;
+  write (image, 0, ehdr);
+
+  Elf64_Phdr phdr{};
+  phdr.p_type = PT_LOAD;
+  phdr.p_flags = PF_R | PF_X;
+  phdr.p_filesz = phdr.p_memsz = text_offset + text_size;
+  phdr.p_align = 0x1000;
+  write (image, ehdr.e_phoff, phdr);
+
+  for (size_t i = 0; i < sections.size (); ++i)
+    {
+      const section_t &section = sections[i];
+      std::memcpy (&image[section_offsets[i]], section.m_contents.data (),
+                   section.m_contents.size ());
+
+      Elf64_Shdr shdr{};
+      shdr.sh_name = section_names[i];
+      shdr.sh_type = section.m_type;
+      shdr.sh_flags = section.m_flags;
+      shdr.sh_addr = (section.m_flags & SHF_ALLOC) ? section_offsets[i] : 0;
+      shdr.sh_offset = section_offsets[i];
+      shdr.sh_size = section.m_contents.size ();
+      shdr.sh_link = section.m_link;
+      shdr.sh_info = section.m_info;
+      shdr.sh_addralign = section.m_addralign;
+      shdr.sh_entsize = section.m_entsize;
+      write (image, shdr_offset + (i + 1) * sizeof (Elf64_Shdr), shdr);
+    }
+
+  for (auto &&function : code_object.m_functions)
+    write_function (image, function.m_address, function.m_size);
+
+  return code_object;
+}
+
+} /* namespace amd::debug_agent */
@@ -0,0 +1,126 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#ifndef _ROCM_DEBUG_AGENT_SYNTHETIC_CODE_OBJECT_H
+#define _ROCM_DEBUG_AGENT_SYNTHETIC_CODE_OBJECT_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace amd::debug_agent
+{
+
+/* The instructions of the synthetic code objects.  They are encoded in the
+   top byte of their first 32-bit word, and decoded by the fake
+   libamd-dbgapi.  */
+enum class synthetic_opcode_t : uint8_t
+{
+  s_nop = 0xbf,
+  s_load = 0xc0,
+  v_add = 0x68,
+  /* An 8-byte instruction.  */
+  global_load = 0xdc,
+  /* A branch to the signed word offset in the low 16 bits, relative to the
+     next instruction.  */
+  s_branch = 0xba,
+  s_endpgm = 0xb1
+};
+
+/* Return the size in bytes of an instruction with OPCODE.  */
+constexpr size_t
+synthetic_instruction_size (synthetic_opcode_t opcode)
+{
+  return opcode == synthetic_opcode_t::global_load ? 8 : 4;
+}
+
+/* The compilation directory of the compilation units.  The line tables name
+   the source files relative to it.  */
+constexpr char synthetic_compilation_directory[] = "/synthetic";
+
+/* The instructions are grouped in blocks of this size, so that any address
+   aligned on it in a function is the address of an instruction.  */
+constexpr size_t synthetic_block_size = 16;
+
+struct synthetic_code_object_options_t
+{
+  size_t m_function_count{ 64 };
+  /* The size of each function, rounded up to a multiple of
+     synthetic_block_size.  */
+  size_t m_function_size{ 1024 };
+  /* The number of compilation units the functions are spread over, in
+     address order.  Without compilation units, the image has no DWARF
+     sections.  */
+  size_t m_compilation_unit_count{ 0 };
+  /* The number of bytes of padding, not covered by any compilation unit,
+     before each compilation unit but the first, rounded up to a multiple of
+     synthetic_block_size.  */
+  size_t m_compilation_unit_gap{ 0 };
+  /* The number of line table rows of each function.  The rows start
+     instruction blocks, so there are at most m_function_size /
+     synthetic_block_size of them.  */
+  size_t m_line_rows_per_function{ 16 };
+  /* The EF_AMDGPU_MACH value of the ELF header's flags.  */
+  uint32_t m_elf_amdgpu_machine{ 0x3f /* gfx90a */ };
+};
+
+struct synthetic_function_t
+{
+  std::string m_name;
+  /* The address of the function relative to the load address.  */
+  uint64_t m_address;
+  uint64_t m_size;
+  /* The source file of the function's compilation unit, empty if the image
+     has no debug information.  */
+  std::string m_file_name;
+  /* The addresses of the function's line table rows, relative to the load
+     address.  The rows are on consecutive lines from M_FIRST_LINE.  */
+  std::vector<uint64_t> m_row_addresses;
+  uint64_t m_first_line{ 0 };
+};
+
+/* An ELF image that looks like an AMDGPU code object to the agent.  Its
+   loadable segment starts at offset and address 0, so that the image can be
+   used in place as the loaded code object.  The symbol table has a function
+   symbol for each function, and the DWARF 4 compilation units have a
+   DW_AT_low_pc/DW_AT_high_pc range and a line program.  */
+struct synthetic_code_object_t
+{
+  std::vector<char> m_image;
+  std::vector<synthetic_function_t> m_functions;
+};
+
+synthetic_code_object_t
+make_synthetic_code_object (const synthetic_code_object_options_t &options);
+
+} /* namespace amd::debug_agent */
+
+#endif /* _ROCM_DEBUG_AGENT_SYNTHETIC_CODE_OBJECT_H */
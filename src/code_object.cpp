@@ -31,32 +31,38 @@
 #include "code_object.h"
 #include "debug.h"
 #include "logging.h"
+#include "report_stats.h"
+#include "snapshot.h"
 
 #include <ctype.h>
 #include <cxxabi.h>
 #include <elf.h>
+#include <endian.h>
 #include <elfutils/libdw.h>
 #include <fcntl.h>
 #include <gelf.h>
 #include <libelf.h>
 #include <stdlib.h>
 #include <string.h>
-#if HAVE_MEMFD_CREATE
-#include <limits.h>
+#include <pthread.h>
 #include <sys/mman.h>
-#endif /* HAVE_MEMFD_CREATE */
+#include <sys/resource.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iterator>
-#include <limits>
 #include <memory>
 #include <string>
-#include <type_traits>
+#include <system_error>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace amd::debug_agent
@@ -65,6 +71,7 @@ namespace amd::debug_agent
 code_object_t::code_object_t (amd_dbgapi_code_object_id_t code_object_id)
     : m_code_object_id (code_object_id)
 {
+  count_dbgapi_call ();
   if (amd_dbgapi_code_object_get_info (
           code_object_id, AMD_DBGAPI_CODE_OBJECT_INFO_LOAD_ADDRESS,
           sizeof (m_load_address), &m_load_address)
@@ -75,6 +82,7 @@ code_object_t::code_object_t (amd_dbgapi_code_object_id_t code_object_id)
     }
 
   char *value;
+  count_dbgapi_call ();
   if (amd_dbgapi_code_object_get_info (m_code_object_id,
                                        AMD_DBGAPI_CODE_OBJECT_INFO_URI_NAME,
                                        sizeof (value), &value)
@@ -88,19 +96,14 @@ code_object_t::code_object_t (amd_dbgapi_code_object_id_t code_object_id)
   free (value);
 }
 
-code_object_t::code_object_t (code_object_t &&rhs)
-    : m_load_address (rhs.m_load_address), m_mem_size (rhs.m_mem_size),
-      m_uri (std::move (rhs.m_uri)), m_code_object_id (rhs.m_code_object_id)
+code_object_t::code_object_t (std::string uri,
+                              amd_dbgapi_global_address_t load_address)
+    : m_load_address (load_address), m_uri (std::move (uri)),
+      m_code_object_id (AMD_DBGAPI_CODE_OBJECT_NONE)
 {
-  m_fd = rhs.m_fd;
-  rhs.m_fd.reset ();
 }
 
-code_object_t::~code_object_t ()
-{
-  if (m_fd)
-    ::close (*m_fd);
-}
+code_object_t::~code_object_t () { close (); }
 
 std::optional<code_object_t::symbol_info_t>
 code_object_t::find_symbol (amd_dbgapi_global_address_t address)
@@ -108,29 +111,48 @@ code_object_t::find_symbol (amd_dbgapi_global_address_t address)
   /* Load the symbol table.  */
   load_symbol_map ();
 
-  if (auto it = m_symbol_map->upper_bound (address);
-      it != m_symbol_map->begin ())
+  if (auto index = m_symbol_table->find (address))
     {
-      if (auto &&[symbol_value, symbol] = *std::prev (it);
-          address < (symbol_value + symbol.second))
+      if (m_demangled_names.empty ())
+        m_demangled_names.resize (m_symbol_table->size ());
+
+      std::string_view &symbol_name = m_demangled_names[*index];
+      if (symbol_name.data () == nullptr)
         {
-          std::string symbol_name = symbol.first;
+          const char *mangled_name = m_symbol_table->name (*index);
 
           if (int status; auto *demangled_name = abi::__cxa_demangle (
-                              symbol_name.c_str (), nullptr, nullptr, &status))
+                              mangled_name, nullptr, nullptr, &status))
             {
+              m_demangled_name_storage.emplace_back (demangled_name,
+                                                     std::free);
               symbol_name = demangled_name;
-              free (demangled_name);
             }
-
-          return symbol_info_t{ std::move (symbol_name), symbol_value,
-                                symbol.second };
+          else
+            symbol_name = mangled_name;
         }
+
+      return symbol_info_t{ symbol_name, m_symbol_table->address (*index),
+                            m_symbol_table->symbol_size (*index) };
     }
 
   return {};
 }
 
+std::vector<
+    std::pair<amd_dbgapi_global_address_t, amd_dbgapi_global_address_t>>
+code_object_t::find_line_address_ranges (const std::string &file_name,
+                                         size_t line)
+{
+  /* Load the line number table.  */
+  load_debug_info ();
+
+  if (auto file = m_line_table->find_file (file_name))
+    return m_line_table->address_ranges (*file, line);
+
+  return {};
+}
+
 void
 code_object_t::open ()
 {
@@ -182,7 +204,8 @@ code_object_t::open ()
       params.emplace (token.substr (0, delim), token.substr (delim + 1));
   });
 
-  std::vector<char> buffer;
+  char *image{ nullptr };
+  size_t image_size{ 0 };
   try
     {
       size_t offset{ 0 }, size{ 0 };
@@ -196,31 +219,92 @@ code_object_t::open ()
 
       if (protocol == "file")
         {
-          std::ifstream file (decoded_path, std::ios::in | std::ios::binary);
-          if (!file)
+          int fd = ::open (decoded_path.c_str (), O_RDONLY | O_CLOEXEC);
+          if (fd == -1)
             {
               agent_warning ("could not open `%s'", decoded_path.c_str ());
               return;
             }
 
+          struct stat file_stat;
+          if (::fstat (fd, &file_stat) == -1)
+            {
+              agent_warning ("could not stat `%s': %s", decoded_path.c_str (),
+                             strerror (errno));
+              ::close (fd);
+              return;
+            }
+
+          size_t file_size = file_stat.st_size;
+          if (file_size < offset || (size && (file_size - offset) < size))
+            {
+              agent_warning ("invalid uri `%s' (file size < offset + size)",
+                             decoded_path.c_str ());
+              ::close (fd);
+              return;
+            }
+
           if (!size)
+            size = file_size - offset;
+
+          /* A mapping of a file truncated or rewritten while it is in use
+             raises SIGBUS in the application the next time the image is
+             read.  The files written by other users could change under us,
+             so copy their code objects instead of mapping them.  */
+          if (file_stat.st_uid != ::geteuid ()
+              || (file_stat.st_mode & (S_IWGRP | S_IWOTH)))
             {
-              file.ignore (std::numeric_limits<std::streamsize>::max ());
-              size_t bytes = file.gcount ();
-              file.clear ();
+              m_buffer.resize (size);
+              for (size_t done = 0; done < size;)
+                {
+                  ssize_t count = ::pread (fd, m_buffer.data () + done,
+                                           size - done, offset + done);
+                  if (count == -1 && errno == EINTR)
+                    continue;
 
-              if (bytes < offset)
+                  if (count <= 0)
+                    {
+                      agent_warning ("could not read `%s'",
+                                     decoded_path.c_str ());
+                      ::close (fd);
+                      close ();
+                      return;
+                    }
+
+                  done += count;
+                }
+              ::close (fd);
+
+              image = m_buffer.data ();
+              image_size = size;
+            }
+          else
+            {
+              /* Map the [offset, offset + size) window of the file instead
+                 of copying it.  The application's own files are not
+                 expected to change while they are loaded.  The mapping's
+                 file offset must be page aligned.  The mapping is private
+                 and writable as libelf is allowed to modify the memory
+                 image it is given.  */
+              size_t page_offset = offset % ::sysconf (_SC_PAGESIZE);
+              void *mapping = ::mmap (nullptr, size + page_offset,
+                                      PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                                      fd, offset - page_offset);
+              ::close (fd);
+
+              if (mapping == MAP_FAILED)
                 {
-                  agent_warning ("invalid uri `%s' (file size < offset)",
-                                 decoded_path.c_str ());
+                  agent_warning ("could not map `%s': %s",
+                                 decoded_path.c_str (), strerror (errno));
                   return;
                 }
-              size = bytes - offset;
-            }
 
-          file.seekg (offset, std::ios_base::beg);
-          buffer.resize (size);
-          file.read (&buffer[0], size);
+              m_mapping = mapping;
+              m_mapping_size = size + page_offset;
+
+              image = static_cast<char *> (mapping) + page_offset;
+              image_size = size;
+            }
         }
       else if (protocol == "memory")
         {
@@ -232,21 +316,28 @@ code_object_t::open ()
             }
 
           amd_dbgapi_process_id_t process_id;
+          count_dbgapi_call ();
           if (amd_dbgapi_code_object_get_info (
                   m_code_object_id, AMD_DBGAPI_CODE_OBJECT_INFO_PROCESS,
                   sizeof (process_id), &process_id)
               != AMD_DBGAPI_STATUS_SUCCESS)
             agent_error ("could not get the process from the agent");
 
-          buffer.resize (size);
+          m_buffer.resize (size);
+          count_dbgapi_call ();
           if (amd_dbgapi_read_memory (process_id, AMD_DBGAPI_WAVE_NONE, AMD_DBGAPI_LANE_NONE,
                                       AMD_DBGAPI_ADDRESS_SPACE_GLOBAL, offset,
-                                      &size, buffer.data ())
+                                      &size, m_buffer.data ())
               != AMD_DBGAPI_STATUS_SUCCESS)
             {
               agent_warning ("could not read memory at 0x%lx", offset);
+              close ();
               return;
             }
+          count_bytes_read (size);
+
+          image = m_buffer.data ();
+          image_size = size;
         }
       else
         {
@@ -258,75 +349,36 @@ code_object_t::open ()
     {
     }
 
-  int fd =
-#if HAVE_MEMFD_CREATE
-      ::memfd_create (
-          [uri = m_uri] () -> std::string {
-            /* The memfd_create(2) NAME parameter needs to be at most 249
-               bytes (excluding the terminating null byte).  This is because
-               an entry named "memfd:NAME" will be created in /proc/PID/fd.
-               This entry's name must to be under NAME_MAX bytes limit (255 on
-               Linux), including the "memfd:" prefix.
-
-               The name parameter given to memfd_create is not important, and
-               do not need to be unique.  However, to help debugging, trim the
-               extra bytes from the left, so the "offset" and "size" parts
-               encoded in the name are kept.  */
-
-            if (auto length = uri.length ();
-                length > NAME_MAX - 6 /* strlen ("memfd:")  */)
-              {
-                /* Since we know that a code object's URI must start with
-                   'memory://' or 'file://', and that 'memory://' code objects
-                   can't exceed the 249 limit, we must have a 'file://' URI.
-                   When left-trimming, keep the 'file://' part.  */
-                agent_assert (uri.substr (0, 7) == "file://");
-                return uri.substr (0, 7) /* Keep the "file://" prefix (8b)  */
-                       + "[...]"
-                       + uri.substr (length
-                                         - (NAME_MAX
-                                            - 6 /* strlen ("memfd:")  */
-                                            - 8 /* strlen ("file://") */
-                                            - 5 /* strlen ("[...]")  */),
-                                     length);
-              }
-            return uri;
-          }().c_str (),
-          MFD_ALLOW_SEALING | MFD_CLOEXEC);
-#else /* !HAVE_MEMFD_CREATE */
-    ::open ("/tmp", O_TMPFILE | O_RDWR, 0666);
-#endif /* !HAVE_MEMFD_CREATE */
-  if (fd == -1)
-    {
-      agent_warning ("could not create a temporary file for code object: %s",
-                     strerror (errno));
-      return;
-    }
-
-  if (size_t size = ::write (fd, buffer.data (), buffer.size ());
-      size != buffer.size ())
-    {
-      agent_warning ("could not write to the temporary file");
-      return;
-    }
+  if (image && !set_image (image, image_size))
+    close ();
+}
 
-  ::lseek (fd, 0, SEEK_SET);
+void
+code_object_t::open (std::vector<char> image)
+{
+  m_buffer = std::move (image);
+  if (!set_image (m_buffer.data (), m_buffer.size ()))
+    close ();
+}
 
+bool
+code_object_t::set_image (char *image, size_t image_size)
+{
   /* Calculate the size of the code object as loaded in memory.  Its size is
      the distance of the end of the highest segment from the load address.  */
   std::unique_ptr<Elf, void (*) (Elf *)> elf (
-      elf_begin (fd, ELF_C_READ, nullptr), [] (Elf *elf) { elf_end (elf); });
+      elf_memory (image, image_size), [] (Elf *elf) { elf_end (elf); });
   if (!elf)
     {
-      agent_warning ("elf_begin failed for `%s'", m_uri.c_str ());
-      return;
+      agent_warning ("elf_memory failed for `%s'", m_uri.c_str ());
+      return false;
     }
 
   size_t phnum;
   if (elf_getphdrnum (elf.get (), &phnum) != 0)
     {
       agent_warning ("elf_getphdrnum failed for `%s'", m_uri.c_str ());
-      return;
+      return false;
     }
 
   for (size_t i = 0; i < phnum; ++i)
@@ -336,14 +388,87 @@ code_object_t::open ()
       if (!phdr)
         {
           agent_warning ("gelf_getphdr failed for `%s'", m_uri.c_str ());
-          return;
+          return false;
         }
 
       if (phdr->p_type == PT_LOAD)
         m_mem_size = std::max (m_mem_size, phdr->p_vaddr + phdr->p_memsz);
     }
 
-  m_fd.emplace (fd);
+  m_image = image;
+  m_image_size = image_size;
+  return true;
+}
+
+uint64_t
+code_object_t::content_hash ()
+{
+  agent_assert (is_open () && "code object is not opened");
+
+  if (!m_content_hash)
+    m_content_hash = snapshot_hash (m_image, m_image_size);
+
+  return *m_content_hash;
+}
+
+bool
+code_object_t::read_image_memory (amd_dbgapi_global_address_t address,
+                                  void *buffer, amd_dbgapi_size_t *size) const
+{
+  agent_assert (is_open () && "code object is not opened");
+
+  std::unique_ptr<Elf, void (*) (Elf *)> elf (
+      elf_memory (m_image, m_image_size), [] (Elf *elf) { elf_end (elf); });
+
+  size_t phnum;
+  if (!elf || elf_getphdrnum (elf.get (), &phnum) != 0)
+    return false;
+
+  const amd_dbgapi_global_address_t vaddr = address - m_load_address;
+
+  for (size_t i = 0; i < phnum; ++i)
+    {
+      GElf_Phdr phdr_mem;
+      GElf_Phdr *phdr = gelf_getphdr (elf.get (), i, &phdr_mem);
+      if (!phdr || phdr->p_type != PT_LOAD || vaddr < phdr->p_vaddr
+          || (vaddr - phdr->p_vaddr) >= phdr->p_filesz)
+        continue;
+
+      const size_t offset = phdr->p_offset + (vaddr - phdr->p_vaddr);
+      if (offset >= m_image_size)
+        return false;
+
+      *size = std::min<amd_dbgapi_size_t> (
+          { *size, phdr->p_filesz - (vaddr - phdr->p_vaddr),
+            m_image_size - offset });
+      std::memcpy (buffer, m_image + offset, *size);
+      return true;
+    }
+
+  return false;
+}
+
+void
+code_object_t::close ()
+{
+  if (m_mapping)
+    ::munmap (m_mapping, m_mapping_size);
+
+  m_mapping = nullptr;
+  m_mapping_size = 0;
+  m_buffer.clear ();
+  m_buffer.shrink_to_fit ();
+
+  if (m_dwarf)
+    dwarf_end (m_dwarf);
+  if (m_elf)
+    elf_end (m_elf);
+
+  m_dwarf = nullptr;
+  m_elf = nullptr;
+
+  m_image = nullptr;
+  m_image_size = 0;
 }
 
 namespace
@@ -381,18 +506,21 @@ code_object_t::load_symbol_map ()
 {
   agent_assert (is_open () && "code object is not opened");
 
-  if (m_symbol_map.has_value ())
+  if (m_symbol_table.has_value ())
     return;
 
-  m_symbol_map.emplace ();
+  m_symbol_table.emplace ();
 
   std::unique_ptr<Elf, void (*) (Elf *)> elf (
-      elf_begin (*m_fd, ELF_C_READ, nullptr),
-      [] (Elf *elf) { elf_end (elf); });
+      elf_memory (m_image, m_image_size), [] (Elf *elf) { elf_end (elf); });
 
   if (!elf)
     return;
 
+  /* Offsets in the symbol table's string arena of the string tables already
+     copied, indexed by section index.  */
+  std::unordered_map<size_t, size_t> string_table_offsets;
+
   /* Slurp the symbol table.  */
   Elf_Scn *scn = nullptr;
   while ((scn = elf_nextscn (elf.get (), scn)) != nullptr)
@@ -406,6 +534,18 @@ code_object_t::load_symbol_map ()
       if (!data)
         continue;
 
+      Elf_Data *strings
+          = elf_getdata (elf_getscn (elf.get (), shdr->sh_link), nullptr);
+      if (!strings)
+        continue;
+
+      auto [offset_it, inserted]
+          = string_table_offsets.try_emplace (shdr->sh_link);
+      if (inserted)
+        offset_it->second = m_symbol_table->add_string_table (
+            static_cast<const char *> (strings->d_buf), strings->d_size);
+      size_t strings_offset = offset_it->second;
+
       size_t symbol_count
           = data->d_size / gelf_fsize (elf.get (), ELF_T_SYM, 1, EV_CURRENT);
       for (size_t j = 0; j < symbol_count; ++j)
@@ -414,110 +554,306 @@ code_object_t::load_symbol_map ()
           GElf_Sym *sym = gelf_getsym (data, j, &sym_mem);
 
           if (GELF_ST_TYPE (sym->st_info) != STT_FUNC
-              || sym->st_shndx == SHN_UNDEF)
+              || sym->st_shndx == SHN_UNDEF || sym->st_name >= strings->d_size)
             continue;
 
-          std::string symbol_name{ elf_strptr (elf.get (), shdr->sh_link,
-                                               sym->st_name) };
-
-          auto [it, success] = m_symbol_map->emplace (
-              m_load_address + sym->st_value,
-              std::make_pair (symbol_name, sym->st_size));
-
-          /* If there already was a symbol defined at this address, but this
-             new symbol covers a larger address range, replace the old symbol
-             with this new one.  */
-          if (!success && sym->st_size > it->second.second)
-            it->second = std::make_pair (symbol_name, sym->st_size);
+          m_symbol_table->add (m_load_address + sym->st_value, sym->st_size,
+                               strings_offset + sym->st_name);
         }
     }
 
+  m_symbol_table->finalize ();
+
   /* TODO: If we did not see a symbtab, check the dynamic segment.  */
 }
 
 void
-code_object_t::load_debug_info ()
+code_object_t::load_compilation_units ()
 {
   agent_assert (is_open () && "code object is not opened");
 
-  if (m_line_number_map.has_value () && m_pc_ranges_map.has_value ())
+  if (m_line_table.has_value () && m_pc_ranges_map.has_value ())
     return;
 
-  m_line_number_map.emplace ();
+  m_line_table.emplace ();
   m_pc_ranges_map.emplace ();
 
-  std::unique_ptr<Dwarf, void (*) (Dwarf *)> dbg (
-      dwarf_begin (*m_fd, DWARF_C_READ), [] (Dwarf *dbg) { dwarf_end (dbg); });
+  if (!(m_elf = elf_memory (m_image, m_image_size)))
+    return;
 
-  if (!dbg)
+  if (!(m_dwarf = dwarf_begin_elf (m_elf, DWARF_C_READ, nullptr)))
     return;
 
   Dwarf_Off cu_offset{ 0 }, next_offset;
   size_t header_size;
 
-  while (!dwarf_nextcu (dbg.get (), cu_offset, &next_offset, &header_size,
+  while (!dwarf_nextcu (m_dwarf, cu_offset, &next_offset, &header_size,
                         nullptr, nullptr, nullptr))
     {
+      Dwarf_Off die_offset = cu_offset + header_size;
+      cu_offset = next_offset;
+
       Dwarf_Die die;
-      if (!dwarf_offdie (dbg.get (), cu_offset + header_size, &die))
+      if (!dwarf_offdie (m_dwarf, die_offset, &die))
         continue;
 
+      size_t cu_index = m_compilation_units.size ();
+      auto &cu = m_compilation_units.emplace_back (
+          compilation_unit_t{ die_offset });
+
       ptrdiff_t offset = 0;
       Dwarf_Addr base, start{ 0 }, end{ 0 };
 
       /* dwarf_ranges returns a single contiguous range
          (DW_AT_low_pc/DW_AT_high_pc), or a series of non-contiguous ranges
          (DW_AT_ranges). */
-      while ((offset = dwarf_ranges (&die, offset, &base, &start, &end) > 0))
-        m_pc_ranges_map->emplace (m_load_address + start,
-                                  m_load_address + end);
+      while ((offset = dwarf_ranges (&die, offset, &base, &start, &end)) > 0)
+        {
+          m_pc_ranges_map->emplace (
+              m_load_address + start,
+              std::make_pair (m_load_address + end, cu_index));
+          cu.m_has_ranges = true;
+        }
+    }
+}
 
-      Dwarf_Lines *lines;
-      size_t line_count;
-      if (dwarf_getsrclines (&die, &lines, &line_count))
+namespace
+{
+
+/* The maximum number of threads decoding line programs in parallel.  */
+constexpr size_t max_line_program_threads = 8;
+
+/* Decode the line program of the compilation unit whose DIE is at DIE_OFFSET
+   into FRAGMENT.  */
+void
+decode_line_program (Dwarf *dwarf, Dwarf_Off die_offset,
+                     amd_dbgapi_global_address_t load_address,
+                     line_table_t::fragment_t &fragment)
+{
+  Dwarf_Die die;
+  if (!dwarf_offdie (dwarf, die_offset, &die))
+    return;
+
+  Dwarf_Lines *lines;
+  size_t line_count;
+  if (dwarf_getsrclines (&die, &lines, &line_count))
+    return;
+
+  for (size_t i = 0; i < line_count; ++i)
+    {
+      Dwarf_Line *line = dwarf_onesrcline (lines, i);
+      Dwarf_Addr addr;
+      if (!line || dwarf_lineaddr (line, &addr))
         continue;
 
-      for (size_t i = 0; i < line_count; ++i)
+      /* The end of a sequence is the first address after it, not a row of
+         its own, and a row without a line number ends the previous
+         row.  */
+      bool end_sequence;
+      int line_number;
+      if ((!dwarf_lineendsequence (line, &end_sequence) && end_sequence)
+          || dwarf_lineno (line, &line_number) || line_number <= 0)
         {
-          Dwarf_Addr addr;
-          int line_number;
+          fragment.add_end (load_address + addr);
+          continue;
+        }
 
-          if (Dwarf_Line *line = dwarf_onesrcline (lines, i);
-              line && !dwarf_lineaddr (line, &addr)
-              && !dwarf_lineno (line, &line_number) && line_number)
-            {
-              m_line_number_map->emplace (
-                  m_load_address + addr,
-                  std::make_pair (dwarf_linesrc (line, nullptr, nullptr),
-                                  line_number));
-            }
+      fragment.add (load_address + addr,
+                    dwarf_linesrc (line, nullptr, nullptr), line_number);
+    }
+}
+
+} /* namespace */
+
+void
+code_object_t::load_line_table (size_t cu_index)
+{
+  auto &cu = m_compilation_units[cu_index];
+
+  if (cu.m_line_table_loaded)
+    return;
+
+  cu.m_line_table_loaded = true;
+
+  line_table_t::fragment_t fragment;
+  decode_line_program (m_dwarf, cu.m_die_offset, m_load_address, fragment);
+
+  if (!fragment.empty ())
+    m_line_table->insert (fragment);
+}
+
+void
+code_object_t::load_debug_info ()
+{
+  load_compilation_units ();
+
+  std::vector<size_t> pending;
+  for (size_t i = 0; i < m_compilation_units.size (); ++i)
+    if (!m_compilation_units[i].m_line_table_loaded)
+      pending.emplace_back (i);
+
+  if (pending.empty ())
+    return;
+
+  /* Decode the line programs in parallel.  The compilation units are handed
+     out one at a time, and each line program is decoded into its own
+     fragment.  */
+  std::vector<line_table_t::fragment_t> fragments (pending.size ());
+  std::atomic<size_t> next_pending{ 0 };
+
+  auto decode = [&] (Dwarf *dwarf) {
+    for (size_t i; (i = next_pending.fetch_add (1, std::memory_order_relaxed))
+                   < pending.size ();)
+      decode_line_program (dwarf, m_compilation_units[pending[i]].m_die_offset,
+                           m_load_address, fragments[i]);
+  };
+
+  size_t thread_count
+      = std::min<size_t> ({ std::thread::hardware_concurrency (),
+                            max_line_program_threads, pending.size () });
+
+  /* libdw handles are not thread-safe, so each additional thread opens its
+     own ELF and DWARF handles on the image.  The image is writable because
+     libelf may write to it: when the ELF file is modified, which the agent
+     never does, and when converting the data of a file of the other byte
+     order.  A native byte order image is only read, so all the handles can
+     share it.  Other images are decoded by this thread only.  */
+  GElf_Ehdr ehdr;
+  if (!gelf_getehdr (m_elf, &ehdr)
+      || ehdr.e_ident[EI_DATA]
+             != (__BYTE_ORDER == __LITTLE_ENDIAN ? ELFDATA2LSB : ELFDATA2MSB))
+    thread_count = 1;
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < thread_count; ++i)
+    {
+      try
+        {
+          threads.emplace_back ([this, &decode] () {
+            std::unique_ptr<Elf, void (*) (Elf *)> elf (
+                elf_memory (m_image, m_image_size),
+                [] (Elf *elf) { elf_end (elf); });
+
+            if (!elf)
+              return;
+
+            std::unique_ptr<Dwarf, void (*) (Dwarf *)> dwarf (
+                dwarf_begin_elf (elf.get (), DWARF_C_READ, nullptr),
+                [] (Dwarf *dwarf) { dwarf_end (dwarf); });
+
+            if (dwarf)
+              decode (dwarf.get ());
+          });
+        }
+      catch (const std::system_error &error)
+        {
+          /* Carry on with the threads already started.  */
+          agent_log (log_level_t::info,
+                     "could not start a line program decoding thread: %s",
+                     error.what ());
+          break;
         }
+    }
 
-      cu_offset = next_offset;
+  /* This thread uses the code object's handles.  It keeps decoding until no
+     compilation unit is left, so all the compilation units are decoded
+     even if fewer threads were started, or if a thread could not open its
+     handles.  */
+  decode (m_dwarf);
+
+  for (auto &&thread : threads)
+    thread.join ();
+
+  /* Merge the fragments in compilation unit order, so that the first row
+     for an address is the same as with a sequential decode.  */
+  for (size_t i = 0; i < pending.size (); ++i)
+    {
+      m_compilation_units[pending[i]].m_line_table_loaded = true;
+      if (!fragments[i].empty ())
+        m_line_table->merge (fragments[i]);
     }
+
+  m_line_table->finalize ();
 }
 
 void
-code_object_t::disassemble (amd_dbgapi_architecture_id_t architecture_id,
-                            amd_dbgapi_global_address_t pc)
+code_object_t::load_debug_info (amd_dbgapi_global_address_t pc)
+{
+  load_compilation_units ();
+
+  if (auto it = m_pc_ranges_map->upper_bound (pc);
+      it != m_pc_ranges_map->begin ())
+    {
+      if (auto [high_pc, cu_index] = std::prev (it)->second; pc < high_pc)
+        load_line_table (cu_index);
+    }
+
+  /* A compilation unit without address ranges could contain any pc.  */
+  for (size_t i = 0; i < m_compilation_units.size (); ++i)
+    if (!m_compilation_units[i].m_has_ranges)
+      load_line_table (i);
+}
+
+code_object_t::memory_reader_t
+code_object_t::process_memory_reader () const
 {
   amd_dbgapi_process_id_t process_id;
+  count_dbgapi_call ();
   if (amd_dbgapi_code_object_get_info (m_code_object_id,
                                        AMD_DBGAPI_CODE_OBJECT_INFO_PROCESS,
                                        sizeof (process_id), &process_id)
       != AMD_DBGAPI_STATUS_SUCCESS)
     agent_error ("could not get the process from the agent");
 
-  amd_dbgapi_size_t largest_instruction_size;
+  return [process_id] (amd_dbgapi_global_address_t address, void *buffer,
+                       amd_dbgapi_size_t *size) {
+    count_dbgapi_call ();
+    if (amd_dbgapi_read_memory (process_id, AMD_DBGAPI_WAVE_NONE,
+                                AMD_DBGAPI_LANE_NONE,
+                                AMD_DBGAPI_ADDRESS_SPACE_GLOBAL, address, size,
+                                buffer)
+        != AMD_DBGAPI_STATUS_SUCCESS)
+      return false;
+
+    count_bytes_read (*size);
+    return true;
+  };
+}
+
+namespace
+{
+
+amd_dbgapi_size_t
+largest_instruction_size (amd_dbgapi_architecture_id_t architecture_id)
+{
+  amd_dbgapi_size_t size;
+  count_dbgapi_call ();
   if (amd_dbgapi_architecture_get_info (
           architecture_id,
           AMD_DBGAPI_ARCHITECTURE_INFO_LARGEST_INSTRUCTION_SIZE,
-          sizeof (largest_instruction_size), &largest_instruction_size)
+          sizeof (size), &size)
       != AMD_DBGAPI_STATUS_SUCCESS)
     agent_error ("could not get the instruction size from the architecture");
 
-  /* Load the line number table, and low/high pc for all CUs.  */
-  load_debug_info ();
+  return size;
+}
+
+} /* namespace */
+
+code_object_t::disassembly_range_t
+code_object_t::disassembly_range (amd_dbgapi_architecture_id_t architecture_id,
+                                  amd_dbgapi_global_address_t pc,
+                                  const memory_reader_t &read_memory)
+{
+  const amd_dbgapi_size_t instruction_size
+      = largest_instruction_size (architecture_id);
+
+  /* Load the low/high pc for all CUs, and the line number table of the CU
+     containing pc.  */
+  {
+    report_phase_timer_t timer (report_phase_t::source_files);
+    load_debug_info (pc);
+  }
 
   constexpr int context_byte_size = 24;
   amd_dbgapi_global_address_t start_pc;
@@ -526,18 +862,17 @@ code_object_t::disassemble (amd_dbgapi_architecture_id_t architecture_id,
      If we don't have a line number map, simply start the disassembly from the
      current pc.  */
 
-  if (auto it = m_line_number_map->upper_bound (pc);
-      it != m_line_number_map->begin ())
+  if (size_t row = m_line_table->upper_bound (pc); row != 0)
     {
       do
         {
-          it = std::prev (it);
-          if ((pc - it->first) >= context_byte_size)
+          --row;
+          if ((pc - m_line_table->address (row)) >= context_byte_size)
             break;
         }
-      while (it != m_line_number_map->begin ());
+      while (row != 0);
 
-      start_pc = it->first;
+      start_pc = m_line_table->address (row);
     }
   else
     {
@@ -555,42 +890,27 @@ code_object_t::disassemble (amd_dbgapi_architecture_id_t architecture_id,
   if (auto it = m_pc_ranges_map->upper_bound (pc);
       it != m_pc_ranges_map->begin ())
     {
-      if (auto [low_pc, high_pc] = *std::prev (it); pc < high_pc)
+      if (auto [low_pc, cu_range] = *std::prev (it); pc < cu_range.first)
         {
           start_pc = std::max (start_pc, low_pc);
-          end_pc = std::min (end_pc, high_pc);
+          end_pc = std::min (end_pc, cu_range.first);
         }
     }
 
-  auto symbol = find_symbol (pc);
-
-  agent_out << std::endl << "Disassembly";
-  if (symbol)
-    agent_out << " for function " << symbol->m_name;
-  agent_out << ":" << std::endl;
-
-  agent_out << "    code object: " << m_uri << std::endl;
-  agent_out << "    loaded at: "
-            << "[0x" << std::hex << m_load_address << "-"
-            << "0x" << std::hex << (m_load_address + m_mem_size) << "]"
-            << std::endl;
-
   /* Remember the start_pc address to print the first source line.  */
-  amd_dbgapi_global_address_t saved_start_pc{ start_pc };
+  amd_dbgapi_global_address_t line_start_pc{ start_pc };
 
   /* Now that we know start_pc is a valid instruction address, skip ahead until
      the distance between start_pc and pc is <= context_byte_size.  */
   while ((pc - start_pc) > context_byte_size)
     {
-      std::vector<uint8_t> buffer (largest_instruction_size);
+      std::vector<uint8_t> buffer (instruction_size);
 
       amd_dbgapi_size_t size = buffer.size ();
-      if (amd_dbgapi_read_memory (
-              process_id, AMD_DBGAPI_WAVE_NONE, AMD_DBGAPI_LANE_NONE,
-              AMD_DBGAPI_ADDRESS_SPACE_GLOBAL, start_pc, &size, buffer.data ())
-          != AMD_DBGAPI_STATUS_SUCCESS)
+      if (!read_memory (start_pc, buffer.data (), &size))
         break;
 
+      count_dbgapi_call ();
       if (amd_dbgapi_disassemble_instruction (
               architecture_id, start_pc, &size, buffer.data (), nullptr,
               amd_dbgapi_symbolizer_id_t{}, nullptr)
@@ -603,23 +923,114 @@ code_object_t::disassemble (amd_dbgapi_architecture_id_t architecture_id,
       start_pc += size;
     }
 
-  std::string prev_file_name;
+  return { line_start_pc, start_pc, end_pc };
+}
+
+std::string
+code_object_t::disassemble_instruction (
+    amd_dbgapi_architecture_id_t architecture_id,
+    amd_dbgapi_global_address_t address, const uint8_t *buffer,
+    amd_dbgapi_size_t *size)
+{
+  auto symbolizer = [] (amd_dbgapi_symbolizer_id_t symbolizer_id,
+                        amd_dbgapi_global_address_t address,
+                        char **symbol_text) {
+    auto &code_object = *reinterpret_cast<code_object_t *> (symbolizer_id);
+    std::stringstream ss;
+
+    ss << "0x" << std::hex << address;
+
+    if (auto &&symbol = code_object.find_symbol (address))
+      {
+        ss << " <" << symbol->m_name;
+        ss << "+" << std::dec << (address - symbol->m_value);
+        ss << ">";
+      }
+
+    *symbol_text = strdup (ss.str ().c_str ());
+    return AMD_DBGAPI_STATUS_SUCCESS;
+  };
+
+  char *value;
+  count_dbgapi_call ();
+  if (amd_dbgapi_disassemble_instruction (
+          architecture_id, address, size, buffer, &value,
+          reinterpret_cast<amd_dbgapi_symbolizer_id_t> (this), symbolizer)
+      != AMD_DBGAPI_STATUS_SUCCESS)
+    agent_error ("amd_dbgapi_disassemble_instruction failed");
+
+  std::string instruction (value);
+  free (value);
+  return instruction;
+}
+
+void
+code_object_t::disassemble (amd_dbgapi_architecture_id_t architecture_id,
+                            amd_dbgapi_global_address_t pc)
+{
+  disassemble (architecture_id, pc, process_memory_reader ());
+}
+
+void
+code_object_t::disassemble (amd_dbgapi_architecture_id_t architecture_id,
+                            amd_dbgapi_global_address_t pc,
+                            const memory_reader_t &read_memory)
+{
+  const amd_dbgapi_size_t instruction_size
+      = largest_instruction_size (architecture_id);
+
+  auto [saved_start_pc, start_pc, end_pc]
+      = disassembly_range (architecture_id, pc, read_memory);
+
+  auto symbol = find_symbol (pc);
+
+  /* The source lines with code are only looked for in the compilation unit
+     address range containing pc, whose line table is loaded, so that the
+     disassembly does not depend on the compilation units loaded by earlier
+     reports.  A pc outside of all the ranges is disassembled with the line
+     tables of all the compilation units.  */
+  amd_dbgapi_global_address_t code_low{ 0 };
+  amd_dbgapi_global_address_t code_high{ UINT64_MAX };
+  if (auto it = m_pc_ranges_map->upper_bound (pc);
+      it != m_pc_ranges_map->begin () && pc < std::prev (it)->second.first)
+    {
+      code_low = std::prev (it)->first;
+      code_high = std::prev (it)->second.first;
+    }
+  else
+    {
+      report_phase_timer_t timer (report_phase_t::source_files);
+      load_debug_info ();
+    }
+
+  agent_out << std::endl << "Disassembly";
+  if (symbol)
+    agent_out << " for function " << symbol->m_name;
+  agent_out << ":" << std::endl;
+
+  agent_out << "    code object: " << m_uri << std::endl;
+  agent_out << "    loaded at: "
+            << "[0x" << std::hex << m_load_address << "-"
+            << "0x" << std::hex << (m_load_address + m_mem_size) << "]"
+            << std::endl;
+
+  std::optional<line_table_t::file_index_t> prev_file;
   size_t prev_line_number{ 0 };
   amd_dbgapi_global_address_t addr{ start_pc };
 
   while (addr < end_pc)
     {
-      if (auto it
-          = m_line_number_map->find (addr == start_pc ? saved_start_pc : addr);
-          it != m_line_number_map->end ())
+      if (auto row
+          = m_line_table->find (addr == start_pc ? saved_start_pc : addr))
         {
-          const std::string &file_name = it->second.first;
-          size_t line_number = it->second.second;
+          line_table_t::file_index_t file = m_line_table->file (*row);
+          const std::string &file_name = m_line_table->file_name (file);
+          size_t line_number = m_line_table->line (*row);
 
-          if (file_name != prev_file_name || line_number != prev_line_number)
+          if (file != prev_file || line_number != prev_line_number)
             agent_out << std::endl;
 
-          if (file_name != prev_file_name)
+          if (file != prev_file)
             agent_out << file_name << ":" << std::endl;
 
           /* If the source line for `addr` is a different line than the
@@ -631,7 +1042,7 @@ code_object_t::disassemble (amd_dbgapi_architecture_id_t architecture_id,
              a source line block.  That allows the disassembly to show all the
              source file lines, including those that have no associated code.
            */
-          if (file_name != prev_file_name || line_number != prev_line_number)
+          if (file != prev_file || line_number != prev_line_number)
             {
               size_t first_line = line_number;
               size_t last_line = line_number;
@@ -639,22 +1050,12 @@ code_object_t::disassemble (amd_dbgapi_architecture_id_t architecture_id,
               /* Find the first line to print between prev_line_number and
                  line_number that does not appear in the line number table.
                */
-              if (file_name == prev_file_name
-                  && (line_number + 1) > prev_line_number)
+              if (file == prev_file && (line_number + 1) > prev_line_number)
                 {
                   while (--first_line > prev_line_number)
                     {
-                      if (std::find_if (
-                              m_line_number_map->begin (),
-                              m_line_number_map->end (),
-                              [first_line, &file_name] (
-                                  const std::remove_reference_t<decltype (
-                                      *m_line_number_map)>::value_type
-                                      &value) {
-                                return file_name == value.second.first
-                                       && first_line == value.second.second;
-                              })
-                          != m_line_number_map->end ())
+                      if (m_line_table->contains (file, first_line,
+                                                  code_low, code_high))
                         break;
                     }
                   /* First is either prev_line_number, or a line associated
@@ -667,6 +1068,7 @@ code_object_t::disassemble (amd_dbgapi_architecture_id_t architecture_id,
                   agent_out << std::setfill (' ') << std::setw (8) << std::left
                             << std::dec << line;
 
+                  report_phase_timer_t timer (report_phase_t::source_files);
                   if (auto lines = get_source_file_index (file_name); !lines)
                     agent_out << file_name << ": No such file or directory.";
                   else if (line && line <= lines->get ().size ())
@@ -676,7 +1078,7 @@ code_object_t::disassemble (amd_dbgapi_architecture_id_t architecture_id,
                 }
             }
 
-          prev_file_name = file_name;
+          prev_file = file;
           prev_line_number = line_number;
 
           /* If the start_pc address is not the begining of a line number
@@ -686,47 +1088,19 @@ code_object_t::disassemble (amd_dbgapi_architecture_id_t architecture_id,
             agent_out << "    ..." << std::endl;
         }
 
-      std::vector<uint8_t> buffer (largest_instruction_size);
+      std::vector<uint8_t> buffer (instruction_size);
 
       amd_dbgapi_size_t size = buffer.size ();
-      if (amd_dbgapi_read_memory (
-              process_id, AMD_DBGAPI_WAVE_NONE, AMD_DBGAPI_LANE_NONE,
-              AMD_DBGAPI_ADDRESS_SPACE_GLOBAL, addr, &size, buffer.data ())
-          != AMD_DBGAPI_STATUS_SUCCESS)
+      if (!read_memory (addr, buffer.data (), &size))
         {
           agent_out << "Cannot access memory at address 0x" << std::hex << addr
                     << std::endl;
           break;
         }
 
-      auto symbolizer = [] (amd_dbgapi_symbolizer_id_t symbolizer_id,
-                            amd_dbgapi_global_address_t address,
-                            char **symbol_text) {
-        auto &code_object = *reinterpret_cast<code_object_t *> (symbolizer_id);
-        std::stringstream ss;
-
-        ss << "0x" << std::hex << address;
-
-        if (auto &&symbol = code_object.find_symbol (address))
-          {
-            ss << " <" << symbol->m_name;
-            ss << "+" << std::dec << (address - symbol->m_value);
-            ss << ">";
-          }
-
-        *symbol_text = strdup (ss.str ().c_str ());
-        return AMD_DBGAPI_STATUS_SUCCESS;
-      };
-
-      char *value;
-      if (amd_dbgapi_disassemble_instruction (
-              architecture_id, addr, &size, buffer.data (), &value,
-              reinterpret_cast<amd_dbgapi_symbolizer_id_t> (this), symbolizer)
-          != AMD_DBGAPI_STATUS_SUCCESS)
-        agent_error ("amd_dbgapi_disassemble_instruction failed");
-
-      std::string instruction (value);
-      free (value);
+      std::string instruction
+          = disassemble_instruction (architecture_id, addr, buffer.data (),
+                                     &size);
 
       agent_out << ((addr == pc) ? " => " : "    ");
 
@@ -750,13 +1124,52 @@ code_object_t::disassemble (amd_dbgapi_architecture_id_t architecture_id,
      block, then print ... to show that the previous instruction was
      not the last of the instructions associated with the previous source ine
      printed.  */
-  if (auto it = m_line_number_map->find (addr);
-      it == m_line_number_map->end ())
+  if (!m_line_table->find (addr))
     agent_out << "    ..." << std::endl;
 
   agent_out << std::endl << "End of disassembly." << std::endl;
 }
 
+std::vector<code_object_t::instruction_t>
+code_object_t::instructions (amd_dbgapi_architecture_id_t architecture_id,
+                             amd_dbgapi_global_address_t pc,
+                             const memory_reader_t &read_memory)
+{
+  const amd_dbgapi_size_t instruction_size
+      = largest_instruction_size (architecture_id);
+
+  auto [line_start_pc, start_pc, end_pc]
+      = disassembly_range (architecture_id, pc, read_memory);
+
+  std::vector<instruction_t> instructions;
+  std::vector<uint8_t> buffer (instruction_size);
+
+  for (amd_dbgapi_global_address_t addr = start_pc; addr < end_pc;)
+    {
+      amd_dbgapi_size_t size = buffer.size ();
+      if (!read_memory (addr, buffer.data (), &size))
+        break;
+
+      instruction_t &instruction = instructions.emplace_back ();
+      instruction.m_address = addr;
+      instruction.m_text = disassemble_instruction (architecture_id, addr,
+                                                    buffer.data (), &size);
+      instruction.m_size = size;
+
+      if (auto row
+          = m_line_table->find (addr == start_pc ? line_start_pc : addr))
+        {
+          instruction.m_file_name
+              = m_line_table->file_name (m_line_table->file (*row));
+          instruction.m_line = m_line_table->line (*row);
+        }
+
+      addr += size;
+    }
+
+  return instructions;
+}
+
 bool
 code_object_t::save (const std::string &directory) const
 {
@@ -770,17 +1183,214 @@ code_object_t::save (const std::string &directory) const
 
   std::string file_path = directory + '/' + name;
   std::ofstream file (file_path, std::ios::out | std::ios::binary);
-  std::vector<char> buffer (lseek (*m_fd, 0, SEEK_END));
-
-  ::lseek (*m_fd, 0, SEEK_SET);
-  if (size_t size = ::read (*m_fd, buffer.data (), buffer.size ());
-      size != buffer.size ())
-    return false;
 
-  file.write (buffer.data (), buffer.size ());
+  file.write (m_image, m_image_size);
   file.close ();
 
   return file.good ();
 }
 
+code_object_parser_t::code_object_parser_t ()
+{
+  m_thread = std::thread (&code_object_parser_t::worker, this);
+
+  if (pthread_setname_np (m_thread.native_handle (), "RocrDebugParse"))
+    agent_warning ("could not set the parser thread name");
+}
+
+code_object_parser_t::~code_object_parser_t ()
+{
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_quit = true;
+  }
+  m_cv.notify_all ();
+  m_thread.join ();
+}
+
+void
+code_object_parser_t::enqueue (code_object_t &code_object)
+{
+  agent_assert (code_object.is_open () && "code object is not opened");
+
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_queue.emplace_back (&code_object);
+  }
+  m_cv.notify_all ();
+}
+
+void
+code_object_parser_t::cancel (code_object_t &code_object)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  m_queue.erase (std::remove (m_queue.begin (), m_queue.end (), &code_object),
+                 m_queue.end ());
+  m_cv.wait (lock, [&] () { return m_current != &code_object; });
+}
+
+void
+code_object_parser_t::pause ()
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  m_paused = true;
+  m_cv.wait (lock, [this] () { return m_current == nullptr; });
+}
+
+void
+code_object_parser_t::resume ()
+{
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_paused = false;
+  }
+  m_cv.notify_all ();
+}
+
+void
+code_object_parser_t::worker ()
+{
+  /* Parsing is not urgent, so let the application's threads run first.  On
+     Linux, the nice value is a per-thread attribute, and 0 designates the
+     calling thread.  */
+  if (::setpriority (PRIO_PROCESS, 0, 19) == -1)
+    agent_warning ("could not lower the parser thread priority: %s",
+                   strerror (errno));
+
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (true)
+    {
+      m_cv.wait (lock, [this] () {
+        return m_quit || (!m_paused && !m_queue.empty ());
+      });
+
+      if (m_quit)
+        break;
+
+      m_current = m_queue.front ();
+      m_queue.pop_front ();
+
+      lock.unlock ();
+      m_current->parse ();
+      lock.lock ();
+
+      m_current = nullptr;
+      m_cv.notify_all ();
+    }
+}
+
+code_object_registry_t::code_object_registry_t (
+    amd_dbgapi_process_id_t process_id,
+    std::optional<std::string> save_directory, bool background_parsing)
+    : m_process_id (process_id), m_save_directory (std::move (save_directory))
+{
+  if (background_parsing)
+    m_parser.emplace ();
+}
+
+void
+code_object_registry_t::update ()
+{
+  amd_dbgapi_code_object_id_t *code_object_ids;
+  size_t code_object_count;
+  amd_dbgapi_changed_t changed;
+  count_dbgapi_call ();
+  if (amd_dbgapi_process_code_object_list (m_process_id, &code_object_count,
+                                           &code_object_ids, &changed)
+      != AMD_DBGAPI_STATUS_SUCCESS)
+    agent_error ("could not get the process' code object list");
+
+  /* The list is only returned if it has changed since the last update.  */
+  if (changed == AMD_DBGAPI_CHANGED_NO)
+    return;
+
+  std::unordered_set<decltype (amd_dbgapi_code_object_id_t::handle)> loaded;
+  std::vector<code_object_t *> new_code_objects;
+  for (size_t i = 0; i < code_object_count; ++i)
+    {
+      amd_dbgapi_code_object_id_t code_object_id = code_object_ids[i];
+
+      if (auto [it, inserted] = m_code_objects.try_emplace (
+              code_object_id.handle, code_object_id);
+          inserted)
+        {
+          agent_log (log_level_t::info, "code_object_%ld loaded",
+                     code_object_id.handle);
+          new_code_objects.emplace_back (&it->second);
+        }
+
+      loaded.emplace (code_object_id.handle);
+    }
+  free (code_object_ids);
+
+  /* Release the code objects that are no longer loaded.  */
+  for (auto it = m_code_objects.begin (); it != m_code_objects.end ();)
+    {
+      if (loaded.find (it->first) != loaded.end ())
+        {
+          ++it;
+          continue;
+        }
+
+      agent_log (log_level_t::info, "code_object_%ld unloaded", it->first);
+
+      if (m_parser)
+        m_parser->cancel (it->second);
+
+      if (auto address_it
+          = m_address_map.find (it->second.load_address ());
+          address_it != m_address_map.end ()
+          && address_it->second == &it->second)
+        m_address_map.erase (address_it);
+
+      it = m_code_objects.erase (it);
+    }
+
+  /* Open the new code objects once the unloaded ones are released, as they
+     may be loaded at the same addresses.  Opening a code object may need
+     dbgapi, so it must be done on this thread.  Only the parsing is done in
+     the background.  */
+  if (m_parser)
+    for (code_object_t *code_object : new_code_objects)
+      if (open (*code_object))
+        m_parser->enqueue (*code_object);
+}
+
+bool
+code_object_registry_t::open (code_object_t &code_object)
+{
+  code_object.open ();
+  if (!code_object.is_open ())
+    return false;
+
+  if (m_save_directory && !code_object.save (*m_save_directory))
+    agent_warning ("could not save code object to %s",
+                   m_save_directory->c_str ());
+
+  m_address_map.insert_or_assign (code_object.load_address (), &code_object);
+  return true;
+}
+
+void
+code_object_registry_t::open_all ()
+{
+  for (auto &&[handle, code_object] : m_code_objects)
+    if (!code_object.is_open () && !open (code_object))
+      agent_warning ("could not open code_object_%ld", handle);
+}
+
+code_object_t *
+code_object_registry_t::find (amd_dbgapi_global_address_t address)
+{
+  if (auto it = m_address_map.upper_bound (address);
+      it != m_address_map.begin ())
+    if (auto [load_address, code_object] = *std::prev (it);
+        (address - load_address) <= code_object->mem_size ())
+      return code_object;
+
+  return nullptr;
+}
+
 } /* namespace amd::debug_agent */
@@ -31,71 +31,353 @@
 #ifndef _ROCM_DEBUG_AGENT_CODE_OBJECT_H
 #define _ROCM_DEBUG_AGENT_CODE_OBJECT_H 1
 
+#include "line_table.h"
+#include "symbol_table.h"
+
 #include <amd-dbgapi/amd-dbgapi.h>
 
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <utility>
+#include <vector>
+
+struct Elf;
+struct Dwarf;
 
 namespace amd::debug_agent
 {
 
 class code_object_t
 {
+public:
+  /* Read up to *SIZE bytes of memory at ADDRESS into BUFFER, and set *SIZE
+     to the number of bytes read.  Return false if no memory could be
+     read.  */
+  using memory_reader_t = std::function<bool (
+      amd_dbgapi_global_address_t address, void *buffer,
+      amd_dbgapi_size_t *size)>;
+
+  /* An instruction of a disassembly.  */
+  struct instruction_t
+  {
+    amd_dbgapi_global_address_t m_address;
+    amd_dbgapi_size_t m_size;
+    std::string m_text;
+    /* The source location of the instruction, if the line table has one.
+       The file name remains valid for the lifetime of the code object.  */
+    std::optional<std::string_view> m_file_name;
+    size_t m_line{ 0 };
+  };
+
 private:
   struct symbol_info_t
   {
-    const std::string m_name;
+    /* The demangled symbol name.  It remains valid for the lifetime of the
+       code object.  */
+    std::string_view m_name;
     amd_dbgapi_global_address_t m_value;
     amd_dbgapi_size_t m_size;
   };
 
   void load_symbol_map ();
+
+  /* Build the index of the compilation units' address ranges.  The line
+     programs are not decoded.  */
+  void load_compilation_units ();
+
+  /* Decode the line program of compilation unit CU_INDEX, and insert its
+     rows into the line table.  */
+  void load_line_table (size_t cu_index);
+
+  /* Load the line tables of all compilation units.  */
   void load_debug_info ();
 
+  /* Load only the line tables of the compilation units that may contain
+     PC.  */
+  void load_debug_info (amd_dbgapi_global_address_t pc);
+
+  /* Check that IMAGE is an ELF image, and compute the code object's memory
+     size.  Return false if the image is not valid.  */
+  bool set_image (char *image, size_t image_size);
+
+  /* Release the code object's image.  */
+  void close ();
+
+  /* The addresses of the instructions disassembled around a pc.  */
+  struct disassembly_range_t
+  {
+    /* The start of the line table block containing m_start_pc.  */
+    amd_dbgapi_global_address_t m_line_start_pc;
+    /* The first instruction, and the end of the last instruction.  */
+    amd_dbgapi_global_address_t m_start_pc;
+    amd_dbgapi_global_address_t m_end_pc;
+  };
+
+  disassembly_range_t
+  disassembly_range (amd_dbgapi_architecture_id_t architecture_id,
+                     amd_dbgapi_global_address_t pc,
+                     const memory_reader_t &read_memory);
+
+  /* Return the text of the instruction at ADDRESS, whose bytes are in
+     BUFFER, and set *SIZE to its size.  */
+  std::string
+  disassemble_instruction (amd_dbgapi_architecture_id_t architecture_id,
+                           amd_dbgapi_global_address_t address,
+                           const uint8_t *buffer, amd_dbgapi_size_t *size);
+
+  /* Return a reader of the memory of the process the code object is loaded
+     in.  */
+  memory_reader_t process_memory_reader () const;
+
 public:
   code_object_t (amd_dbgapi_code_object_id_t code_object_id);
-  code_object_t (code_object_t &&rhs);
+
+  /* Create a code object that is not loaded in a process, for use by the
+     snapshot decoder.  Only file:// URIs can be opened with open (), other
+     code objects must be given their image.  */
+  code_object_t (std::string uri, amd_dbgapi_global_address_t load_address);
+
+  /* The symbol and line tables, and the ELF and DWARF handles, point into
+     the image, so code objects are neither copied nor moved.  */
+  code_object_t (const code_object_t &) = delete;
+  code_object_t &operator= (const code_object_t &) = delete;
 
   ~code_object_t ();
 
   void open ();
-  bool is_open () const { return m_fd.has_value (); }
 
+  /* Open the code object with IMAGE instead of reading its URI.  */
+  void open (std::vector<char> image);
+
+  bool is_open () const { return m_image != nullptr; }
+
+  amd_dbgapi_code_object_id_t id () const { return m_code_object_id; }
+  const std::string &uri () const { return m_uri; }
   amd_dbgapi_global_address_t load_address () const { return m_load_address; }
   amd_dbgapi_size_t mem_size () const { return m_mem_size; }
 
+  /* The code object's ELF image.  */
+  std::string_view image () const { return { m_image, m_image_size }; }
+
+  /* Return true if the image is mapped from the file named by the URI, so
+     that it can be found again after the process exits.  */
+  bool is_file_backed () const { return m_mapping != nullptr; }
+
+  /* Return the snapshot_hash of the image.  */
+  uint64_t content_hash ();
+
+  /* Read the memory at ADDRESS of the loaded code object from its image.
+     Only the bytes backed by the file's PT_LOAD segments can be read.  */
+  bool read_image_memory (amd_dbgapi_global_address_t address, void *buffer,
+                          amd_dbgapi_size_t *size) const;
+
+  /* Load the symbol and line tables now instead of when they are first
+     needed.  This does not call into dbgapi, so it is safe to call from a
+     thread other than the one owning the code object, as long as the owner
+     does not use the code object concurrently.  */
+  void parse ()
+  {
+    load_symbol_map ();
+    load_debug_info ();
+  }
+
   std::optional<symbol_info_t>
   find_symbol (amd_dbgapi_global_address_t address);
 
+  /* Return the [start, end) address ranges of the code generated for LINE
+     in FILE_NAME, sorted by address.  FILE_NAME must be spelled as in the
+     line table.  */
+  std::vector<
+      std::pair<amd_dbgapi_global_address_t, amd_dbgapi_global_address_t>>
+  find_line_address_ranges (const std::string &file_name, size_t line);
+
+  /* Print the instructions around PC, read from the process' memory.  */
   void disassemble (amd_dbgapi_architecture_id_t architecture_id,
                     amd_dbgapi_global_address_t pc);
 
+  /* Print the instructions around PC, read with READ_MEMORY.  */
+  void disassemble (amd_dbgapi_architecture_id_t architecture_id,
+                    amd_dbgapi_global_address_t pc,
+                    const memory_reader_t &read_memory);
+
+  /* Return the instructions printed by disassemble around PC, with their
+     source locations.  The instructions end at the first address that
+     cannot be read.  */
+  std::vector<instruction_t>
+  instructions (amd_dbgapi_architecture_id_t architecture_id,
+                amd_dbgapi_global_address_t pc)
+  {
+    return instructions (architecture_id, pc, process_memory_reader ());
+  }
+
+  std::vector<instruction_t>
+  instructions (amd_dbgapi_architecture_id_t architecture_id,
+                amd_dbgapi_global_address_t pc,
+                const memory_reader_t &read_memory);
+
   bool save (const std::string &directory) const;
 
 private:
   amd_dbgapi_global_address_t m_load_address{ 0 };
   amd_dbgapi_size_t m_mem_size{ 0 };
-  std::optional<int> m_fd;
 
-  std::optional<
-      std::map<amd_dbgapi_global_address_t, std::pair<std::string, size_t>>>
-      m_line_number_map;
+  /* The code object's ELF image.  It points into m_mapping for the file://
+     URIs of the files mapped, and into m_buffer for the other URIs.  */
+  char *m_image{ nullptr };
+  size_t m_image_size{ 0 };
 
-  std::optional<
-      std::map<amd_dbgapi_global_address_t, amd_dbgapi_global_address_t>>
-      m_pc_ranges_map;
+  void *m_mapping{ nullptr };
+  size_t m_mapping_size{ 0 };
+  std::vector<char> m_buffer;
+
+  /* The ELF and DWARF handles are kept open once the compilation units are
+     indexed, so that line programs can be decoded on demand.  */
+  Elf *m_elf{ nullptr };
+  Dwarf *m_dwarf{ nullptr };
 
+  struct compilation_unit_t
+  {
+    /* The offset of the compilation unit's DIE in .debug_info.  */
+    uint64_t m_die_offset;
+    /* True if the compilation unit has address ranges in m_pc_ranges_map.  */
+    bool m_has_ranges{ false };
+    bool m_line_table_loaded{ false };
+  };
+
+  std::vector<compilation_unit_t> m_compilation_units;
+
+  /* The line table rows of the compilation units loaded so far.  */
+  std::optional<line_table_t> m_line_table;
+
+  /* Map the low pc of each compilation unit address range to its high pc,
+     and to the compilation unit's index in m_compilation_units.  */
   std::optional<std::map<amd_dbgapi_global_address_t,
-                         std::pair<std::string, amd_dbgapi_size_t>>>
-      m_symbol_map;
+                         std::pair<amd_dbgapi_global_address_t, size_t>>>
+      m_pc_ranges_map;
+
+  std::optional<symbol_table_t> m_symbol_table;
+
+  /* The demangled symbol names, indexed like the symbol table, and filled
+     lazily by find_symbol.  A null view is a name not demangled yet.  The
+     names returned by abi::__cxa_demangle are owned by
+     m_demangled_name_storage, other entries point into the symbol table.  */
+  std::vector<std::string_view> m_demangled_names;
+  std::vector<std::unique_ptr<char, void (*) (void *)>>
+      m_demangled_name_storage;
+
+  std::optional<uint64_t> m_content_hash;
 
   std::string m_uri;
   amd_dbgapi_code_object_id_t const m_code_object_id;
 };
 
+/* A low priority thread that parses the symbol and line tables of the code
+   objects queued to it.  */
+class code_object_parser_t
+{
+public:
+  code_object_parser_t ();
+  ~code_object_parser_t ();
+
+  code_object_parser_t (const code_object_parser_t &) = delete;
+  code_object_parser_t &operator= (const code_object_parser_t &) = delete;
+
+  /* Queue CODE_OBJECT to be parsed.  CODE_OBJECT must be opened.  */
+  void enqueue (code_object_t &code_object);
+
+  /* Remove CODE_OBJECT from the queue.  If it is being parsed, wait for the
+     parsing to complete.  */
+  void cancel (code_object_t &code_object);
+
+  /* Suspend parsing and wait for the code object being parsed, if any, to
+     complete.  The parser does not access any code object until resume is
+     called.  */
+  void pause ();
+  void resume ();
+
+private:
+  void worker ();
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::deque<code_object_t *> m_queue;
+  code_object_t *m_current{ nullptr };
+  bool m_paused{ false };
+  bool m_quit{ false };
+  std::thread m_thread;
+};
+
+/* The set of code objects loaded in a process.  The registry lives for the
+   lifetime of the process so that code objects, and the symbol and line
+   tables parsed from them, are reused across reports.  */
+class code_object_registry_t
+{
+public:
+  /* If BACKGROUND_PARSING is true, code objects are opened as soon as they
+     are loaded, and their symbol and line tables are parsed by a background
+     thread.  If SAVE_DIRECTORY is set, code objects are saved in it when they
+     are opened.  */
+  code_object_registry_t (amd_dbgapi_process_id_t process_id,
+                          std::optional<std::string> save_directory,
+                          bool background_parsing);
+
+  code_object_registry_t (const code_object_registry_t &) = delete;
+  code_object_registry_t &operator= (const code_object_registry_t &) = delete;
+
+  /* Synchronize the registry with the process' code object list.  Newly
+     loaded code objects are registered, and unloaded code objects are
+     released.  */
+  void update ();
+
+  /* Open all registered code objects that are not already opened.  */
+  void open_all ();
+
+  /* Return the opened code object that contains ADDRESS, or nullptr.  */
+  code_object_t *find (amd_dbgapi_global_address_t address);
+
+  /* Give the caller exclusive access to the registered code objects by
+     suspending background parsing.  */
+  void lock ()
+  {
+    if (m_parser)
+      m_parser->pause ();
+  }
+
+  void unlock ()
+  {
+    if (m_parser)
+      m_parser->resume ();
+  }
+
+private:
+  bool open (code_object_t &code_object);
+
+  amd_dbgapi_process_id_t const m_process_id;
+  std::optional<std::string> const m_save_directory;
+
+  std::unordered_map<decltype (amd_dbgapi_code_object_id_t::handle),
+                     code_object_t>
+      m_code_objects;
+
+  /* Opened code objects sorted by load address.  */
+  std::map<amd_dbgapi_global_address_t, code_object_t *> m_address_map;
+
+  /* Declared last so that the parser thread is stopped before the code
+     objects it may be accessing are destroyed.  */
+  std::optional<code_object_parser_t> m_parser;
+};
+
 } /* namespace amd::debug_agent */
 
 #endif /* _ROCM_DEBUG_AGENT_CODE_OBJECT_H */
@@ -0,0 +1,175 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#include "command_queue.h"
+#include "debug.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <thread>
+
+namespace amd::debug_agent
+{
+
+void
+command_completion_t::complete ()
+{
+  /* Notify while holding the lock: the waiter may destroy this object as
+     soon as it sees m_completed set.  */
+  std::lock_guard<std::mutex> lock (m_mutex);
+  m_completed = true;
+  m_cv.notify_all ();
+}
+
+void
+command_completion_t::wait ()
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  m_cv.wait (lock, [this] () { return m_completed; });
+}
+
+command_queue_t::command_queue_t ()
+{
+  for (size_t i = 0; i < capacity; ++i)
+    m_slots[i].m_sequence.store (i, std::memory_order_relaxed);
+
+  m_doorbell_fd = eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (m_doorbell_fd == -1)
+    agent_error ("failed to create eventfd: %s", strerror (errno));
+}
+
+command_queue_t::~command_queue_t () { close (m_doorbell_fd); }
+
+bool
+command_queue_t::try_enqueue (const worker_command_t &command)
+{
+  size_t position = m_push_position.load (std::memory_order_relaxed);
+
+  while (true)
+    {
+      slot_t &slot = m_slots[position % capacity];
+      size_t sequence = slot.m_sequence.load (std::memory_order_acquire);
+      auto difference = static_cast<std::ptrdiff_t> (sequence - position);
+
+      if (difference == 0)
+        {
+          /* The slot is free: claim the position, then fill the slot.  */
+          if (m_push_position.compare_exchange_weak (
+                  position, position + 1, std::memory_order_relaxed))
+            {
+              slot.m_command = command;
+              slot.m_sequence.store (position + 1, std::memory_order_release);
+              return true;
+            }
+        }
+      else if (difference < 0)
+        {
+          /* The slot still holds the command pushed one lap earlier.  */
+          return false;
+        }
+      else
+        {
+          /* Another producer claimed this position.  */
+          position = m_push_position.load (std::memory_order_relaxed);
+        }
+    }
+}
+
+void
+command_queue_t::ring ()
+{
+  if (m_rung.exchange (true))
+    return;
+
+  uint64_t value = 1;
+  while (write (m_doorbell_fd, &value, sizeof (value)) == -1)
+    if (errno != EINTR)
+      agent_error ("failed to ring the worker thread's doorbell: %s",
+                   strerror (errno));
+}
+
+void
+command_queue_t::push (const worker_command_t &command)
+{
+  while (!try_enqueue (command))
+    {
+      /* Make sure the worker thread is awake to empty the queue.  */
+      ring ();
+      std::this_thread::yield ();
+    }
+
+  ring ();
+}
+
+bool
+command_queue_t::try_push (const worker_command_t &command)
+{
+  if (!try_enqueue (command))
+    return false;
+
+  ring ();
+  return true;
+}
+
+void
+command_queue_t::acknowledge ()
+{
+  uint64_t value;
+  while (read (m_doorbell_fd, &value, sizeof (value)) == -1 && errno == EINTR)
+    ;
+
+  /* Clear the flag before popping, so that a command pushed after the last
+     pop rings the doorbell again.  This is an exchange, not a store, so that
+     it synchronizes with the producers that found the doorbell already rung:
+     their commands are visible to the pops that follow.  */
+  m_rung.exchange (false);
+}
+
+bool
+command_queue_t::pop (worker_command_t &command)
+{
+  slot_t &slot = m_slots[m_pop_position % capacity];
+  size_t sequence = slot.m_sequence.load (std::memory_order_acquire);
+
+  /* The queue is empty, or the producer that claimed this position is still
+     filling the slot.  That producer rings the doorbell once it is done.  */
+  if (sequence != m_pop_position + 1)
+    return false;
+
+  command = slot.m_command;
+  slot.m_sequence.store (m_pop_position + capacity, std::memory_order_release);
+  ++m_pop_position;
+  return true;
+}
+
+} /* namespace amd::debug_agent */
@@ -0,0 +1,153 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#ifndef _ROCM_DEBUG_AGENT_COMMAND_QUEUE_H
+#define _ROCM_DEBUG_AGENT_COMMAND_QUEUE_H 1
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace amd::debug_agent
+{
+
+/* Signaled by the worker thread once it executed a command.  */
+class command_completion_t
+{
+public:
+  void complete ();
+  void wait ();
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_completed{ false };
+};
+
+/* A command sent to the worker thread.  */
+struct worker_command_t
+{
+  enum class kind_t : uint8_t
+  {
+    /* Print the wavefronts of the process.  */
+    print_waves,
+    /* Report to dbgapi that the process' code object list changed.  */
+    update_code_object_list,
+    /* Detach from the process and exit the worker thread.  */
+    quit
+  };
+
+  kind_t m_kind;
+
+  /* For print_waves: stop and print all the wavefronts, not only the ones
+     that are already stopped.  */
+  bool m_all_wavefronts{ false };
+
+  /* If not null, completed when the command has been executed.  */
+  command_completion_t *m_completion{ nullptr };
+
+  /* For print_waves: print a blank line before the report, after the ^\
+     echoed by the terminal.  Writing to agent_out is not async-signal-safe,
+     so the SIGQUIT handler leaves it to the worker thread.  */
+  bool m_blank_line{ false };
+};
+
+/* A bounded queue of commands sent to the worker thread by any number of
+   threads.  Commands are pushed without taking a lock, and the worker thread
+   is woken through an eventfd doorbell, which it can wait for with epoll.
+   The doorbell is only rung once until the worker thread acknowledges it, so
+   a batch of commands costs one system call.  */
+class command_queue_t
+{
+public:
+  command_queue_t ();
+  ~command_queue_t ();
+
+  command_queue_t (const command_queue_t &) = delete;
+  command_queue_t &operator= (const command_queue_t &) = delete;
+
+  /* The file descriptor that becomes readable when commands are pushed.  */
+  int doorbell_fd () const { return m_doorbell_fd; }
+
+  /* Push COMMAND, and ring the doorbell.  If the queue is full, wait for the
+     worker thread to make room.  */
+  void push (const worker_command_t &command);
+
+  /* Push COMMAND, and ring the doorbell.  Return false without waiting if
+     the queue is full.  Async-signal-safe, even if the signal interrupted a
+     push on the same thread.  */
+  bool try_push (const worker_command_t &command);
+
+  /* Ring the doorbell without pushing a command, to have the worker thread
+     check a request left in a flag.  Async-signal-safe.  */
+  void ring ();
+
+  /* Called by the worker thread when the doorbell is readable, before
+     popping the commands.  The commands pushed after this call ring the
+     doorbell again.  */
+  void acknowledge ();
+
+  /* Pop the oldest command into COMMAND.  Return false if there is none.
+     Only called by the worker thread.  */
+  bool pop (worker_command_t &command);
+
+private:
+  bool try_enqueue (const worker_command_t &command);
+
+  static constexpr size_t capacity = 256;
+
+  /* The slots of the ring.  A slot's sequence number tells which position
+     may use it next: it is the position when the slot is free, and the
+     position plus one when the slot holds that position's command.  */
+  struct slot_t
+  {
+    std::atomic<size_t> m_sequence;
+    worker_command_t m_command;
+  };
+
+  std::array<slot_t, capacity> m_slots;
+
+  /* The next position to push to, shared by the producers, and the next
+     position to pop from, owned by the worker thread.  They are on separate
+     cache lines so that the producers do not slow down the consumer.  */
+  alignas (64) std::atomic<size_t> m_push_position{ 0 };
+  alignas (64) size_t m_pop_position{ 0 };
+
+  /* True if the doorbell was rung and not yet acknowledged.  */
+  std::atomic<bool> m_rung{ false };
+  int m_doorbell_fd{ -1 };
+};
+
+} /* namespace amd::debug_agent */
+
+#endif /* _ROCM_DEBUG_AGENT_COMMAND_QUEUE_H */
@@ -45,6 +45,7 @@ namespace amd::debug_agent
   do                                                                          \
     {                                                                         \
       agent_log (log_level_t::error, format, ##__VA_ARGS__);                  \
+      amd::debug_agent::flush_agent_out ();                                   \
       abort ();                                                               \
     }                                                                         \
   while (false)
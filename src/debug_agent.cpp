@@ -29,8 +29,14 @@
    DEALINGS WITH THE SOFTWARE.  */
 
 #include "code_object.h"
+#include "command_queue.h"
 #include "debug.h"
+#include "json_writer.h"
 #include "logging.h"
+#include "report_format.h"
+#include "report_stats.h"
+#include "snapshot.h"
+#include "trace.h"
 
 #include <amd-dbgapi/amd-dbgapi.h>
 #include <hsa/hsa.h>
@@ -40,6 +46,7 @@
 #include <dlfcn.h>
 #include <fcntl.h>
 #include <getopt.h>
+#include <poll.h>
 #include <signal.h>
 #include <string.h>
 #include <sys/epoll.h>
@@ -47,13 +54,16 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <cstdlib>
-#include <future>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <link.h>
 #include <map>
 #include <memory>
@@ -61,15 +71,18 @@
 #include <optional>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #define DBGAPI_CHECK(expr)                                                    \
   do                                                                          \
     {                                                                         \
+      count_dbgapi_call ();                                                   \
       if (amd_dbgapi_status_t status = (expr);                                \
           status != AMD_DBGAPI_STATUS_SUCCESS)                                \
         agent_error ("%s:%d: %s failed (rc=%d)", __FILE__, __LINE__, #expr,   \
@@ -86,14 +99,62 @@ namespace
 std::optional<std::string> g_code_objects_dir;
 bool g_all_wavefronts{ false };
 bool g_precise_emmory{ false };
+bool g_preparse_code_objects{ false };
+std::optional<std::string> g_snapshot_path;
+
+enum class output_format_t
+{
+  /* Human readable text.  */
+  text,
+  /* Newline-delimited JSON: one JSON object per line for each report,
+     wavefront, code object and disassembled instruction.  */
+  ndjson
+};
+
+/* Options controlling how print_wavefronts reports the wavefronts.  */
+struct report_options_t
+{
+  output_format_t m_format{ output_format_t::text };
+
+  /* Collapse repeated local memory rows and uniform vector registers.  */
+  bool m_compact{ false };
+
+  /* If set, group the wavefronts by dispatch, pc and stop reason, and only
+     print the registers and local memory of this many wavefronts per
+     group.  */
+  std::optional<size_t> m_aggregate_waves;
+
+  /* If set, how long to wait for the wavefronts to stop before printing the
+     ones that did.  By default, wait until they all stop.  */
+  std::optional<std::chrono::milliseconds> m_stop_timeout;
+
+  /* Print the time and the work spent in each phase of a report after the
+     report.  */
+  bool m_stats{ false };
+};
+
+report_options_t g_report_options;
+
+/* Set by the SIGQUIT handler when it cannot push its print_waves command
+   because the command queue is full.  The worker thread then prints the
+   wavefronts once it has executed the commands in the queue.  */
+std::atomic<bool> g_print_waves_pending{ false };
+
+/* Values returned by getopt_long for the options that have no short form.  */
+enum : int
+{
+  option_preparse_code_objects = 256,
+  option_aggregate_waves,
+  option_compact,
+  option_snapshot,
+  option_format,
+  option_stop_timeout,
+  option_stats,
+  option_trace,
+};
 
 /* Global state accessed by the dbgapi callbacks.  */
 std::optional<amd_dbgapi_breakpoint_id_t> g_rbrk_breakpoint_id;
-struct
-{
-  std::atomic<bool> guard;
-  std::optional<std::promise<void>> promise;
-} g_rbrk_sync;
 
 amd_dbgapi_status_t
 amd_dbgapi_client_process_get_info (
@@ -192,290 +253,467 @@ static amd_dbgapi_callbacks_t dbgapi_callbacks = {
   /* log_message callback.  */
   .log_message =
       [] (amd_dbgapi_log_level_t level, const char *message) {
-        agent_out << "rocm-dbgapi: " << message << std::endl;
+        log_level_t agent_level = log_level_t::verbose;
+        if (level == AMD_DBGAPI_LOG_LEVEL_FATAL_ERROR)
+          agent_level = log_level_t::error;
+        else if (level == AMD_DBGAPI_LOG_LEVEL_WARNING)
+          agent_level = log_level_t::warning;
+        else if (level == AMD_DBGAPI_LOG_LEVEL_INFO)
+          agent_level = log_level_t::info;
+
+        write_log_message ("rocm-dbgapi", agent_level, message);
       }
 };
 
-std::string
-hex_string (const std::vector<uint8_t> &value)
+/* Register information that does not change for a given architecture.  */
+struct register_info_t
+{
+  std::string m_name;
+  std::string m_type;
+  size_t m_size;
+  /* The element counts of the register's vector type, starting with the
+     outermost.  For example, "int32_t[64]" is { 64 }.  The element count of
+     a scalar type is empty.  */
+  std::vector<size_t> m_vector_dimensions;
+  /* The index in architecture_registers_t::m_class_ids of the register class
+     under which the register is printed, if it is a member of any.  */
+  std::optional<size_t> m_class_index;
+};
+
+/* The name, register classes and registers of an architecture.  */
+struct architecture_registers_t
 {
-  std::string value_string;
-  value_string.reserve (2 * value.size ());
+  std::string m_name;
+  uint32_t m_elf_amdgpu_machine;
+  amd_dbgapi_size_t m_largest_instruction_size;
+
+  /* The register classes, in the order they are printed.  */
+  std::vector<amd_dbgapi_register_class_id_t> m_class_ids;
+  std::vector<std::string> m_class_names;
+
+  /* The registers seen so far, by register id.  */
+  std::unordered_map<decltype (amd_dbgapi_register_id_t::handle),
+                     register_info_t>
+      m_registers;
+};
+
+architecture_registers_t
+get_architecture_registers (amd_dbgapi_architecture_id_t architecture_id)
+{
+  architecture_registers_t registers;
+
+  char *architecture_name;
+  DBGAPI_CHECK (amd_dbgapi_architecture_get_info (
+      architecture_id, AMD_DBGAPI_ARCHITECTURE_INFO_NAME,
+      sizeof (architecture_name), &architecture_name));
+  registers.m_name.assign (architecture_name);
+  free (architecture_name);
+
+  DBGAPI_CHECK (amd_dbgapi_architecture_get_info (
+      architecture_id, AMD_DBGAPI_ARCHITECTURE_INFO_ELF_AMDGPU_MACHINE,
+      sizeof (registers.m_elf_amdgpu_machine),
+      &registers.m_elf_amdgpu_machine));
 
-  for (size_t pos = value.size (); pos > 0; --pos)
+  DBGAPI_CHECK (amd_dbgapi_architecture_get_info (
+      architecture_id, AMD_DBGAPI_ARCHITECTURE_INFO_LARGEST_INSTRUCTION_SIZE,
+      sizeof (registers.m_largest_instruction_size),
+      &registers.m_largest_instruction_size));
+
+  size_t class_count;
+  amd_dbgapi_register_class_id_t *register_class_ids;
+  DBGAPI_CHECK (amd_dbgapi_architecture_register_class_list (
+      architecture_id, &class_count, &register_class_ids));
+
+  for (size_t i = 0; i < class_count; ++i)
     {
-      static constexpr char hex_digits[] = "0123456789abcdef";
-      value_string.push_back (hex_digits[value[pos - 1] >> 4]);
-      value_string.push_back (hex_digits[value[pos - 1] & 0xF]);
+      char *class_name_;
+      DBGAPI_CHECK (amd_dbgapi_architecture_register_class_get_info (
+          register_class_ids[i], AMD_DBGAPI_REGISTER_CLASS_INFO_NAME,
+          sizeof (class_name_), &class_name_));
+      registers.m_class_names.emplace_back (class_name_);
+      free (class_name_);
+
+      registers.m_class_ids.emplace_back (register_class_ids[i]);
     }
 
-  return value_string;
+  free (register_class_ids);
+
+  /* Always print the "general" register class last.  */
+  if (auto it = std::find (registers.m_class_names.begin (),
+                           registers.m_class_names.end (), "general");
+      it != registers.m_class_names.end ())
+    {
+      size_t general = it - registers.m_class_names.begin ();
+      std::swap (registers.m_class_names[general],
+                 registers.m_class_names.back ());
+      std::swap (registers.m_class_ids[general],
+                 registers.m_class_ids.back ());
+    }
+
+  return registers;
 }
 
-std::string
-register_value_string (const std::string &register_type,
-                       const std::vector<uint8_t> &register_value)
+const register_info_t &
+get_register_info (architecture_registers_t &registers,
+                   amd_dbgapi_register_id_t register_id)
 {
-  /* handle vector types..  */
-  if (size_t pos = register_type.find_last_of ('['); pos != std::string::npos)
+  auto [it, inserted] = registers.m_registers.try_emplace (register_id.handle);
+  register_info_t &info = it->second;
+
+  if (!inserted)
+    return info;
+
+  char *register_name_;
+  DBGAPI_CHECK (amd_dbgapi_register_get_info (
+      register_id, AMD_DBGAPI_REGISTER_INFO_NAME, sizeof (register_name_),
+      &register_name_));
+  info.m_name.assign (register_name_);
+  free (register_name_);
+
+  char *register_type_;
+  DBGAPI_CHECK (amd_dbgapi_register_get_info (
+      register_id, AMD_DBGAPI_REGISTER_INFO_TYPE, sizeof (register_type_),
+      &register_type_));
+  info.m_type.assign (register_type_);
+  free (register_type_);
+
+  info.m_vector_dimensions = parse_register_type (info.m_type);
+
+  DBGAPI_CHECK (amd_dbgapi_register_get_info (
+      register_id, AMD_DBGAPI_REGISTER_INFO_SIZE, sizeof (info.m_size),
+      &info.m_size));
+
+  /* A register is printed as part of the first register class it is a
+     member of.  */
+  for (size_t i = 0; i < registers.m_class_ids.size (); ++i)
     {
-      const std::string element_type = register_type.substr (0, pos);
-      const size_t element_count = std::stoi (register_type.substr (pos + 1));
-      const size_t element_size = register_value.size () / element_count;
+      amd_dbgapi_register_class_state_t state;
+      DBGAPI_CHECK (amd_dbgapi_register_is_in_register_class (
+          registers.m_class_ids[i], register_id, &state));
 
-      agent_assert ((register_value.size () % element_size) == 0);
-
-      std::stringstream ss;
-      for (size_t i = 0; i < element_count; ++i)
+      if (state == AMD_DBGAPI_REGISTER_CLASS_STATE_MEMBER)
         {
-          if (i != 0)
-            ss << " ";
-          ss << "[" << i << "] ";
-
-          std::vector<uint8_t> element_value (
-              &register_value[element_size * i],
-              &register_value[element_size * (i + 1)]);
-
-          ss << register_value_string (element_type, element_value);
+          info.m_class_index.emplace (i);
+          break;
         }
-      return ss.str ();
     }
 
-  return hex_string (register_value);
+  return info;
 }
 
-void
-print_registers (amd_dbgapi_wave_id_t wave_id)
+/* Return the register classes and registers of ARCHITECTURE_ID.  They are
+   cached across reports.  */
+architecture_registers_t &
+get_cached_architecture_registers (
+    amd_dbgapi_architecture_id_t architecture_id)
 {
-  amd_dbgapi_architecture_id_t architecture_id;
-  DBGAPI_CHECK (
-      amd_dbgapi_wave_get_info (wave_id, AMD_DBGAPI_WAVE_INFO_ARCHITECTURE,
-                                sizeof (architecture_id), &architecture_id));
+  static std::unordered_map<decltype (amd_dbgapi_architecture_id_t::handle),
+                            architecture_registers_t>
+      architectures;
+
+  auto it = architectures.find (architecture_id.handle);
+  if (it == architectures.end ())
+    it = architectures
+             .emplace (architecture_id.handle,
+                       get_architecture_registers (architecture_id))
+             .first;
+
+  return it->second;
+}
 
-  size_t class_count;
-  amd_dbgapi_register_class_id_t *register_class_ids;
-  DBGAPI_CHECK (amd_dbgapi_architecture_register_class_list (
-      architecture_id, &class_count, &register_class_ids));
+/* The registers of a wave, grouped by the register class they are printed
+   under, in the wave's register list order.  */
+using class_registers_t = std::vector<std::vector<
+    std::pair<amd_dbgapi_register_id_t, const register_info_t *>>>;
 
+class_registers_t
+get_class_registers (amd_dbgapi_wave_id_t wave_id,
+                     architecture_registers_t &registers)
+{
   size_t register_count;
   amd_dbgapi_register_id_t *register_ids;
   DBGAPI_CHECK (
       amd_dbgapi_wave_register_list (wave_id, &register_count, &register_ids));
 
-  auto hash = [] (const amd_dbgapi_register_id_t &id) {
-    return std::hash<decltype (id.handle)>{}(id.handle);
-  };
-  auto equal_to = [] (const amd_dbgapi_register_id_t &lhs,
-                      const amd_dbgapi_register_id_t &rhs) {
-    return std::equal_to<decltype (lhs.handle)>{}(lhs.handle, rhs.handle);
-  };
-  std::unordered_set<amd_dbgapi_register_id_t, decltype (hash),
-                     decltype (equal_to)>
-      printed_registers (0, hash, equal_to);
+  class_registers_t class_registers (registers.m_class_ids.size ());
 
-  for (size_t i = 0; i < class_count; ++i)
+  for (size_t i = 0; i < register_count; ++i)
     {
-      amd_dbgapi_register_class_id_t register_class_id = register_class_ids[i];
+      const register_info_t &info
+          = get_register_info (registers, register_ids[i]);
 
-      char *class_name_;
-      DBGAPI_CHECK (amd_dbgapi_architecture_register_class_get_info (
-          register_class_id, AMD_DBGAPI_REGISTER_CLASS_INFO_NAME,
-          sizeof (class_name_), &class_name_));
-      std::string class_name (class_name_);
-      free (class_name_);
+      if (info.m_class_index)
+        class_registers[*info.m_class_index].emplace_back (register_ids[i],
+                                                           &info);
+    }
 
-      /* Always print the "general" register class last.  */
-      if (class_name == "general" && i < (class_count - 1))
-        {
-          register_class_ids[i--] = register_class_ids[class_count - 1];
-          register_class_ids[class_count - 1] = register_class_id;
-          continue;
-        }
+  free (register_ids);
+  return class_registers;
+}
 
-      agent_out << std::endl << class_name << " registers:";
+/* The values of the registers of a wave, grouped by register class.  The
+   register_value_t of m_classes point into m_values.  */
+struct wave_registers_t
+{
+  std::vector<std::vector<uint8_t>> m_values;
+  std::vector<std::vector<register_value_t>> m_classes;
+};
 
-      size_t last_register_size = 0;
-      for (size_t j = 0, column = 0; j < register_count; ++j)
-        {
-          amd_dbgapi_register_id_t register_id = register_ids[j];
+wave_registers_t
+read_wave_registers (amd_dbgapi_wave_id_t wave_id,
+                     architecture_registers_t &registers)
+{
+  report_phase_timer_t timer (report_phase_t::registers);
 
-          /* Skip this register if is has already been printed as part of
-             another register class.  */
-          if (printed_registers.find (register_id) != printed_registers.end ())
-            continue;
+  class_registers_t class_registers = get_class_registers (wave_id, registers);
 
-          amd_dbgapi_register_class_state_t state;
-          DBGAPI_CHECK (amd_dbgapi_register_is_in_register_class (
-              register_class_id, register_id, &state));
+  size_t register_count = 0;
+  for (auto &&class_register_list : class_registers)
+    register_count += class_register_list.size ();
 
-          if (state != AMD_DBGAPI_REGISTER_CLASS_STATE_MEMBER)
-            continue;
+  wave_registers_t values;
+  values.m_values.resize (register_count);
+  values.m_classes.resize (class_registers.size ());
 
-          char *register_name_;
-          DBGAPI_CHECK (amd_dbgapi_register_get_info (
-              register_id, AMD_DBGAPI_REGISTER_INFO_NAME,
-              sizeof (register_name_), &register_name_));
-          std::string register_name (register_name_);
-          free (register_name_);
-
-          char *register_type_;
-          DBGAPI_CHECK (amd_dbgapi_register_get_info (
-              register_id, AMD_DBGAPI_REGISTER_INFO_TYPE,
-              sizeof (register_type_), &register_type_));
-          std::string register_type (register_type_);
-          free (register_type_);
-
-          size_t register_size;
-          DBGAPI_CHECK (amd_dbgapi_register_get_info (
-              register_id, AMD_DBGAPI_REGISTER_INFO_SIZE,
-              sizeof (register_size), &register_size));
-
-          std::vector<uint8_t> buffer (register_size);
-          DBGAPI_CHECK (amd_dbgapi_read_register (
-              wave_id, register_id, 0, register_size, buffer.data ()));
-
-          const size_t num_register_per_line = 16 / register_size;
-
-          if (register_size > sizeof (uint64_t) /* Registers larger than a
-                                                   uint64_t are printed each
-                                                   on a separate line.  */
-              || register_size != last_register_size
-              || (column++ % num_register_per_line) == 0)
-            {
-              agent_out << std::endl;
-              column = 1;
-            }
+  size_t value_index = 0;
+  for (size_t i = 0; i < class_registers.size (); ++i)
+    for (auto [register_id, info] : class_registers[i])
+      {
+        std::vector<uint8_t> &value = values.m_values[value_index++];
 
-          last_register_size = register_size;
+        value.resize (info->m_size);
+        DBGAPI_CHECK (amd_dbgapi_read_register (wave_id, register_id, 0,
+                                                info->m_size, value.data ()));
+        count_bytes_read (info->m_size);
 
-          agent_out << std::right << std::setfill (' ') << std::setw (16)
-                    << (register_name + ": ")
-                    << register_value_string (register_type, buffer);
+        values.m_classes[i].emplace_back (register_value_t{
+            &info->m_name, &info->m_vector_dimensions, &value });
+      }
 
-          printed_registers.emplace (register_id);
-        }
+  return values;
+}
 
-      agent_out << std::endl;
-    }
+void
+print_registers (amd_dbgapi_wave_id_t wave_id,
+                 amd_dbgapi_architecture_id_t architecture_id, bool compact)
+{
+  architecture_registers_t &registers
+      = get_cached_architecture_registers (architecture_id);
+  wave_registers_t values = read_wave_registers (wave_id, registers);
 
-  free (register_ids);
-  free (register_class_ids);
+  for (size_t i = 0; i < registers.m_class_ids.size (); ++i)
+    print_register_class (registers.m_class_names[i], values.m_classes[i],
+                          compact);
 }
 
-void
-print_local_memory (amd_dbgapi_wave_id_t wave_id)
+/* Return the contents of the local memory of WAVE_ID.  The contents are empty
+   if the local memory cannot be read.  */
+std::vector<uint32_t>
+read_local_memory (amd_dbgapi_wave_id_t wave_id,
+                   amd_dbgapi_architecture_id_t architecture_id)
 {
   amd_dbgapi_process_id_t process_id;
   DBGAPI_CHECK (amd_dbgapi_wave_get_info (wave_id,
                                           AMD_DBGAPI_WAVE_INFO_PROCESS,
                                           sizeof (process_id), &process_id));
 
-  amd_dbgapi_architecture_id_t architecture_id;
-  DBGAPI_CHECK (
-      amd_dbgapi_wave_get_info (wave_id, AMD_DBGAPI_WAVE_INFO_ARCHITECTURE,
-                                sizeof (architecture_id), &architecture_id));
-
   amd_dbgapi_address_space_id_t local_address_space_id;
   DBGAPI_CHECK (amd_dbgapi_dwarf_address_space_to_address_space (
       architecture_id, 0x3 /* DW_ASPACE_AMDGPU_local */,
       &local_address_space_id));
 
-  std::vector<uint32_t> buffer (1024);
-  amd_dbgapi_segment_address_t base_address{ 0 };
+  constexpr size_t words_per_read = 1024;
+  std::vector<uint32_t> contents;
 
   while (true)
     {
-      size_t requested_size = buffer.size () * sizeof (buffer[0]);
+      const amd_dbgapi_segment_address_t base_address
+          = contents.size () * sizeof (contents[0]);
+      contents.resize (contents.size () + words_per_read);
+
+      size_t requested_size = words_per_read * sizeof (contents[0]);
       size_t size = requested_size;
-      if (amd_dbgapi_read_memory (process_id, wave_id, 0,
-                                  local_address_space_id, base_address, &size,
-                                  buffer.data ())
+      count_dbgapi_call ();
+      if (amd_dbgapi_read_memory (
+              process_id, wave_id, 0, local_address_space_id, base_address,
+              &size, &contents[base_address / sizeof (contents[0])])
           != AMD_DBGAPI_STATUS_SUCCESS)
+        size = 0;
+      count_bytes_read (size);
+
+      agent_assert ((size % sizeof (contents[0])) == 0);
+      contents.resize ((base_address + size) / sizeof (contents[0]));
+
+      if (size != requested_size)
         break;
+    }
 
-      agent_assert ((size % sizeof (buffer[0])) == 0);
-      buffer.resize (size / sizeof (buffer[0]));
+  return contents;
+}
 
-      if (!base_address)
-        agent_out << std::endl << "Local memory content:";
+/* Statistics of stop_all_wavefronts over the lifetime of the process.  They
+   are logged at the info level after each call.  */
+struct stop_all_statistics_t
+{
+  /* The number of calls, and the number of calls that timed out.  */
+  size_t m_calls{ 0 };
+  size_t m_timeouts{ 0 };
+  /* The number of scans of the process' wave list.  */
+  size_t m_iterations{ 0 };
+  /* The number of times the notifier was waited for.  */
+  size_t m_waits{ 0 };
+  size_t m_stop_requests{ 0 };
+};
 
-      for (size_t i = 0, column = 0; i < buffer.size (); ++i)
-        {
-          if ((column++ % 8) == 0)
-            {
-              agent_out << std::endl
-                        << "    0x" << std::setfill ('0') << std::setw (4)
-                        << (base_address + i * sizeof (buffer[0])) << ":";
-              column = 1;
-            }
+stop_all_statistics_t g_stop_all_statistics;
+
+/* The wavefronts that were sent a stop request by stop_all_wavefronts, but
+   had not stopped when it timed out.  Their requests are still outstanding:
+   the WAVE_STOP and WAVE_COMMAND_TERMINATED events they report later are not
+   new stops.  */
+std::unordered_set<decltype (amd_dbgapi_wave_id_t::handle)>
+    g_outstanding_stop_requests;
+
+/* Read all the bytes written to the dbgapi notifier pipe NOTIFIER.  */
+void
+drain_notifier (amd_dbgapi_notifier_t notifier)
+{
+  int r;
+  do
+    {
+      char buf;
+      r = read (notifier, &buf, 1);
+  } while (r >= 0 || (r == -1 && errno == EINTR));
+}
 
-          agent_out << " " << std::hex << std::setfill ('0') << std::setw (8)
-                    << buffer[i];
+/* Log the wavefronts of WAVE_HANDLES that were sent a stop request but did
+   not report that they stopped.  */
+void
+log_unstopped_wavefronts (
+    const std::unordered_set<decltype (amd_dbgapi_wave_id_t::handle)>
+        &wave_handles)
+{
+  for (auto &&handle : wave_handles)
+    {
+      amd_dbgapi_wave_id_t wave_id{ handle };
+
+      amd_dbgapi_wave_state_t state;
+      count_dbgapi_call ();
+      if (amd_dbgapi_wave_get_info (wave_id, AMD_DBGAPI_WAVE_INFO_STATE,
+                                    sizeof (state), &state)
+          != AMD_DBGAPI_STATUS_SUCCESS)
+        {
+          agent_warning ("wave_%ld terminated without reporting it",
+                         wave_id.handle);
+          continue;
         }
 
-      base_address += size;
+      const char *state_name = state == AMD_DBGAPI_WAVE_STATE_RUN ? "running"
+                               : state == AMD_DBGAPI_WAVE_STATE_SINGLE_STEP
+                                   ? "single-stepping"
+                                   : "stopped";
 
-      if (size != requested_size)
-        break;
+      amd_dbgapi_dispatch_id_t dispatch_id;
+      count_dbgapi_call ();
+      if (amd_dbgapi_wave_get_info (wave_id, AMD_DBGAPI_WAVE_INFO_DISPATCH,
+                                    sizeof (dispatch_id), &dispatch_id)
+          == AMD_DBGAPI_STATUS_SUCCESS)
+        agent_warning ("wave_%ld in dispatch_%ld did not stop (state: %s)",
+                       wave_id.handle, dispatch_id.handle, state_name);
+      else
+        agent_warning ("wave_%ld did not stop (state: %s)", wave_id.handle,
+                       state_name);
     }
-
-  if (base_address)
-    agent_out << std::endl;
 }
 
+/* Stop all the wavefronts of PROCESS_ID, and wait for them to stop.  The
+   worker thread sleeps on the dbgapi notifier until the stop events are
+   reported.  If TIMEOUT is set, the wavefronts that did not stop within
+   TIMEOUT are logged and left out of the report, and their stop requests are
+   recorded in g_outstanding_stop_requests.  */
 void
-stop_all_wavefronts (amd_dbgapi_process_id_t process_id)
+stop_all_wavefronts (amd_dbgapi_process_id_t process_id,
+                     std::optional<std::chrono::milliseconds> timeout)
 {
+  report_phase_timer_t timer (report_phase_t::stop);
+  trace_span_t span ("stop all wavefronts");
+
   using wave_handle_type_t = decltype (amd_dbgapi_wave_id_t::handle);
   std::unordered_set<wave_handle_type_t> already_stopped;
-  std::unordered_set<wave_handle_type_t> waiting_to_stop;
+  /* The wavefronts that did not stop in time for a previous report cannot be
+     sent another stop request: wait for their outstanding one instead.  */
+  std::unordered_set<wave_handle_type_t> waiting_to_stop
+      = std::move (g_outstanding_stop_requests);
+  g_outstanding_stop_requests.clear ();
 
-  agent_log (log_level_t::info, "stopping all wavefronts");
-  for (size_t iter = 0;; ++iter)
-    {
-      agent_log (log_level_t::info, "iteration %zu:", iter);
+  amd_dbgapi_notifier_t notifier;
+  DBGAPI_CHECK (amd_dbgapi_process_get_info (process_id,
+                                             AMD_DBGAPI_PROCESS_INFO_NOTIFIER,
+                                             sizeof (notifier), &notifier));
 
-      while (true)
-        {
-          amd_dbgapi_event_id_t event_id;
-          amd_dbgapi_event_kind_t kind;
+  const auto start_time = std::chrono::steady_clock::now ();
+  stop_all_statistics_t &statistics = g_stop_all_statistics;
+  ++statistics.m_calls;
 
-          DBGAPI_CHECK (amd_dbgapi_process_next_pending_event (
-              process_id, &event_id, &kind));
+  /* Record the wavefronts that reported stopping, until no event is
+     pending.  */
+  auto process_events = [&] () {
+    while (true)
+      {
+        amd_dbgapi_event_id_t event_id;
+        amd_dbgapi_event_kind_t kind;
 
-          if (event_id.handle == AMD_DBGAPI_EVENT_NONE.handle)
-            break;
+        DBGAPI_CHECK (amd_dbgapi_process_next_pending_event (
+            process_id, &event_id, &kind));
 
-          if (kind == AMD_DBGAPI_EVENT_KIND_WAVE_STOP
-              || kind == AMD_DBGAPI_EVENT_KIND_WAVE_COMMAND_TERMINATED)
-            {
-              amd_dbgapi_wave_id_t wave_id;
-              DBGAPI_CHECK (amd_dbgapi_event_get_info (
-                  event_id, AMD_DBGAPI_EVENT_INFO_WAVE, sizeof (wave_id),
-                  &wave_id));
+        if (event_id.handle == AMD_DBGAPI_EVENT_NONE.handle)
+          break;
 
-              agent_assert (waiting_to_stop.find (wave_id.handle)
-                            != waiting_to_stop.end ());
+        if (kind == AMD_DBGAPI_EVENT_KIND_WAVE_STOP
+            || kind == AMD_DBGAPI_EVENT_KIND_WAVE_COMMAND_TERMINATED)
+          {
+            amd_dbgapi_wave_id_t wave_id;
+            DBGAPI_CHECK (amd_dbgapi_event_get_info (
+                event_id, AMD_DBGAPI_EVENT_INFO_WAVE, sizeof (wave_id),
+                &wave_id));
 
-              waiting_to_stop.erase (wave_id.handle);
+            const bool requested = waiting_to_stop.erase (wave_id.handle);
 
-              if (kind == AMD_DBGAPI_EVENT_KIND_WAVE_STOP)
-                {
-                  already_stopped.emplace (wave_id.handle);
+            /* A wave that was not sent a stop request stopped on its own,
+               for example on an exception, while the report was being
+               made.  It is reported with the stopped waves.  */
+            agent_assert (requested
+                          || kind == AMD_DBGAPI_EVENT_KIND_WAVE_STOP);
 
-                  agent_log (log_level_t::info, "wave_%ld is stopped",
-                             wave_id.handle);
-                }
-              else /* kind == AMD_DBGAPI_EVENT_KIND_COMMAND_TERMINATED */
-                {
-                  agent_log (log_level_t::info,
-                             "wave_%ld terminated while stopping",
-                             wave_id.handle);
-                }
-            }
+            if (kind == AMD_DBGAPI_EVENT_KIND_WAVE_STOP)
+              {
+                already_stopped.emplace (wave_id.handle);
 
-          DBGAPI_CHECK (amd_dbgapi_event_processed (event_id));
-        }
+                agent_log (log_level_t::info,
+                           requested ? "wave_%ld is stopped"
+                                     : "wave_%ld stopped on its own",
+                           wave_id.handle);
+              }
+            else /* kind == AMD_DBGAPI_EVENT_KIND_COMMAND_TERMINATED */
+              {
+                agent_log (log_level_t::info,
+                           "wave_%ld terminated while stopping",
+                           wave_id.handle);
+              }
+          }
+
+        DBGAPI_CHECK (amd_dbgapi_event_processed (event_id));
+      }
+  };
+
+  agent_log (log_level_t::info, "stopping all wavefronts");
+  for (size_t iter = 0;; ++iter)
+    {
+      agent_log (log_level_t::info, "iteration %zu:", iter);
+      ++statistics.m_iterations;
+      trace_span_t iteration_span ("stop all iteration", "iteration", iter);
+
+      process_events ();
 
       amd_dbgapi_wave_id_t *wave_ids;
       size_t wave_count;
@@ -499,6 +737,7 @@ stop_all_wavefronts (amd_dbgapi_process_id_t process_id)
             }
 
           amd_dbgapi_wave_state_t state;
+          count_dbgapi_call ();
           if (amd_dbgapi_status_t status = amd_dbgapi_wave_get_info (
                   wave_id, AMD_DBGAPI_WAVE_INFO_STATE, sizeof (state), &state);
               status == AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID)
@@ -527,6 +766,7 @@ stop_all_wavefronts (amd_dbgapi_process_id_t process_id)
               continue;
             }
 
+          count_dbgapi_call ();
           if (amd_dbgapi_status_t status = amd_dbgapi_wave_stop (wave_id);
               status == AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID)
             {
@@ -541,63 +781,619 @@ stop_all_wavefronts (amd_dbgapi_process_id_t process_id)
                      "wave_%ld is running, sent stop request", wave_id.handle);
 
           waiting_to_stop.emplace (wave_id.handle);
+          ++statistics.m_stop_requests;
         }
 
       free (wave_ids);
 
       if (!waiting_to_stop.size ())
         break;
+
+      /* Sleep until dbgapi reports events, and only scan the wave list
+         again, for the waves created in the meantime, once all the stop
+         requests completed.  */
+      while (!waiting_to_stop.empty ())
+        {
+          int poll_timeout = -1;
+          if (timeout)
+            {
+              auto remaining = std::chrono::ceil<std::chrono::milliseconds> (
+                  start_time + *timeout - std::chrono::steady_clock::now ());
+              if (remaining.count () <= 0)
+                {
+                  ++statistics.m_timeouts;
+                  agent_warning ("%zu wavefronts did not stop within %ld ms",
+                                 waiting_to_stop.size (),
+                                 static_cast<long> (timeout->count ()));
+                  log_unstopped_wavefronts (waiting_to_stop);
+                  g_outstanding_stop_requests = std::move (waiting_to_stop);
+                  return;
+                }
+
+              poll_timeout = std::min<decltype (remaining)::rep> (
+                  remaining.count (), std::numeric_limits<int>::max ());
+            }
+
+          pollfd notifier_poll{ notifier, POLLIN, 0 };
+          if (poll (&notifier_poll, 1, poll_timeout) == -1 && errno != EINTR)
+            agent_error ("poll failed: %s", strerror (errno));
+          ++statistics.m_waits;
+
+          drain_notifier (notifier);
+          process_events ();
+        }
+    }
+
+  agent_log (
+      log_level_t::info,
+      "all wavefronts are stopped in %ld us (%zu calls, %zu timeouts, "
+      "%zu iterations, %zu waits, %zu stop requests so far)",
+      static_cast<long> (
+          std::chrono::duration_cast<std::chrono::microseconds> (
+              std::chrono::steady_clock::now () - start_time)
+              .count ()),
+      statistics.m_calls, statistics.m_timeouts, statistics.m_iterations,
+      statistics.m_waits, statistics.m_stop_requests);
+}
+
+/* A stopped wavefront, and the information used to print and group it.  */
+struct stopped_wave_t
+{
+  amd_dbgapi_wave_id_t m_wave_id;
+  amd_dbgapi_architecture_id_t m_architecture_id;
+  stop_reason_t m_stop_reason;
+  amd_dbgapi_global_address_t m_pc;
+  std::optional<amd_dbgapi_dispatch_id_t> m_dispatch_id;
+  std::optional<amd_dbgapi_global_address_t> m_kernel_entry;
+  /* The coordinates of the wave's workgroup in the dispatch grid.  */
+  std::optional<std::array<uint32_t, 3>> m_workgroup_coord;
+  /* The code object that contains m_pc.  */
+  code_object_t *m_code_object;
+};
+
+/* The wavefronts whose local memory was printed in the current report, by
+   dispatch and workgroup coordinates.  All the wavefronts of a workgroup
+   share the same local memory, so it is printed once per workgroup.  */
+using local_memory_dumps_t
+    = std::map<std::pair<decltype (amd_dbgapi_dispatch_id_t::handle),
+                         std::array<uint32_t, 3>>,
+               amd_dbgapi_wave_id_t>;
+
+stopped_wave_t
+get_stopped_wave (amd_dbgapi_wave_id_t wave_id,
+                  code_object_registry_t &code_objects)
+{
+  stopped_wave_t wave{ wave_id };
+
+  DBGAPI_CHECK (amd_dbgapi_wave_get_info (
+      wave_id, AMD_DBGAPI_WAVE_INFO_ARCHITECTURE,
+      sizeof (wave.m_architecture_id), &wave.m_architecture_id));
+
+  DBGAPI_CHECK (amd_dbgapi_wave_get_info (
+      wave_id, AMD_DBGAPI_WAVE_INFO_STOP_REASON, sizeof (wave.m_stop_reason),
+      &wave.m_stop_reason));
+
+  DBGAPI_CHECK (amd_dbgapi_wave_get_info (wave_id, AMD_DBGAPI_WAVE_INFO_PC,
+                                          sizeof (wave.m_pc), &wave.m_pc));
+
+  amd_dbgapi_dispatch_id_t dispatch_id;
+  count_dbgapi_call ();
+  if (auto status
+      = amd_dbgapi_wave_get_info (wave_id, AMD_DBGAPI_WAVE_INFO_DISPATCH,
+                                  sizeof (dispatch_id), &dispatch_id);
+      status == AMD_DBGAPI_STATUS_SUCCESS)
+    {
+      wave.m_dispatch_id.emplace (dispatch_id);
+      DBGAPI_CHECK (amd_dbgapi_dispatch_get_info (
+          dispatch_id, AMD_DBGAPI_DISPATCH_INFO_KERNEL_CODE_ENTRY_ADDRESS,
+          sizeof (decltype (wave.m_kernel_entry)::value_type),
+          &wave.m_kernel_entry.emplace ()));
+      DBGAPI_CHECK (amd_dbgapi_wave_get_info (
+          wave_id, AMD_DBGAPI_WAVE_INFO_WORKGROUP_COORD,
+          sizeof (decltype (wave.m_workgroup_coord)::value_type),
+          wave.m_workgroup_coord.emplace ().data ()));
+    }
+  /* The only possible error is NOT_AVAILABLE if the ttmp registers weren't
+     initialized when the wave was created.  */
+  else if (status != AMD_DBGAPI_STATUS_ERROR_NOT_AVAILABLE)
+    {
+      agent_error ("amd_dbgapi_wave_get_info failed (rc=%d)", status);
+    }
+
+  /* Find the code object that contains this pc.  */
+  wave.m_code_object = code_objects.find (wave.m_pc);
+
+  return wave;
+}
+
+/* Return the name of the kernel WAVE is running, if it is known.  */
+std::optional<std::string_view>
+wave_kernel_name (const stopped_wave_t &wave)
+{
+  if (wave.m_kernel_entry && wave.m_code_object)
+    if (auto symbol = wave.m_code_object->find_symbol (*wave.m_kernel_entry))
+      return symbol->m_name;
+
+  return std::nullopt;
+}
+
+/* Return the contents of the local memory of WAVE, or, if the local memory of
+   WAVE's workgroup is already in LOCAL_MEMORY_DUMPS, the wavefront it was
+   reported with.  */
+std::variant<std::vector<uint32_t>, amd_dbgapi_wave_id_t>
+get_wave_local_memory (const stopped_wave_t &wave,
+                       local_memory_dumps_t &local_memory_dumps)
+{
+  report_phase_timer_t timer (report_phase_t::local_memory);
+
+  if (!wave.m_workgroup_coord)
+    return read_local_memory (wave.m_wave_id, wave.m_architecture_id);
+
+  local_memory_dumps_t::key_type workgroup{ wave.m_dispatch_id->handle,
+                                            *wave.m_workgroup_coord };
+
+  if (auto it = local_memory_dumps.find (workgroup);
+      it != local_memory_dumps.end ())
+    return it->second;
+
+  std::vector<uint32_t> local_memory
+      = read_local_memory (wave.m_wave_id, wave.m_architecture_id);
+
+  if (!local_memory.empty ())
+    local_memory_dumps.emplace (workgroup, wave.m_wave_id);
+
+  return local_memory;
+}
+
+/* Print the pc, kernel and stop reason of WAVE, shared by all the wavefronts
+   of a group.  */
+void
+print_wave_location (const stopped_wave_t &wave)
+{
+  amd::debug_agent::print_wave_location (wave.m_pc, wave.m_kernel_entry,
+                                         wave_kernel_name (wave),
+                                         wave.m_stop_reason);
+}
+
+/* Print the registers and local memory of WAVE.  If the local memory of
+   WAVE's workgroup is already in LOCAL_MEMORY_DUMPS, only refer to it.  */
+void
+print_wave_state (const stopped_wave_t &wave,
+                  const report_options_t &report_options,
+                  local_memory_dumps_t &local_memory_dumps)
+{
+  trace_span_t span ("wave", "wave_id", wave.m_wave_id.handle);
+
+  agent_out << "wave_" << std::dec << wave.m_wave_id.handle << ": ";
+  print_wave_location (wave);
+
+  print_registers (wave.m_wave_id, wave.m_architecture_id,
+                   report_options.m_compact);
+
+  auto local_memory = get_wave_local_memory (wave, local_memory_dumps);
+  if (auto *shared_wave_id = std::get_if<amd_dbgapi_wave_id_t> (&local_memory))
+    print_shared_local_memory (shared_wave_id->handle);
+  else
+    print_local_memory_contents (
+        std::get<std::vector<uint32_t>> (local_memory),
+        report_options.m_compact);
+}
+
+/* Print the instructions around WAVE's pc.  */
+void
+print_wave_disassembly (const stopped_wave_t &wave)
+{
+  report_phase_timer_t timer (report_phase_t::disassembly);
+
+  if (wave.m_code_object)
+    {
+      /* Disassemble instructions around `pc`  */
+      wave.m_code_object->disassemble (wave.m_architecture_id, wave.m_pc);
+    }
+  else
+    {
+      /* TODO: Add disassembly even if we did not find a code object  */
+    }
+}
+
+/* Print the wavefronts of WAVES grouped by dispatch, pc and stop reason.
+   Each group is printed once, with the list of its wavefronts, and the state
+   of only the first REPRESENTATIVE_COUNT wavefronts of the group.  */
+void
+print_wave_groups (const std::vector<stopped_wave_t> &waves,
+                   size_t representative_count,
+                   const report_options_t &report_options,
+                   local_memory_dumps_t &local_memory_dumps)
+{
+  using dispatch_handle_type_t = decltype (amd_dbgapi_dispatch_id_t::handle);
+  using group_key_t
+      = std::tuple<std::optional<dispatch_handle_type_t>,
+                   amd_dbgapi_global_address_t,
+                   decltype (stopped_wave_t::m_stop_reason)>;
+
+  /* The groups, in the order their first wavefront was reported.  */
+  std::map<group_key_t, size_t> group_indices;
+  std::vector<std::vector<const stopped_wave_t *>> groups;
+
+  for (auto &&wave : waves)
+    {
+      group_key_t key{ wave.m_dispatch_id
+                           ? std::make_optional (wave.m_dispatch_id->handle)
+                           : std::nullopt,
+                       wave.m_pc, wave.m_stop_reason };
+
+      auto [it, inserted] = group_indices.try_emplace (key, groups.size ());
+      if (inserted)
+        groups.emplace_back ();
+
+      groups[it->second].emplace_back (&wave);
+    }
+
+  for (size_t i = 0; i < groups.size (); ++i)
+    {
+      auto &&group = groups[i];
+      const stopped_wave_t &first_wave = *group.front ();
+
+      if (i)
+        agent_out << std::endl;
+
+      agent_out << "--------------------------------------------------------"
+                << std::endl;
+
+      agent_out << std::dec << group.size ()
+                << (group.size () == 1 ? " wavefront" : " wavefronts");
+      if (first_wave.m_dispatch_id)
+        agent_out << " in dispatch_" << first_wave.m_dispatch_id->handle;
+      agent_out << ": ";
+      print_wave_location (first_wave);
+
+      constexpr size_t waves_per_line = 8;
+      for (size_t j = 0; j < group.size (); ++j)
+        {
+          if ((j % waves_per_line) == 0)
+            {
+              if (j)
+                agent_out << std::endl << "      ";
+              else
+                agent_out << "waves:";
+            }
+          agent_out << " wave_" << std::dec << group[j]->m_wave_id.handle;
+        }
+      agent_out << std::endl;
+
+      for (size_t j = 0; j < std::min (representative_count, group.size ());
+           ++j)
+        {
+          agent_out << std::endl;
+          print_wave_state (*group[j], report_options, local_memory_dumps);
+        }
+
+      print_wave_disassembly (first_wave);
+    }
+}
+
+/* Write the state of WAVES to SNAPSHOT as one report.  Only raw values are
+   written: the symbols, source lines and disassembly are left to the snapshot
+   decoder.  */
+void
+save_snapshot (snapshot_writer_t &snapshot,
+               amd_dbgapi_process_id_t process_id,
+               const std::vector<stopped_wave_t> &waves)
+{
+  /* The number of bytes of instructions saved from the pc.  It covers the
+     instructions printed by the disassembly after the pc.  */
+  constexpr size_t instruction_bytes = 64;
+
+  snapshot.begin_record (snapshot_record_kind_t::report_begin);
+  snapshot.put<uint64_t> (
+      std::chrono::duration_cast<std::chrono::nanoseconds> (
+          std::chrono::system_clock::now ().time_since_epoch ())
+          .count ());
+  snapshot.end_record ();
+
+  /* The architectures and code objects used by the waves, written after the
+     waves, once all the registers of the architectures are known.  */
+  std::map<decltype (amd_dbgapi_architecture_id_t::handle),
+           const architecture_registers_t *>
+      architectures;
+  std::map<decltype (amd_dbgapi_code_object_id_t::handle), code_object_t *>
+      code_objects;
+
+  local_memory_dumps_t local_memory_dumps;
+  std::vector<uint8_t> buffer;
+
+  for (auto &&wave : waves)
+    {
+      trace_span_t span ("wave", "wave_id", wave.m_wave_id.handle);
+
+      /* Saving the raw state of a wave is mostly reading its registers.  */
+      report_phase_timer_t timer (report_phase_t::registers);
+
+      architecture_registers_t &registers
+          = get_cached_architecture_registers (wave.m_architecture_id);
+      class_registers_t class_registers
+          = get_class_registers (wave.m_wave_id, registers);
+
+      architectures.emplace (wave.m_architecture_id.handle, &registers);
+      if (wave.m_code_object)
+        code_objects.emplace (wave.m_code_object->id ().handle,
+                              wave.m_code_object);
+
+      snapshot.begin_record (snapshot_record_kind_t::wave);
+      snapshot.put<uint64_t> (wave.m_wave_id.handle);
+      snapshot.put<uint64_t> (wave.m_architecture_id.handle);
+      snapshot.put<uint64_t> (wave.m_stop_reason);
+      snapshot.put<uint64_t> (wave.m_pc);
+
+      snapshot.put<uint8_t> (
+          (wave.m_dispatch_id ? snapshot_wave_has_dispatch : 0)
+          | (wave.m_code_object ? snapshot_wave_has_code_object : 0));
+      if (wave.m_dispatch_id)
+        {
+          snapshot.put<uint64_t> (wave.m_dispatch_id->handle);
+          snapshot.put<uint64_t> (*wave.m_kernel_entry);
+          snapshot.put (*wave.m_workgroup_coord);
+        }
+      if (wave.m_code_object)
+        snapshot.put<uint64_t> (wave.m_code_object->id ().handle);
+
+      size_t register_count = 0;
+      for (auto &&class_register_list : class_registers)
+        register_count += class_register_list.size ();
+
+      snapshot.put<uint32_t> (register_count);
+      for (auto &&class_register_list : class_registers)
+        for (auto [register_id, info] : class_register_list)
+          {
+            buffer.resize (info->m_size);
+            DBGAPI_CHECK (amd_dbgapi_read_register (
+                wave.m_wave_id, register_id, 0, info->m_size,
+                buffer.data ()));
+            count_bytes_read (info->m_size);
+
+            snapshot.put<uint64_t> (register_id.handle);
+            snapshot.put_bytes (buffer.data (), buffer.size ());
+          }
+
+      buffer.resize (instruction_bytes
+                     + registers.m_largest_instruction_size);
+      amd_dbgapi_size_t size = buffer.size ();
+      count_dbgapi_call ();
+      if (amd_dbgapi_read_memory (process_id, AMD_DBGAPI_WAVE_NONE,
+                                  AMD_DBGAPI_LANE_NONE,
+                                  AMD_DBGAPI_ADDRESS_SPACE_GLOBAL, wave.m_pc,
+                                  &size, buffer.data ())
+          != AMD_DBGAPI_STATUS_SUCCESS)
+        size = 0;
+      count_bytes_read (size);
+
+      snapshot.put<uint64_t> (wave.m_pc);
+      snapshot.put_bytes (buffer.data (), size);
+
+      /* Like the text report, the local memory of a workgroup is saved with
+         its first wavefront only.  */
+      auto local_memory = get_wave_local_memory (wave, local_memory_dumps);
+      if (auto *shared_wave_id
+          = std::get_if<amd_dbgapi_wave_id_t> (&local_memory))
+        {
+          snapshot.put (snapshot_local_memory_t::shared);
+          snapshot.put<uint64_t> (shared_wave_id->handle);
+        }
+      else if (auto &contents = std::get<std::vector<uint32_t>> (local_memory);
+               !contents.empty ())
+        {
+          snapshot.put (snapshot_local_memory_t::contents);
+          snapshot.put_bytes (contents.data (),
+                              contents.size () * sizeof (contents[0]));
+        }
+      else
+        snapshot.put (snapshot_local_memory_t::none);
+
+      snapshot.end_record ();
     }
 
-  agent_log (log_level_t::info, "all wavefronts are stopped");
-}
+  for (auto &&[handle, registers] : architectures)
+    {
+      snapshot.begin_record (snapshot_record_kind_t::architecture);
+      snapshot.put<uint64_t> (handle);
+      snapshot.put<uint32_t> (registers->m_elf_amdgpu_machine);
+      snapshot.put_string (registers->m_name);
+
+      snapshot.put<uint32_t> (registers->m_class_names.size ());
+      for (auto &&class_name : registers->m_class_names)
+        snapshot.put_string (class_name);
+
+      snapshot.put<uint32_t> (registers->m_registers.size ());
+      for (auto &&[register_handle, info] : registers->m_registers)
+        {
+          snapshot.put<uint64_t> (register_handle);
+          snapshot.put_string (info.m_name);
+          snapshot.put_string (info.m_type);
+          snapshot.put<uint64_t> (info.m_size);
+          snapshot.put<int32_t> (info.m_class_index ? *info.m_class_index
+                                                    : -1);
+        }
+
+      snapshot.end_record ();
+    }
+
+  for (auto &&[handle, code_object] : code_objects)
+    {
+      snapshot.begin_record (snapshot_record_kind_t::code_object);
+      snapshot.put<uint64_t> (handle);
+      snapshot.put<uint64_t> (code_object->load_address ());
+      snapshot.put<uint64_t> (code_object->mem_size ());
+      snapshot.put<uint64_t> (code_object->content_hash ());
+      snapshot.put_string (code_object->uri ());
+
+      /* The image of a code object loaded from memory is gone once the
+         process exits, so it is saved in the snapshot.  */
+      if (code_object->is_file_backed ())
+        snapshot.put_bytes (nullptr, 0);
+      else
+        snapshot.put_bytes (code_object->image ().data (),
+                            code_object->image ().size ());
+
+      snapshot.end_record ();
+    }
+
+  snapshot.begin_record (snapshot_record_kind_t::report_end);
+  snapshot.end_record ();
+
+  report_phase_timer_t timer (report_phase_t::output);
+  snapshot.flush ();
+}
+
+/* The sequence number of the last report written as newline-delimited JSON
+   records.  */
+uint64_t g_ndjson_report_number{ 0 };
+
+/* Write WAVES as newline-delimited JSON records.  A report record comes
+   first, then for each wave, the record of its code object if it is the
+   first wave of the report in that code object, the wave's record, and the
+   records of the instructions around its pc if it is the first wave of the
+   report stopped at that pc.  The records are written as they are built, and
+   are tied together by the report's sequence number.  */
+void
+write_ndjson_report (const std::vector<stopped_wave_t> &waves)
+{
+  const uint64_t report_number = ++g_ndjson_report_number;
+
+  json_writer_t json (agent_out);
+
+  auto begin_record = [&] (const char *type) {
+    json.begin_object ();
+    json.key ("type").value (type);
+    json.key ("report").value (report_number);
+  };
+  auto end_record = [&] () {
+    json.end_object ();
+    agent_out.put ('\n');
+  };
+
+  begin_record ("report");
+  json.key ("timestamp")
+      .value (std::chrono::duration_cast<std::chrono::nanoseconds> (
+                  std::chrono::system_clock::now ().time_since_epoch ())
+                  .count ());
+  json.key ("wave_count").value (waves.size ());
+  end_record ();
+
+  std::unordered_set<decltype (amd_dbgapi_code_object_id_t::handle)>
+      reported_code_objects;
+  std::unordered_set<amd_dbgapi_global_address_t> disassembled_pcs;
+  local_memory_dumps_t local_memory_dumps;
+
+  for (auto &&wave : waves)
+    {
+      trace_span_t span ("wave", "wave_id", wave.m_wave_id.handle);
+      code_object_t *code_object = wave.m_code_object;
+
+      if (code_object
+          && reported_code_objects.emplace (code_object->id ().handle).second)
+        {
+          begin_record ("code_object");
+          json.key ("code_object_id").value (code_object->id ().handle);
+          json.key ("uri").value (code_object->uri ());
+          json.key ("load_address").hex_value (code_object->load_address ());
+          json.key ("mem_size").value (code_object->mem_size ());
+          end_record ();
+        }
 
-void
-print_wavefronts (amd_dbgapi_process_id_t process_id, bool all_wavefronts)
-{
-  /* This function is not thread-safe and not re-entrant.  */
-  static std::mutex lock;
-  if (!lock.try_lock ())
-    return;
-  /* Make sure the lock is released when this function returns.  */
-  std::scoped_lock sl (std::adopt_lock, lock);
+      architecture_registers_t &registers
+          = get_cached_architecture_registers (wave.m_architecture_id);
 
-  std::map<amd_dbgapi_global_address_t, code_object_t> code_object_map;
+      begin_record ("wave");
+      json.key ("wave_id").value (wave.m_wave_id.handle);
+      json.key ("architecture").value (registers.m_name);
+      json.key ("pc").hex_value (wave.m_pc);
+      json.key ("stop_reason").value (stop_reason_string (wave.m_stop_reason));
 
-  amd_dbgapi_code_object_id_t *code_objects_id;
-  size_t code_object_count;
-  DBGAPI_CHECK (amd_dbgapi_process_code_object_list (
-      process_id, &code_object_count, &code_objects_id, nullptr));
+      if (wave.m_dispatch_id)
+        {
+          json.key ("dispatch_id").value (wave.m_dispatch_id->handle);
+          json.key ("kernel_code_entry").hex_value (*wave.m_kernel_entry);
 
-  for (size_t i = 0; i < code_object_count; ++i)
-    {
-      code_object_t code_object (code_objects_id[i]);
+          json.key ("workgroup").begin_array ();
+          for (uint32_t coord : *wave.m_workgroup_coord)
+            json.value (coord);
+          json.end_array ();
+        }
 
-      code_object.open ();
-      if (!code_object.is_open ())
+      if (auto kernel_name = wave_kernel_name (wave))
+        json.key ("kernel_name").value (*kernel_name);
+
+      if (code_object)
+        json.key ("code_object_id").value (code_object->id ().handle);
+
+      wave_registers_t values
+          = read_wave_registers (wave.m_wave_id, registers);
+      json.key ("registers").begin_object ();
+      for (size_t i = 0; i < values.m_classes.size (); ++i)
+        json_register_class (json, registers.m_class_names[i],
+                             values.m_classes[i]);
+      json.end_object ();
+
+      auto local_memory = get_wave_local_memory (wave, local_memory_dumps);
+      if (auto *shared_wave_id
+          = std::get_if<amd_dbgapi_wave_id_t> (&local_memory))
+        json.key ("local_memory_same_as_wave_id")
+            .value (shared_wave_id->handle);
+      else if (auto &contents = std::get<std::vector<uint32_t>> (local_memory);
+               !contents.empty ())
         {
-          agent_warning ("could not open code_object_%ld",
-                         code_objects_id[i].handle);
-          continue;
+          json.key ("local_memory").begin_array ();
+          for (uint32_t word : contents)
+            json.value (word);
+          json.end_array ();
         }
 
-      if (g_code_objects_dir && !code_object.save (*g_code_objects_dir))
-        agent_warning ("could not save code object to %s",
-                       g_code_objects_dir->c_str ());
+      end_record ();
 
-      code_object_map.emplace (code_object.load_address (),
-                               std::move (code_object));
+      if (!code_object || !disassembled_pcs.emplace (wave.m_pc).second)
+        continue;
+
+      std::vector<code_object_t::instruction_t> instructions;
+      {
+        report_phase_timer_t timer (report_phase_t::disassembly);
+        instructions
+            = code_object->instructions (wave.m_architecture_id, wave.m_pc);
+      }
+
+      for (auto &&instruction : instructions)
+        {
+          begin_record ("instruction");
+          json.key ("pc").hex_value (wave.m_pc);
+          json.key ("address").hex_value (instruction.m_address);
+          json.key ("size").value (instruction.m_size);
+          json.key ("text").value (instruction.m_text);
+          if (instruction.m_file_name)
+            {
+              json.key ("file").value (*instruction.m_file_name);
+              json.key ("line").value (instruction.m_line);
+            }
+          end_record ();
+        }
     }
-  free (code_objects_id);
 
-  if (all_wavefronts)
-    stop_all_wavefronts (process_id);
+  agent_out.flush ();
+}
+
+/* Return the stopped wavefronts of PROCESS_ID.  */
+std::vector<stopped_wave_t>
+get_stopped_waves (amd_dbgapi_process_id_t process_id,
+                   code_object_registry_t &code_objects)
+{
+  report_phase_timer_t timer (report_phase_t::wave_info);
 
   amd_dbgapi_wave_id_t *wave_ids;
   size_t wave_count;
   DBGAPI_CHECK (amd_dbgapi_process_wave_list (process_id, &wave_count,
                                               &wave_ids, nullptr));
 
+  std::vector<stopped_wave_t> waves;
+  waves.reserve (wave_count);
+
   for (size_t i = 0; i < wave_count; ++i)
     {
       amd_dbgapi_wave_id_t wave_id = wave_ids[i];
@@ -609,153 +1405,168 @@ print_wavefronts (amd_dbgapi_process_id_t process_id, bool all_wavefronts)
       if (state != AMD_DBGAPI_WAVE_STATE_STOP)
         continue;
 
-      std::underlying_type_t<amd_dbgapi_wave_stop_reasons_t> stop_reason;
-      DBGAPI_CHECK (
-          amd_dbgapi_wave_get_info (wave_id, AMD_DBGAPI_WAVE_INFO_STOP_REASON,
-                                    sizeof (stop_reason), &stop_reason));
+      waves.emplace_back (get_stopped_wave (wave_id, code_objects));
+    }
 
-      amd_dbgapi_global_address_t pc;
-      DBGAPI_CHECK (amd_dbgapi_wave_get_info (wave_id, AMD_DBGAPI_WAVE_INFO_PC,
-                                              sizeof (pc), &pc));
+  free (wave_ids);
+  return waves;
+}
 
-      std::optional<amd_dbgapi_global_address_t> kernel_entry;
-      amd_dbgapi_dispatch_id_t dispatch_id;
-      if (auto status
-          = amd_dbgapi_wave_get_info (wave_id, AMD_DBGAPI_WAVE_INFO_DISPATCH,
-                                      sizeof (dispatch_id), &dispatch_id);
-          status == AMD_DBGAPI_STATUS_SUCCESS)
-        {
-          DBGAPI_CHECK (amd_dbgapi_dispatch_get_info (
-              dispatch_id, AMD_DBGAPI_DISPATCH_INFO_KERNEL_CODE_ENTRY_ADDRESS,
-              sizeof (decltype (kernel_entry)::value_type),
-              &kernel_entry.emplace ()));
-        }
-      /* The only possible error is NOT_AVAILABLE if the ttmp registers weren't
-         initialized when the wave was created.  */
-      else if (status != AMD_DBGAPI_STATUS_ERROR_NOT_AVAILABLE)
-        {
-          agent_error ("amd_dbgapi_wave_get_info failed (rc=%d)", status);
-        }
+void
+print_wavefronts (amd_dbgapi_process_id_t process_id,
+                  code_object_registry_t &code_objects, bool all_wavefronts,
+                  const report_options_t &report_options,
+                  snapshot_writer_t *snapshot)
+{
+  /* This function is not thread-safe and not re-entrant.  */
+  static std::mutex lock;
+  if (!lock.try_lock ())
+    return;
+  /* Make sure the lock is released when this function returns.  */
+  std::scoped_lock sl (std::adopt_lock, lock);
+
+  trace_span_t span ("report");
+
+  /* Suspend the background parsing of code objects while this report uses
+     them.  */
+  std::unique_lock<code_object_registry_t> code_objects_lock (code_objects,
+                                                              std::defer_lock);
+  {
+    report_phase_timer_t timer (report_phase_t::code_objects);
+
+    /* The registry is normally updated when dbgapi reports a code object
+       list change, but make sure it is current before using it.  */
+    code_objects.update ();
+
+    code_objects_lock.lock ();
+    code_objects.open_all ();
+  }
+
+  if (all_wavefronts)
+    stop_all_wavefronts (process_id, report_options.m_stop_timeout);
+
+  std::vector<stopped_wave_t> waves
+      = get_stopped_waves (process_id, code_objects);
+  span.set_arg ("waves", waves.size ());
+
+  if (snapshot)
+    {
+      save_snapshot (*snapshot, process_id, waves);
+      agent_out << "Saved " << std::dec << waves.size ()
+                << (waves.size () == 1 ? " wavefront" : " wavefronts")
+                << " to snapshot `" << snapshot->path () << "'" << std::endl;
+      return;
+    }
+
+  if (report_options.m_format == output_format_t::ndjson)
+    {
+      write_ndjson_report (waves);
+      return;
+    }
 
-      /* Find the code object that contains this pc.  */
-      code_object_t *code_object_found{ nullptr };
-      if (auto it = code_object_map.upper_bound (pc);
-          it != code_object_map.begin ())
-        if (auto &&[load_address, code_object] = *std::prev (it);
-            (pc - load_address) <= code_object.mem_size ())
-          code_object_found = &code_object;
+  local_memory_dumps_t local_memory_dumps;
 
+  if (report_options.m_aggregate_waves)
+    {
+      print_wave_groups (waves, *report_options.m_aggregate_waves,
+                         report_options, local_memory_dumps);
+      return;
+    }
+
+  for (size_t i = 0; i < waves.size (); ++i)
+    {
       if (i)
         agent_out << std::endl;
 
       agent_out << "--------------------------------------------------------"
                 << std::endl;
 
-      agent_out << "wave_" << std::dec << wave_id.handle << ": pc=0x"
-                << std::hex << pc << " (kernel_code_entry=";
+      print_wave_state (waves[i], report_options, local_memory_dumps);
+      print_wave_disassembly (waves[i]);
+    }
+}
 
-      if (kernel_entry)
-        {
-          agent_out << "0x" << std::hex << *kernel_entry;
+/* Print the statistics STATS of the report just made.  If the report was
+   written as newline-delimited JSON records, they are printed as a
+   report_stats record of the same report.  */
+void
+print_report_stats (const report_stats_t &stats, bool ndjson)
+{
+  using std::chrono::nanoseconds;
+  auto to_ns = [] (report_stats_t::clock_type::duration duration) {
+    return std::chrono::duration_cast<nanoseconds> (duration).count ();
+  };
 
-          if (code_object_found)
-            if (auto symbol = code_object_found->find_symbol (*kernel_entry))
-              agent_out << " <" << symbol->m_name << ">";
+  if (ndjson)
+    {
+      json_writer_t json (agent_out);
+      json.begin_object ();
+      json.key ("type").value ("report_stats");
+      json.key ("report").value (g_ndjson_report_number);
+      json.key ("time_ns").value (to_ns (stats.total_time ()));
+      json.key ("dbgapi_calls").value (stats.total_dbgapi_calls ());
+      json.key ("bytes_read").value (stats.m_bytes_read);
+      json.key ("bytes_written").value (stats.m_bytes_written);
+
+      json.key ("phases").begin_object ();
+      for (size_t i = 0; i < report_stats_t::phase_count; ++i)
+        {
+          json.key (report_phase_name (static_cast<report_phase_t> (i)))
+              .begin_object ();
+          json.key ("time_ns").value (to_ns (stats.m_phase_time[i]));
+          json.key ("dbgapi_calls").value (stats.m_dbgapi_calls[i]);
+          json.end_object ();
         }
-      else
-        agent_out << "not available";
+      json.end_object ();
 
-      agent_out << ")";
+      json.end_object ();
+      agent_out.put ('\n');
+      return;
+    }
 
-      std::string stop_reason_str;
-      auto stop_reason_bits{ stop_reason };
-      do
-        {
-          /* Consume one bit from the stop reason.  */
-          auto one_bit
-              = stop_reason_bits ^ (stop_reason_bits & (stop_reason_bits - 1));
-          stop_reason_bits ^= one_bit;
+  auto to_ms = [] (report_stats_t::clock_type::duration duration) {
+    return std::chrono::duration<double, std::milli> (duration).count ();
+  };
 
-          if (!stop_reason_str.empty ())
-            stop_reason_str += "|";
+  agent_out << std::endl
+            << "Report statistics: " << std::fixed << std::setprecision (3)
+            << to_ms (stats.total_time ()) << " ms, " << std::dec
+            << stats.total_dbgapi_calls () << " dbgapi calls, "
+            << stats.m_bytes_read << " bytes read, " << stats.m_bytes_written
+            << " bytes written" << std::endl;
 
-          stop_reason_str += [] (amd_dbgapi_wave_stop_reasons_t reason) {
-            switch (reason)
-              {
-              case AMD_DBGAPI_WAVE_STOP_REASON_NONE:
-                return "NONE";
-              case AMD_DBGAPI_WAVE_STOP_REASON_BREAKPOINT:
-                return "BREAKPOINT";
-              case AMD_DBGAPI_WAVE_STOP_REASON_WATCHPOINT:
-                return "WATCHPOINT";
-              case AMD_DBGAPI_WAVE_STOP_REASON_SINGLE_STEP:
-                return "SINGLE_STEP";
-              case AMD_DBGAPI_WAVE_STOP_REASON_FP_INPUT_DENORMAL:
-                return "FP_INPUT_DENORMAL";
-              case AMD_DBGAPI_WAVE_STOP_REASON_FP_DIVIDE_BY_0:
-                return "FP_DIVIDE_BY_0";
-              case AMD_DBGAPI_WAVE_STOP_REASON_FP_OVERFLOW:
-                return "FP_OVERFLOW";
-              case AMD_DBGAPI_WAVE_STOP_REASON_FP_UNDERFLOW:
-                return "FP_UNDERFLOW";
-              case AMD_DBGAPI_WAVE_STOP_REASON_FP_INEXACT:
-                return "FP_INEXACT";
-              case AMD_DBGAPI_WAVE_STOP_REASON_FP_INVALID_OPERATION:
-                return "FP_INVALID_OPERATION";
-              case AMD_DBGAPI_WAVE_STOP_REASON_INT_DIVIDE_BY_0:
-                return "INT_DIVIDE_BY_0";
-              case AMD_DBGAPI_WAVE_STOP_REASON_DEBUG_TRAP:
-                return "DEBUG_TRAP";
-              case AMD_DBGAPI_WAVE_STOP_REASON_ASSERT_TRAP:
-                return "ASSERT_TRAP";
-              case AMD_DBGAPI_WAVE_STOP_REASON_TRAP:
-                return "TRAP";
-              case AMD_DBGAPI_WAVE_STOP_REASON_MEMORY_VIOLATION:
-                return "MEMORY_VIOLATION";
-              case AMD_DBGAPI_WAVE_STOP_REASON_ADDRESS_ERROR:
-                return "ADDRESS_ERROR";
-              case AMD_DBGAPI_WAVE_STOP_REASON_ILLEGAL_INSTRUCTION:
-                return "ILLEGAL_INSTRUCTION";
-              case AMD_DBGAPI_WAVE_STOP_REASON_ECC_ERROR:
-                return "ECC_ERROR";
-              case AMD_DBGAPI_WAVE_STOP_REASON_FATAL_HALT:
-                return "FATAL_HALT";
-#if AMD_DBGAPI_VERSION_MAJOR == 0 && AMD_DBGAPI_VERSION_MINOR < 58
-              case AMD_DBGAPI_WAVE_STOP_REASON_RESERVED:
-                return "RESERVED";
-#endif
-              }
-            return "";
-          }(static_cast<amd_dbgapi_wave_stop_reasons_t> (one_bit));
-      } while (stop_reason_bits);
+  agent_out << "    " << std::left << std::setw (16) << "phase" << std::right
+            << std::setw (12) << "ms" << std::setw (16) << "dbgapi calls"
+            << std::endl;
 
-      agent_out << " (";
-      if (stop_reason != AMD_DBGAPI_WAVE_STOP_REASON_NONE)
-        agent_out << "stopped, reason: " << stop_reason_str;
-      else
-        agent_out << "running";
-      agent_out << ")" << std::endl;
+  for (size_t i = 0; i < report_stats_t::phase_count; ++i)
+    agent_out << "    " << std::left << std::setw (16)
+              << report_phase_name (static_cast<report_phase_t> (i))
+              << std::right << std::setw (12) << to_ms (stats.m_phase_time[i])
+              << std::setw (16) << stats.m_dbgapi_calls[i] << std::endl;
 
-      print_registers (wave_id);
-      print_local_memory (wave_id);
+  agent_out << std::defaultfloat;
+}
 
-      if (code_object_found)
-        {
-          amd_dbgapi_architecture_id_t architecture_id;
-          DBGAPI_CHECK (amd_dbgapi_wave_get_info (
-              wave_id, AMD_DBGAPI_WAVE_INFO_ARCHITECTURE,
-              sizeof (architecture_id), &architecture_id));
+/* Write the report to its output, then print its statistics if
+   STATS_SCOPE collected them.  */
+void
+finish_report (report_stats_scope_t &stats_scope,
+               const report_options_t &report_options, bool snapshot)
+{
+  {
+    report_phase_timer_t timer (report_phase_t::output);
+    trace_span_t span ("flush output");
+    flush_agent_out ();
+  }
 
-          /* Disassemble instructions around `pc`  */
-          code_object_found->disassemble (architecture_id, pc);
-        }
-      else
-        {
-          /* TODO: Add disassembly even if we did not find a code object  */
-        }
+  if (const report_stats_t *stats = stats_scope.finish ())
+    {
+      print_report_stats (*stats, !snapshot
+                                      && report_options.m_format
+                                             == output_format_t::ndjson);
+      flush_agent_out ();
     }
-
-  free (wave_ids);
 }
 
 void
@@ -774,6 +1585,84 @@ print_usage ()
             << "                              "
                "the current directory."
             << std::endl;
+  std::cerr << "      --preparse-code-objects "
+               "Open and parse code objects in a low priority"
+            << std::endl
+            << "                              "
+               "background thread as soon as they are loaded,"
+            << std::endl
+            << "                              "
+               "instead of when a report needs them."
+            << std::endl;
+  std::cerr << "      --aggregate-waves[=N]   "
+               "Group the stopped wavefronts by dispatch, pc and"
+            << std::endl
+            << "                              "
+               "stop reason. Print each group once, and the"
+            << std::endl
+            << "                              "
+               "registers and local memory of only N wavefronts"
+            << std::endl
+            << "                              "
+               "per group. The default for N is 1."
+            << std::endl;
+  std::cerr << "      --compact               "
+               "Collapse identical consecutive rows of the local"
+            << std::endl
+            << "                              "
+               "memory dump into a '*' line, and print vector"
+            << std::endl
+            << "                              "
+               "registers whose lanes all have the same value as"
+            << std::endl
+            << "                              "
+               "'all lanes = VALUE'."
+            << std::endl;
+  std::cerr << "      --snapshot=FILE         "
+               "Save the state of the wavefronts in the binary"
+            << std::endl
+            << "                              "
+               "snapshot FILE instead of printing it. Use"
+            << std::endl
+            << "                              "
+               "rocm-debug-agent-decode to print the report."
+            << std::endl;
+  std::cerr << "      --stop-timeout=MS       "
+               "When printing all wavefronts, wait at most MS"
+            << std::endl
+            << "                              "
+               "milliseconds for them to stop, and leave the"
+            << std::endl
+            << "                              "
+               "ones that did not out of the report. By"
+            << std::endl
+            << "                              "
+               "default, wait until they all stop."
+            << std::endl;
+  std::cerr << "      --stats                 "
+               "After each report, print the time spent in each"
+            << std::endl
+            << "                              "
+               "of its phases, and the number of dbgapi calls and"
+            << std::endl
+            << "                              "
+               "of bytes read and written."
+            << std::endl;
+  std::cerr << "      --trace=FILE            "
+               "Write a trace of the agent's activity to FILE, in"
+            << std::endl
+            << "                              "
+               "the Chrome JSON trace format read by Perfetto."
+            << std::endl;
+  std::cerr << "      --format={text|ndjson}  "
+               "Print the wavefronts as text, the default, or as"
+            << std::endl
+            << "                              "
+               "newline-delimited JSON records of the reports,"
+            << std::endl
+            << "                              "
+               "wavefronts, code objects and instructions."
+            << std::endl;
   std::cerr << "  -p, --precise-memory        "
             << "Enable precise memory mode which ensures that " << std::endl
             << "                              "
@@ -819,20 +1708,35 @@ print_usage ()
    dbgapi and act on the required events.  */
 
 void
-process_dbgapi_events (amd_dbgapi_process_id_t process_id, bool all_wavefronts)
+process_dbgapi_events (amd_dbgapi_process_id_t process_id,
+                       code_object_registry_t &code_objects,
+                       bool all_wavefronts,
+                       const report_options_t &report_options,
+                       snapshot_writer_t *snapshot)
 {
+  /* The statistics are only printed if the events lead to a report.  */
+  report_stats_scope_t stats_scope (report_options.m_stats);
+
   /* Consume all events available in the queue.  */
   bool need_print_waves = false;
-  bool wave_need_resume = false;
-  while (true)
+  /* The waves that stopped on a debug trap, or on an outstanding stop
+     request, to be resumed once all events are drained.  */
+  std::vector<amd_dbgapi_wave_id_t> trapped_waves;
+  std::optional<trace_span_t> drain_span (std::in_place, "dbgapi events");
+  for (size_t event_count = 0;; ++event_count)
     {
+      report_phase_timer_t timer (report_phase_t::events);
+
       amd_dbgapi_event_id_t event_id;
       amd_dbgapi_event_kind_t event_kind;
       DBGAPI_CHECK (amd_dbgapi_process_next_pending_event (
           process_id, &event_id, &event_kind));
 
       if (event_kind == AMD_DBGAPI_EVENT_KIND_NONE)
-        break;
+        {
+          drain_span->set_arg ("events", event_count);
+          break;
+        }
 
       switch (event_kind)
         {
@@ -849,25 +1753,52 @@ process_dbgapi_events (amd_dbgapi_process_id_t process_id, bool all_wavefronts)
                 wave_id, AMD_DBGAPI_WAVE_INFO_STOP_REASON,
                 sizeof (stop_reason), &stop_reason));
 
-            if (stop_reason == AMD_DBGAPI_WAVE_STOP_REASON_DEBUG_TRAP)
+            const bool outstanding_stop_request
+                = g_outstanding_stop_requests.erase (wave_id.handle) != 0;
+
+            if (stop_reason == AMD_DBGAPI_WAVE_STOP_REASON_DEBUG_TRAP
+                || (stop_reason == AMD_DBGAPI_WAVE_STOP_REASON_NONE
+                    && outstanding_stop_request))
               {
                 /* This wave will be silently resumed at the end of this
-                   procedure.  */
-                wave_need_resume = true;
+                   procedure.  A wave that stopped after the report that
+                   requested it was printed is not reported again.  */
+                trapped_waves.emplace_back (wave_id);
               }
             else
               need_print_waves = true;
             break;
           }
 
+        case AMD_DBGAPI_EVENT_KIND_WAVE_COMMAND_TERMINATED:
+          {
+            amd_dbgapi_wave_id_t wave_id;
+            DBGAPI_CHECK (amd_dbgapi_event_get_info (
+                event_id, AMD_DBGAPI_EVENT_INFO_WAVE, sizeof (wave_id),
+                &wave_id));
+
+            /* The wave terminated before its outstanding stop request
+               completed.  */
+            if (!g_outstanding_stop_requests.erase (wave_id.handle))
+              agent_log (log_level_t::warning, "Unexpected event kind %d",
+                         event_kind);
+            break;
+          }
+
         case AMD_DBGAPI_EVENT_KIND_QUEUE_ERROR:
           {
             need_print_waves = true;
             break;
           }
 
-        case AMD_DBGAPI_EVENT_KIND_RUNTIME:
         case AMD_DBGAPI_EVENT_KIND_CODE_OBJECT_LIST_UPDATED:
+          {
+            report_phase_timer_t timer (report_phase_t::code_objects);
+            code_objects.update ();
+            break;
+          }
+
+        case AMD_DBGAPI_EVENT_KIND_RUNTIME:
         case AMD_DBGAPI_EVENT_KIND_BREAKPOINT_RESUME:
           /* Ignore.  */
           break;
@@ -882,22 +1813,40 @@ process_dbgapi_events (amd_dbgapi_process_id_t process_id, bool all_wavefronts)
          and resume waves once all events are drained.  */
       DBGAPI_CHECK (amd_dbgapi_event_processed (event_id));
     }
+  drain_span.reset ();
 
-  /* Some events do not require us to do anythig more.  If so, just return
-     early.  */
-  if (!need_print_waves && !wave_need_resume)
-    return;
+  /* If the events only reported debug traps, the waves that need to be
+     resumed are known.  Resume them without listing the waves of the process,
+     and without stopping the progress and the wave creation of the other
+     waves.  */
+  if (!need_print_waves)
+    {
+      for (auto &&wave_id : trapped_waves)
+        DBGAPI_CHECK (amd_dbgapi_wave_resume (wave_id,
+                                              AMD_DBGAPI_RESUME_MODE_NORMAL,
+                                              AMD_DBGAPI_EXCEPTION_NONE));
+      return;
+    }
 
-  /* TODO, we  should have a RAII object to handle forward progress wave
-     creation mode override.  */
-  DBGAPI_CHECK (amd_dbgapi_process_set_progress (
-      process_id, AMD_DBGAPI_PROGRESS_NO_FORWARD));
+  {
+    report_phase_timer_t timer (report_phase_t::stop);
 
-  DBGAPI_CHECK (amd_dbgapi_process_set_wave_creation (
-      process_id, AMD_DBGAPI_WAVE_CREATION_STOP));
+    /* TODO, we  should have a RAII object to handle forward progress wave
+       creation mode override.  */
+    DBGAPI_CHECK (amd_dbgapi_process_set_progress (
+        process_id, AMD_DBGAPI_PROGRESS_NO_FORWARD));
 
-  if (need_print_waves)
-    print_wavefronts (process_id, all_wavefronts);
+    DBGAPI_CHECK (amd_dbgapi_process_set_wave_creation (
+        process_id, AMD_DBGAPI_WAVE_CREATION_STOP));
+  }
+
+  print_wavefronts (process_id, code_objects, all_wavefronts, report_options,
+                    snapshot);
+
+  /* Resuming the waves delivers the exception to the runtime, which may
+     abort the process: the report, and its statistics, must be written
+     before.  */
+  finish_report (stats_scope, report_options, snapshot != nullptr);
 
   /* We now need to resume execution of the waves present.  This will allow any
      exception to be delivered to the runtime who will be able to act on it if
@@ -1000,11 +1949,13 @@ process_dbgapi_events (amd_dbgapi_process_id_t process_id, bool all_wavefronts)
                                                  AMD_DBGAPI_PROGRESS_NORMAL));
 }
 
-/* Main function of the accessory thread used to handle dbgapi.  The LISTEN_FD
-   parameter is the read end of a pipe where the main application can write
-   to instruct the worker thread to stop.  */
+/* Main function of the accessory thread used to handle dbgapi.  The
+   application threads send it commands through COMMANDS.  */
 void
-dbgapi_worker (int listen_fd, bool all_wavefronts, bool precise_memory)
+dbgapi_worker (command_queue_t &commands, bool all_wavefronts,
+               bool precise_memory,
+               bool preparse_code_objects, report_options_t report_options,
+               std::optional<std::string> snapshot_path)
 {
   amd_dbgapi_process_id_t process_id;
   amd_dbgapi_event_id_t event_id;
@@ -1063,10 +2014,11 @@ dbgapi_worker (int listen_fd, bool all_wavefronts, bool precise_memory)
   if (epoll_fd == -1)
     agent_error ("unable to create epoll instance: %s", strerror (errno));
 
-  ev.data.fd = listen_fd;
+  ev.data.fd = commands.doorbell_fd ();
   ev.events = EPOLLIN;
-  if (epoll_ctl (epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev) == -1)
-    agent_error ("Unable to add rocr notifier to the epoll instance: %s",
+  if (epoll_ctl (epoll_fd, EPOLL_CTL_ADD, commands.doorbell_fd (), &ev) == -1)
+    agent_error ("Unable to add the command doorbell to the epoll "
+                 "instance: %s",
                  strerror (errno));
 
   ev.data.fd = notifier;
@@ -1075,6 +2027,16 @@ dbgapi_worker (int listen_fd, bool all_wavefronts, bool precise_memory)
     agent_error ("Unable to add dbgapi notifier to the epoll instance: %s",
                  strerror (errno));
 
+  /* The code objects loaded in the process.  Only accessed from this
+     thread.  */
+  code_object_registry_t code_objects (process_id, g_code_objects_dir,
+                                       preparse_code_objects);
+
+  /* If set, the reports are saved in a snapshot instead of printed.  */
+  std::optional<snapshot_writer_t> snapshot;
+  if (snapshot_path)
+    snapshot.emplace (*snapshot_path);
+
   if (precise_memory)
     {
       amd_dbgapi_status_t r = amd_dbgapi_set_memory_precision (
@@ -1089,12 +2051,44 @@ dbgapi_worker (int listen_fd, bool all_wavefronts, bool precise_memory)
         }
     }
 
+  /* The completions of the code object list updates received in the current
+     batch of commands, to be reported with a single breakpoint hit.  */
+  std::vector<command_completion_t *> pending_updates;
+  auto report_code_object_list_update = [&] () {
+    if (pending_updates.empty ())
+      return;
+
+    agent_assert (g_rbrk_breakpoint_id.has_value ());
+    trace_span_t span ("r_brk", "updates", pending_updates.size ());
+    amd_dbgapi_breakpoint_action_t bpaction;
+    DBGAPI_CHECK (amd_dbgapi_report_breakpoint_hit (
+        g_rbrk_breakpoint_id.value (), 0, &bpaction));
+
+    for (auto *completion : pending_updates)
+      if (completion)
+        completion->complete ();
+    pending_updates.clear ();
+  };
+
+  auto print_waves = [&] (bool all_wavefronts, bool blank_line) {
+    if (blank_line && report_options.m_format == output_format_t::text)
+      agent_out << std::endl;
+
+    report_stats_scope_t stats_scope (report_options.m_stats);
+    print_wavefronts (process_id, code_objects, all_wavefronts,
+                      report_options, snapshot ? &*snapshot : nullptr);
+    finish_report (stats_scope, report_options, snapshot.has_value ());
+  };
+
   for (bool continue_event_loop = true; continue_event_loop;)
     {
       /* We can wait for events on at most 2 file descriptors.  */
       constexpr size_t max_events = 2;
       epoll_event evs[max_events];
 
+      /* Write the events of the previous batch before waiting.  */
+      flush_trace ();
+
       int nfd = epoll_wait (epoll_fd, evs, max_events, -1);
       if (nfd == -1 && errno == EINTR)
         continue;
@@ -1104,61 +2098,75 @@ dbgapi_worker (int listen_fd, bool all_wavefronts, bool precise_memory)
 
       for (int i = 0; i < nfd; i++)
         {
-          /* Make sure we purge all data from the pipe.  */
-          if (evs[i].data.fd == listen_fd)
+          if (evs[i].data.fd == commands.doorbell_fd ())
             {
-              char buf = '\0';
-              while (read (evs[i].data.fd, &buf, 1) == -1 && errno == EINTR)
-                ;
+              commands.acknowledge ();
 
-              switch (buf)
+              worker_command_t command;
+              while (commands.pop (command))
                 {
-                case 'p':
-                  print_wavefronts (process_id, true);
-                  break;
-                case 'q':
-                  /* It is time to exit the main event loop and detach dbgapi.
-                   */
-                  continue_event_loop = false;
-                  break;
-                case 'b':
-                  {
-                    /* We need the atomic load to ensure that the promise
-                       object we try to access is consistent with the
-                       requesting thread.  */
-                    [[maybe_unused]] bool promise_available
-                        = g_rbrk_sync.guard.load (
-                            std::memory_order::memory_order_acquire);
-
-                    agent_assert (promise_available);
-                    agent_assert (g_rbrk_sync.promise.has_value ());
-
-                    agent_assert (g_rbrk_breakpoint_id.has_value ());
-                    amd_dbgapi_breakpoint_action_t bpaction;
-                    DBGAPI_CHECK (amd_dbgapi_report_breakpoint_hit (
-                        g_rbrk_breakpoint_id.value (), 0, &bpaction));
-
-                    g_rbrk_sync.promise->set_value ();
-                    break;
-                  }
+                  /* The code object list changes of all the updates
+                     requested so far are visible in r_debug, so a single
+                     breakpoint hit reports them all.  */
+                  if (command.m_kind
+                      == worker_command_t::kind_t::update_code_object_list)
+                    {
+                      pending_updates.emplace_back (command.m_completion);
+                      continue;
+                    }
+
+                  /* Complete the updates requested before this command
+                     first, to execute the commands in order.  */
+                  report_code_object_list_update ();
+
+                  switch (command.m_kind)
+                    {
+                    case worker_command_t::kind_t::print_waves:
+                      print_waves (command.m_all_wavefronts,
+                                   command.m_blank_line);
+                      break;
+
+                    case worker_command_t::kind_t::quit:
+                      /* It is time to exit the main event loop and detach
+                         dbgapi.  */
+                      continue_event_loop = false;
+                      break;
+
+                    case worker_command_t::kind_t::update_code_object_list:
+                      break;
+                    }
+
+                  if (command.m_completion)
+                    command.m_completion->complete ();
                 }
+
+              report_code_object_list_update ();
+
+              /* The flag is set before the doorbell is rung, so it is seen
+                 after the acknowledge.  */
+              if (continue_event_loop
+                  && g_print_waves_pending.exchange (false))
+                print_waves (true, true);
             }
           else if (evs[i].data.fd == notifier)
             {
-              /* Drain the pipe.  */
-              int r;
-              do
-                {
-                  char buf;
-                  r = read (evs[i].data.fd, &buf, 1);
-              } while (r >= 0 || (r == -1 && errno == EINTR));
-              process_dbgapi_events (process_id, all_wavefronts);
+              drain_notifier (notifier);
+              process_dbgapi_events (process_id, code_objects,
+                                     all_wavefronts, report_options,
+                                     snapshot ? &*snapshot : nullptr);
             }
           else
             agent_error ("Unknown file descriptor %d", evs[i].data.fd);
         }
     }
 
+  /* Do not leave any thread waiting for a command that will not be
+     executed.  */
+  commands.acknowledge ();
+  for (worker_command_t command; commands.pop (command);)
+    if (command.m_completion)
+      command.m_completion->complete ();
+
   DBGAPI_CHECK (amd_dbgapi_process_detach (process_id));
   DBGAPI_CHECK (amd_dbgapi_finalize ());
 }
@@ -1174,28 +2182,37 @@ public:
   DebugAgentWorker &operator= (const DebugAgentWorker &) = delete;
   DebugAgentWorker &operator= (DebugAgentWorker &&) = delete;
 
-  void query_print_waves () const;
-  void update_code_object_list () const;
+  /* Request the worker thread to print all the wavefronts.  Never waits for
+     the worker thread, so it can be called by the SIGQUIT handler.  */
+  void query_print_waves ();
+
+  /* Request the worker thread to report that the code object list changed.
+     COMPLETION is completed once it is reported.  */
+  void update_code_object_list (command_completion_t &completion);
 
 private:
+  /* Declared before the thread so that it is created before the thread
+     starts, and destroyed after it is joined.  */
+  command_queue_t m_commands;
   std::thread m_worker_thread;
-  int m_write_pipe = -1;
 };
 
 DebugAgentWorker::DebugAgentWorker ()
 {
-  int pipefd[2];
-  if (pipe2 (pipefd, O_CLOEXEC) == -1)
-    agent_error ("failed to create pipe: %s", strerror (errno));
-
-  if (fcntl (pipefd[0], F_SETFL, O_NONBLOCK)
-      || fcntl (pipefd[1], F_SETFL, O_NONBLOCK))
-    agent_error ("failed to set pipe non-blocking: %s", strerror (errno));
+  /* The SIGQUIT handler pushes a command to the worker thread, so it must
+     not run on the worker thread.  The thread inherits the signal mask of
+     the thread creating it.  */
+  sigset_t sigquit_set, saved_set;
+  sigemptyset (&sigquit_set);
+  sigaddset (&sigquit_set, SIGQUIT);
+  pthread_sigmask (SIG_BLOCK, &sigquit_set, &saved_set);
 
-  m_write_pipe = pipefd[1];
+  m_worker_thread
+      = std::thread (dbgapi_worker, std::ref (m_commands), g_all_wavefronts,
+                     g_precise_emmory, g_preparse_code_objects,
+                     g_report_options, g_snapshot_path);
 
-  m_worker_thread = std::thread (dbgapi_worker, pipefd[0], g_all_wavefronts,
-                                 g_precise_emmory);
+  pthread_sigmask (SIG_SETMASK, &saved_set, nullptr);
 
   auto pthread_thread = m_worker_thread.native_handle ();
   if (pthread_setname_np (pthread_thread, "RocrDebugAgent") == -1)
@@ -1203,62 +2220,29 @@ DebugAgentWorker::DebugAgentWorker ()
 }
 
 void
-DebugAgentWorker::query_print_waves () const
+DebugAgentWorker::query_print_waves ()
 {
-  agent_assert (m_write_pipe != -1);
-  char msg = 'p';
-  ssize_t written = write (m_write_pipe, &msg, 1);
-  if (written == -1)
-    agent_error ("Failed to notify RocrDebugAgent thread (%s)",
-                 strerror (errno));
-  agent_assert (written == 1);
+  /* Called by the SIGQUIT handler, so it must not wait for the worker thread
+     to make room in the queue.  */
+  if (!m_commands.try_push (
+          { worker_command_t::kind_t::print_waves, true, nullptr, true }))
+    {
+      g_print_waves_pending.store (true);
+      m_commands.ring ();
+    }
 }
 
 void
-DebugAgentWorker::update_code_object_list () const
+DebugAgentWorker::update_code_object_list (command_completion_t &completion)
 {
-  agent_assert (m_write_pipe != -1);
-  /* It is OK to have this load removed if the assertion is not compiled in.
-     It does not have a role in synchronization.  */
-  agent_assert (
-      !g_rbrk_sync.guard.load (std::memory_order::memory_order_acquire));
-  agent_assert (!g_rbrk_sync.promise.has_value ());
-
-  /* Create the promise/future pair and make sure the promise is visible by
-     the worker thread.  */
-  g_rbrk_sync.promise.emplace ();
-  auto update_brk_future = g_rbrk_sync.promise->get_future ();
-  g_rbrk_sync.guard.store (true, std::memory_order::memory_order_release);
-
-  /* Use the pipe to notify the thread a code object list is requested.  */
-  char msg = 'b';
-  ssize_t written = write (m_write_pipe, &msg, 1);
-  if (written == -1)
-    agent_error ("Failed to notify RocrDebugAgent thread (%s)",
-                 strerror (errno));
-  agent_assert (written == 1);
-
-  /* Wait for the worker thread to acknoledge code object update has proceded
-     and reset the synch structure so it can be reused in a later call.  */
-  update_brk_future.wait ();
-  g_rbrk_sync.promise.reset ();
-  g_rbrk_sync.guard.store (false, std::memory_order::memory_order_release);
+  m_commands.push ({ worker_command_t::kind_t::update_code_object_list, false,
+                     &completion });
 }
 
 DebugAgentWorker::~DebugAgentWorker ()
 {
-  if (m_write_pipe != -1)
-    {
-      char msg = 'q';
-      ssize_t written = write (m_write_pipe, &msg, 1);
-      if (written == -1)
-        agent_error ("Failed to notify RocrDebugAgent thread (%s)",
-                     strerror (errno));
-      agent_assert (written == 1);
-      m_worker_thread.join ();
-      close (m_write_pipe);
-      m_write_pipe = -1;
-    }
+  m_commands.push ({ worker_command_t::kind_t::quit });
+  m_worker_thread.join ();
 }
 
 /* Forward declarations of the WorkerThreadAccess factory.  */
@@ -1300,10 +2284,15 @@ public:
       m_worker.reset ();
   }
 
-  void update_code_object_list ()
+  /* Return false if the worker thread is not running, and COMPLETION will
+     not be completed.  */
+  bool update_code_object_list (command_completion_t &completion)
   {
-    if (m_worker.has_value ())
-      m_worker->update_code_object_list ();
+    if (!m_worker.has_value ())
+      return false;
+
+    m_worker->update_code_object_list (completion);
+    return true;
   }
 
   void query_print_waves ()
@@ -1352,18 +2341,34 @@ hsa_status_t
 debug_agent_hsa_executable_freeze (hsa_executable_t executable,
                                    const char *options)
 {
+  trace_span_t span ("hsa_executable_freeze");
   auto v = original_hsa_executable_freeze (executable, options);
 
-  get_worker_thread ().update_code_object_list ();
+  /* Wait outside of the worker thread access lock, so that the updates
+     requested by concurrent calls are coalesced.  */
+  command_completion_t completion;
+  if (get_worker_thread ().update_code_object_list (completion))
+    {
+      trace_span_t wait_span ("code object list update");
+      completion.wait ();
+    }
   return v;
 }
 
 hsa_status_t
 debug_agent_hsa_executable_destroy (hsa_executable_t executable)
 {
+  trace_span_t span ("hsa_executable_destroy");
   auto v = original_hsa_executable_destroy (executable);
 
-  get_worker_thread ().update_code_object_list ();
+  /* Wait outside of the worker thread access lock, so that the updates
+     requested by concurrent calls are coalesced.  */
+  command_completion_t completion;
+  if (get_worker_thread ().update_code_object_list (completion))
+    {
+      trace_span_t wait_span ("code object list update");
+      completion.wait ();
+    }
   return v;
 }
 
@@ -1375,6 +2380,8 @@ OnLoad (void *table, uint64_t runtime_version, uint64_t failed_tool_count,
         const char *const *failed_tool_names)
 {
   bool disable_sigquit{ false };
+  int output_fd{ -1 };
+  std::optional<std::string> trace_path;
 
   set_log_level (log_level_t::warning);
 
@@ -1398,6 +2405,16 @@ OnLoad (void *table, uint64_t runtime_version, uint64_t failed_tool_count,
           { "output", required_argument, nullptr, 'o' },
           { "save-code-objects", optional_argument, nullptr, 's' },
           { "precise-memory", no_argument, nullptr, 'p' },
+          { "preparse-code-objects", no_argument, nullptr,
+            option_preparse_code_objects },
+          { "aggregate-waves", optional_argument, nullptr,
+            option_aggregate_waves },
+          { "compact", no_argument, nullptr, option_compact },
+          { "snapshot", required_argument, nullptr, option_snapshot },
+          { "format", required_argument, nullptr, option_format },
+          { "stop-timeout", required_argument, nullptr, option_stop_timeout },
+          { "stats", no_argument, nullptr, option_stats },
+          { "trace", required_argument, nullptr, option_trace },
           { "help", no_argument, nullptr, 'h' },
           { 0 } };
 
@@ -1433,6 +2450,87 @@ OnLoad (void *table, uint64_t runtime_version, uint64_t failed_tool_count,
           g_precise_emmory = true;
           break;
 
+        case option_preparse_code_objects: /* --preparse-code-objects  */
+          g_preparse_code_objects = true;
+          break;
+
+        case option_compact: /* --compact  */
+          g_report_options.m_compact = true;
+          break;
+
+        case option_stats: /* --stats  */
+          g_report_options.m_stats = true;
+          break;
+
+        case option_trace: /* --trace  */
+          if (!argument)
+            print_usage ();
+
+          trace_path = *argument;
+          break;
+
+        case option_snapshot: /* --snapshot  */
+          if (!argument)
+            print_usage ();
+
+          g_snapshot_path = *argument;
+          break;
+
+        case option_format: /* --format  */
+          if (!argument)
+            print_usage ();
+
+          if (argument == "text")
+            g_report_options.m_format = output_format_t::text;
+          else if (argument == "ndjson")
+            g_report_options.m_format = output_format_t::ndjson;
+          else
+            print_usage ();
+          break;
+
+        case option_stop_timeout: /* --stop-timeout  */
+          {
+            if (!argument)
+              print_usage ();
+
+            char *end;
+            errno = 0;
+            unsigned long timeout = strtoul (argument->c_str (), &end, 10);
+            if (argument->empty () || *end != '\0' || errno
+                || argument->front () == '-')
+              {
+                std::cerr << "error: Invalid timeout `" << *argument << "'"
+                          << std::endl;
+                print_usage ();
+              }
+
+            g_report_options.m_stop_timeout
+                = std::chrono::milliseconds (timeout);
+            break;
+          }
+
+        case option_aggregate_waves: /* --aggregate-waves  */
+          if (argument)
+            {
+              char *end;
+              errno = 0;
+              unsigned long count = strtoul (argument->c_str (), &end, 10);
+              if (argument->empty () || *end != '\0' || errno
+                  || argument->front () == '-')
+                {
+                  std::cerr << "error: Invalid wavefront count `" << *argument
+                            << "'" << std::endl;
+                  print_usage ();
+                }
+
+              g_report_options.m_aggregate_waves = count;
+            }
+          else
+            {
+              g_report_options.m_aggregate_waves = 1;
+            }
+          break;
+
         case 'l': /* -l or --log-level  */
           if (!argument)
             print_usage ();
@@ -1476,8 +2574,12 @@ OnLoad (void *table, uint64_t runtime_version, uint64_t failed_tool_count,
           if (!argument)
             print_usage ();
 
-          agent_out.open (*argument);
-          if (!agent_out.is_open ())
+          if (output_fd != -1)
+            close (output_fd);
+
+          output_fd = open (argument->c_str (),
+                            O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+          if (output_fd == -1)
             {
               std::cerr << "could not open `" << *argument << "'" << std::endl;
               abort ();
@@ -1496,11 +2598,26 @@ OnLoad (void *table, uint64_t runtime_version, uint64_t failed_tool_count,
 
   std::for_each (args.begin (), args.end (), [] (char *str) { free (str); });
 
-  if (!agent_out.is_open ())
+  set_agent_out_fd (output_fd != -1 ? output_fd : STDERR_FILENO);
+  set_log_records (g_report_options.m_format == output_format_t::ndjson
+                   && !g_snapshot_path);
+
+  /* The trace must be enabled before the threads recording events are
+     started.  */
+  if (trace_path)
     {
-      agent_out.copyfmt (std::cerr);
-      agent_out.clear (std::cerr.rdstate ());
-      agent_out.basic_ios<char>::rdbuf (std::cerr.rdbuf ());
+      if (!open_trace (*trace_path))
+        {
+          std::cerr << "could not open `" << *trace_path << "'"
+                    << std::endl;
+          abort ();
+        }
+
+      /* Terminate the trace when the process exits, even if the agent is
+         not unloaded.  Registered after set_agent_out_fd and before the
+         worker thread is started, so that it runs after the worker thread
+         has stopped, and before agent_out is flushed.  */
+      std::atexit (close_trace);
     }
 
   get_worker_thread ().start ();
@@ -1513,7 +2630,6 @@ OnLoad (void *table, uint64_t runtime_version, uint64_t failed_tool_count,
       sigemptyset (&sig_action.sa_mask);
 
       sig_action.sa_sigaction = [] (int signal, siginfo_t *, void *) {
-        agent_out << std::endl;
         get_worker_thread ().query_print_waves ();
       };
 
@@ -1537,4 +2653,6 @@ void
 OnUnload ()
 {
   get_worker_thread ().stop ();
+  close_trace ();
+  flush_agent_out ();
 }
@@ -0,0 +1,230 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#include "json_writer.h"
+#include "debug.h"
+
+#include <array>
+#include <charconv>
+#include <string_view>
+
+namespace amd::debug_agent
+{
+
+void
+json_writer_t::separate ()
+{
+  if (m_after_key)
+    {
+      m_after_key = false;
+      return;
+    }
+
+  if (!m_levels.empty ())
+    {
+      if (m_levels.back ())
+        m_out.put (',');
+      m_levels.back () = true;
+    }
+}
+
+void
+json_writer_t::begin_object ()
+{
+  separate ();
+  m_out.put ('{');
+  m_levels.push_back (false);
+}
+
+void
+json_writer_t::end_object ()
+{
+  agent_assert (!m_levels.empty () && !m_after_key);
+  m_levels.pop_back ();
+  m_out.put ('}');
+}
+
+void
+json_writer_t::begin_array ()
+{
+  separate ();
+  m_out.put ('[');
+  m_levels.push_back (false);
+}
+
+void
+json_writer_t::end_array ()
+{
+  agent_assert (!m_levels.empty () && !m_after_key);
+  m_levels.pop_back ();
+  m_out.put (']');
+}
+
+json_writer_t &
+json_writer_t::key (std::string_view name)
+{
+  agent_assert (!m_levels.empty () && !m_after_key);
+  separate ();
+  write_string (name);
+  m_out.put (':');
+  m_after_key = true;
+  return *this;
+}
+
+void
+json_writer_t::value (std::string_view string)
+{
+  separate ();
+  write_string (string);
+}
+
+void
+json_writer_t::value (bool boolean)
+{
+  separate ();
+  m_out << (boolean ? "true" : "false");
+}
+
+void
+json_writer_t::null ()
+{
+  separate ();
+  m_out << "null";
+}
+
+void
+json_writer_t::fixed_value (uint64_t number, unsigned decimals)
+{
+  agent_assert (decimals < 20);
+
+  uint64_t scale = 1;
+  for (unsigned i = 0; i < decimals; ++i)
+    scale *= 10;
+
+  separate ();
+  write_integer (number / scale);
+  if (!decimals)
+    return;
+
+  std::array<char, 20> buffer;
+  uint64_t fraction = number % scale;
+  for (unsigned i = decimals; i > 0; --i, fraction /= 10)
+    buffer[i - 1] = '0' + fraction % 10;
+
+  m_out.put ('.');
+  m_out.write (buffer.data (), decimals);
+}
+
+void
+json_writer_t::hex_value (uint64_t number)
+{
+  std::array<char, 2 + 16> buffer{ '0', 'x' };
+  auto [end, ec] = std::to_chars (buffer.data () + 2,
+                                  buffer.data () + buffer.size (), number, 16);
+  value (std::string_view (buffer.data (), end - buffer.data ()));
+}
+
+void
+json_writer_t::hex_value (const uint8_t *value, size_t size)
+{
+  static constexpr char hex_digits[] = "0123456789abcdef";
+
+  separate ();
+  m_out << "\"0x";
+  for (size_t pos = size; pos > 0; --pos)
+    m_out.put (hex_digits[value[pos - 1] >> 4])
+        .put (hex_digits[value[pos - 1] & 0xF]);
+  m_out.put ('"');
+}
+
+void
+json_writer_t::write_string (std::string_view string)
+{
+  static constexpr char hex_digits[] = "0123456789abcdef";
+
+  m_out.put ('"');
+
+  /* Write the runs of characters that need no escaping at once.  */
+  size_t run_start = 0;
+  for (size_t i = 0; i < string.size (); ++i)
+    {
+      unsigned char c = string[i];
+      if (c >= 0x20 && c != '"' && c != '\\')
+        continue;
+
+      m_out.write (string.data () + run_start, i - run_start);
+      run_start = i + 1;
+
+      switch (c)
+        {
+        case '"':
+          m_out << "\\\"";
+          break;
+        case '\\':
+          m_out << "\\\\";
+          break;
+        case '\n':
+          m_out << "\\n";
+          break;
+        case '\r':
+          m_out << "\\r";
+          break;
+        case '\t':
+          m_out << "\\t";
+          break;
+        default:
+          m_out << "\\u00" << hex_digits[c >> 4] << hex_digits[c & 0xF];
+          break;
+        }
+    }
+  m_out.write (string.data () + run_start, string.size () - run_start);
+
+  m_out.put ('"');
+}
+
+void
+json_writer_t::write_integer (int64_t number)
+{
+  std::array<char, 24> buffer;
+  auto [end, ec] = std::to_chars (buffer.data (),
+                                  buffer.data () + buffer.size (), number);
+  m_out.write (buffer.data (), end - buffer.data ());
+}
+
+void
+json_writer_t::write_integer (uint64_t number)
+{
+  std::array<char, 24> buffer;
+  auto [end, ec] = std::to_chars (buffer.data (),
+                                  buffer.data () + buffer.size (), number);
+  m_out.write (buffer.data (), end - buffer.data ());
+}
+
+} /* namespace amd::debug_agent */
@@ -0,0 +1,115 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#ifndef _ROCM_DEBUG_AGENT_JSON_WRITER_H
+#define _ROCM_DEBUG_AGENT_JSON_WRITER_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace amd::debug_agent
+{
+
+/* A streaming JSON writer.  Values are written to the output stream as they
+   are added, so no document is built in memory.  The writer only checks that
+   commas and colons are placed correctly; the caller is responsible for
+   balancing objects and arrays, and for adding a key before each member of
+   an object.  */
+class json_writer_t
+{
+public:
+  explicit json_writer_t (std::ostream &out) : m_out (out) {}
+
+  json_writer_t (const json_writer_t &) = delete;
+  json_writer_t &operator= (const json_writer_t &) = delete;
+
+  void begin_object ();
+  void end_object ();
+
+  void begin_array ();
+  void end_array ();
+
+  /* Add the key of the next member of the current object.  */
+  json_writer_t &key (std::string_view name);
+
+  void value (std::string_view string);
+  void value (const char *string) { value (std::string_view (string)); }
+  void value (bool boolean);
+  void null ();
+
+  template <typename T>
+  std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>
+  value (T number)
+  {
+    separate ();
+    if constexpr (std::is_signed_v<T>)
+      write_integer (static_cast<int64_t> (number));
+    else
+      write_integer (static_cast<uint64_t> (number));
+  }
+
+  /* Add the number NUMBER / 10^DECIMALS, with DECIMALS digits after the
+     decimal point.  */
+  void fixed_value (uint64_t number, unsigned decimals);
+
+  /* Add a string holding NUMBER in hexadecimal, prefixed with "0x".  JSON
+     numbers cannot hold 64-bit addresses without loss in most readers.  */
+  void hex_value (uint64_t number);
+
+  /* Add a string holding the SIZE bytes little-endian VALUE in hexadecimal,
+     most significant byte first.  */
+  void hex_value (const uint8_t *value, size_t size);
+
+  /* Return true if no value is pending completion, i.e. a complete JSON
+     value was written.  */
+  bool complete () const { return m_levels.empty (); }
+
+private:
+  /* Write the separator needed before a new value.  */
+  void separate ();
+  void write_string (std::string_view string);
+  void write_integer (int64_t number);
+  void write_integer (uint64_t number);
+
+  std::ostream &m_out;
+
+  /* For each open object or array, true if a value was already written in
+     it.  */
+  std::vector<bool> m_levels;
+  bool m_after_key{ false };
+};
+
+} /* namespace amd::debug_agent */
+
+#endif /* _ROCM_DEBUG_AGENT_JSON_WRITER_H */
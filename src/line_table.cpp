@@ -0,0 +1,279 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#include "line_table.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace amd::debug_agent
+{
+
+file_table_t::file_index_t
+file_table_t::intern (std::string_view name)
+{
+  auto [it, inserted] = m_indices.try_emplace (std::string (name),
+                                               m_names.size ());
+  if (inserted)
+    m_names.emplace_back (&it->first);
+
+  return it->second;
+}
+
+std::optional<file_table_t::file_index_t>
+file_table_t::find (std::string_view name) const
+{
+  if (auto it = m_indices.find (std::string (name)); it != m_indices.end ())
+    return it->second;
+
+  return std::nullopt;
+}
+
+void
+line_table_t::fragment_t::add (address_t address, const char *file_name,
+                               line_number_t line)
+{
+  if (!file_name)
+    file_name = "";
+
+  if (file_name != m_last_file_name)
+    {
+      m_last_file = m_file_table.intern (file_name);
+      m_last_file_name = file_name;
+    }
+
+  m_addresses.push_back (address);
+  m_files.push_back (m_last_file);
+  m_lines.push_back (line);
+}
+
+void
+line_table_t::merge (const fragment_t &fragment)
+{
+  /* Map the fragment's file indices to this table's.  */
+  std::vector<file_index_t> files (fragment.m_file_table.size ());
+  for (file_index_t i = 0; i < files.size (); ++i)
+    files[i] = m_file_table.intern (fragment.m_file_table.name (i));
+
+  m_addresses.insert (m_addresses.end (), fragment.m_addresses.begin (),
+                      fragment.m_addresses.end ());
+  m_lines.insert (m_lines.end (), fragment.m_lines.begin (),
+                  fragment.m_lines.end ());
+  m_ends.insert (m_ends.end (), fragment.m_ends.begin (),
+                 fragment.m_ends.end ());
+
+  m_files.reserve (m_files.size () + fragment.m_files.size ());
+  for (auto file : fragment.m_files)
+    m_files.push_back (files[file]);
+}
+
+std::vector<uint32_t>
+line_table_t::reorder (const std::vector<uint32_t> &order)
+{
+  std::vector<uint32_t> positions (order.size (), npos);
+
+  std::vector<address_t> addresses;
+  std::vector<file_index_t> files;
+  std::vector<line_number_t> lines;
+  addresses.reserve (order.size ());
+  files.reserve (order.size ());
+  lines.reserve (order.size ());
+
+  for (auto index : order)
+    {
+      if (!addresses.empty () && addresses.back () == m_addresses[index])
+        continue;
+
+      positions[index] = addresses.size ();
+      addresses.push_back (m_addresses[index]);
+      files.push_back (m_files[index]);
+      lines.push_back (m_lines[index]);
+    }
+
+  m_addresses = std::move (addresses);
+  m_files = std::move (files);
+  m_lines = std::move (lines);
+
+  return positions;
+}
+
+void
+line_table_t::finalize ()
+{
+  std::vector<uint32_t> order (m_addresses.size ());
+  std::iota (order.begin (), order.end (), 0);
+
+  /* The sort is stable so that among rows with the same address, the first
+     one merged is kept.  */
+  std::stable_sort (order.begin (), order.end (), [this] (auto lhs, auto rhs) {
+    return m_addresses[lhs] < m_addresses[rhs];
+  });
+
+  reorder (order);
+
+  std::sort (m_ends.begin (), m_ends.end ());
+  m_ends.erase (std::unique (m_ends.begin (), m_ends.end ()), m_ends.end ());
+
+  /* The rows are now sorted by address, so sorting by file, line and row
+     index keeps the rows of each line sorted by address.  */
+  m_line_index.resize (m_addresses.size ());
+  std::iota (m_line_index.begin (), m_line_index.end (), 0);
+  std::sort (m_line_index.begin (), m_line_index.end (),
+             [this] (auto lhs, auto rhs) {
+               return line_index_less (lhs, rhs);
+             });
+}
+
+void
+line_table_t::insert (const fragment_t &fragment)
+{
+  const size_t table_size = m_addresses.size ();
+  const size_t table_ends = m_ends.size ();
+
+  merge (fragment);
+
+  /* Sort the fragment's rows, then merge them after the table's rows of the
+     same address, so that the table's rows are kept.  */
+  auto address_less = [this] (auto lhs, auto rhs) {
+    return m_addresses[lhs] < m_addresses[rhs];
+  };
+
+  std::vector<uint32_t> order (m_addresses.size ());
+  std::iota (order.begin (), order.end (), 0);
+  std::stable_sort (order.begin () + table_size, order.end (), address_less);
+  std::inplace_merge (order.begin (), order.begin () + table_size,
+                      order.end (), address_less);
+
+  std::vector<uint32_t> positions = reorder (order);
+
+  std::sort (m_ends.begin () + table_ends, m_ends.end ());
+  std::inplace_merge (m_ends.begin (), m_ends.begin () + table_ends,
+                      m_ends.end ());
+  m_ends.erase (std::unique (m_ends.begin (), m_ends.end ()), m_ends.end ());
+
+  /* The table's rows keep their relative order, so their reverse index
+     remains sorted once renumbered.  The fragment's rows that were kept are
+     sorted on their own, and merged into it.  */
+  for (auto &row : m_line_index)
+    row = positions[row];
+
+  const size_t index_size = m_line_index.size ();
+  for (size_t i = table_size; i < positions.size (); ++i)
+    if (positions[i] != npos)
+      m_line_index.push_back (positions[i]);
+
+  auto line_less = [this] (auto lhs, auto rhs) {
+    return line_index_less (lhs, rhs);
+  };
+  std::sort (m_line_index.begin () + index_size, m_line_index.end (),
+             line_less);
+  std::inplace_merge (m_line_index.begin (),
+                      m_line_index.begin () + index_size, m_line_index.end (),
+                      line_less);
+}
+
+std::optional<size_t>
+line_table_t::find (address_t address) const
+{
+  auto it = std::lower_bound (m_addresses.begin (), m_addresses.end (),
+                              address);
+  if (it == m_addresses.end () || *it != address)
+    return std::nullopt;
+
+  return it - m_addresses.begin ();
+}
+
+size_t
+line_table_t::upper_bound (address_t address) const
+{
+  return std::upper_bound (m_addresses.begin (), m_addresses.end (), address)
+         - m_addresses.begin ();
+}
+
+std::pair<std::vector<uint32_t>::const_iterator,
+          std::vector<uint32_t>::const_iterator>
+line_table_t::line_rows (file_index_t file, line_number_t line) const
+{
+  auto key = [this] (uint32_t row) {
+    return std::make_pair (m_files[row], m_lines[row]);
+  };
+  auto value = std::make_pair (file, line);
+
+  auto first = std::lower_bound (
+      m_line_index.begin (), m_line_index.end (), value,
+      [&] (uint32_t row, const auto &value) { return key (row) < value; });
+  auto last = std::upper_bound (
+      first, m_line_index.end (), value,
+      [&] (const auto &value, uint32_t row) { return value < key (row); });
+
+  return { first, last };
+}
+
+bool
+line_table_t::contains (file_index_t file, line_number_t line,
+                        address_t low, address_t high) const
+{
+  auto [first, last] = line_rows (file, line);
+  return std::any_of (first, last, [&] (uint32_t row) {
+    return m_addresses[row] >= low && m_addresses[row] < high;
+  });
+}
+
+std::vector<std::pair<line_table_t::address_t, line_table_t::address_t>>
+line_table_t::address_ranges (file_index_t file, line_number_t line) const
+{
+  std::vector<std::pair<address_t, address_t>> ranges;
+
+  auto [first, last] = line_rows (file, line);
+  for (auto it = first; it != last; ++it)
+    {
+      size_t row = *it;
+      address_t start = m_addresses[row];
+      address_t end
+          = (row + 1) < m_addresses.size () ? m_addresses[row + 1] : start;
+
+      /* The next row may be in another sequence, or another compilation
+         unit, past a gap.  */
+      if (auto end_it = std::upper_bound (m_ends.begin (), m_ends.end (),
+                                          start);
+          end_it != m_ends.end () && (end == start || *end_it < end))
+        end = *end_it;
+
+      if (!ranges.empty () && ranges.back ().second == start)
+        ranges.back ().second = end;
+      else
+        ranges.emplace_back (start, end);
+    }
+
+  return ranges;
+}
+
+} /* namespace amd::debug_agent */
@@ -0,0 +1,215 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#ifndef _ROCM_DEBUG_AGENT_LINE_TABLE_H
+#define _ROCM_DEBUG_AGENT_LINE_TABLE_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace amd::debug_agent
+{
+
+/* A table of interned file names.  Each distinct name is stored once, and is
+   referred to by its index in the table.  */
+class file_table_t
+{
+public:
+  using file_index_t = std::uint32_t;
+
+  file_table_t () = default;
+
+  /* The names point into the table's own map, which keeps its elements when
+     it is moved, but not when it is copied.  */
+  file_table_t (const file_table_t &) = delete;
+  file_table_t (file_table_t &&) = default;
+  file_table_t &operator= (const file_table_t &) = delete;
+  file_table_t &operator= (file_table_t &&) = default;
+
+  /* Return the index of NAME, adding it to the table if needed.  */
+  file_index_t intern (std::string_view name);
+
+  /* Return the index of NAME if it is in the table.  */
+  std::optional<file_index_t> find (std::string_view name) const;
+
+  size_t size () const { return m_names.size (); }
+  const std::string &name (file_index_t index) const
+  {
+    return *m_names[index];
+  }
+
+private:
+  std::unordered_map<std::string, file_index_t> m_indices;
+  /* The keys of m_indices, in index order.  Node based containers never move
+     their elements, so the pointers remain valid.  */
+  std::vector<const std::string *> m_names;
+};
+
+/* A table of source line information sorted by address.  Like the symbol
+   table, it is stored as a structure of arrays: each row is an address, a
+   file index into an interned file name table, and a line number.  A row
+   covers the addresses up to the next row's address, or up to the end of
+   its sequence if that comes first.
+
+   The table is built from fragments, typically one per compilation unit,
+   that can be filled independently, then merged into the table.
+
+   The table also has a reverse index, the row indices sorted by file, line
+   and address, to find the rows of a source line.  */
+class line_table_t
+{
+public:
+  using address_t = std::uint64_t;
+  using file_index_t = file_table_t::file_index_t;
+  using line_number_t = std::uint32_t;
+
+  /* The rows of a single compilation unit's line table.  File indices are
+     local to the fragment, and are remapped when it is merged.  */
+  class fragment_t
+  {
+  public:
+    /* Add a row mapping ADDRESS to LINE in FILE_NAME.  */
+    void add (address_t address, const char *file_name, line_number_t line);
+
+    /* End the range of the previous row at ADDRESS, for the end of a
+       sequence or a row without a line number.  */
+    void add_end (address_t address) { m_ends.push_back (address); }
+
+    bool empty () const { return m_addresses.empty (); }
+
+  private:
+    friend class line_table_t;
+
+    file_table_t m_file_table;
+    std::vector<address_t> m_addresses;
+    std::vector<file_index_t> m_files;
+    std::vector<line_number_t> m_lines;
+    std::vector<address_t> m_ends;
+
+    /* Consecutive rows are usually in the same file, and the DWARF reader
+       returns the same string for each row of a file, so remember the last
+       file name interned to avoid hashing it again.  */
+    const char *m_last_file_name{ nullptr };
+    file_index_t m_last_file{ 0 };
+  };
+
+  /* Append FRAGMENT's rows to the table.  */
+  void merge (const fragment_t &fragment);
+
+  /* Sort the rows by address, and build the reverse index.  If more than one
+     row is defined for an address, only the first one merged is kept.  Must
+     be called after the last fragment is merged, and before any lookup.  */
+  void finalize ();
+
+  /* Add FRAGMENT's rows to the finalized table, and keep it finalized.  Only
+     the fragment's rows are sorted, then merged with the table's, so adding
+     a fragment to a large table costs much less than merging it and
+     finalizing the table again.  The rows for an address already in the
+     table are dropped.  */
+  void insert (const fragment_t &fragment);
+
+  size_t size () const { return m_addresses.size (); }
+
+  /* Return the index of the row for ADDRESS.  */
+  std::optional<size_t> find (address_t address) const;
+
+  /* Return the index of the first row with an address greater than
+     ADDRESS, or size () if there is none.  */
+  size_t upper_bound (address_t address) const;
+
+  /* Return true if any row with an address in [LOW, HIGH) maps to LINE in
+     FILE.  */
+  bool contains (file_index_t file, line_number_t line, address_t low,
+                 address_t high) const;
+
+  /* Return the [start, end) address ranges of the rows mapping to LINE in
+     FILE, sorted by address.  Contiguous ranges are coalesced.  A row
+     followed by neither another row nor the end of its sequence has an
+     empty range.  */
+  std::vector<std::pair<address_t, address_t>>
+  address_ranges (file_index_t file, line_number_t line) const;
+
+  /* Return the index of FILE_NAME in the file name table.  */
+  std::optional<file_index_t> find_file (std::string_view file_name) const
+  {
+    return m_file_table.find (file_name);
+  }
+
+  address_t address (size_t index) const { return m_addresses[index]; }
+  file_index_t file (size_t index) const { return m_files[index]; }
+  line_number_t line (size_t index) const { return m_lines[index]; }
+
+  const std::string &file_name (file_index_t file) const
+  {
+    return m_file_table.name (file);
+  }
+
+private:
+  file_table_t m_file_table;
+  std::vector<address_t> m_addresses;
+  std::vector<file_index_t> m_files;
+  std::vector<line_number_t> m_lines;
+
+  /* The addresses ending the range of the row before them, sorted.  */
+  std::vector<address_t> m_ends;
+
+  /* Rewrite the rows in ORDER, a permutation of the row indices sorted by
+     address, keeping only the first row of each address.  Return the new
+     index of each row, or npos if it was dropped.  */
+  static constexpr uint32_t npos = UINT32_MAX;
+  std::vector<uint32_t> reorder (const std::vector<uint32_t> &order);
+
+  /* Return true if the reverse index orders row LHS before row RHS.  */
+  bool line_index_less (uint32_t lhs, uint32_t rhs) const
+  {
+    if (m_files[lhs] != m_files[rhs])
+      return m_files[lhs] < m_files[rhs];
+    if (m_lines[lhs] != m_lines[rhs])
+      return m_lines[lhs] < m_lines[rhs];
+    return lhs < rhs;
+  }
+
+  /* Return the range of m_line_index holding the rows for LINE in FILE.  */
+  std::pair<std::vector<uint32_t>::const_iterator,
+            std::vector<uint32_t>::const_iterator>
+  line_rows (file_index_t file, line_number_t line) const;
+
+  std::vector<uint32_t> m_line_index;
+};
+
+} /* namespace amd::debug_agent */
+
+#endif /* _ROCM_DEBUG_AGENT_LINE_TABLE_H */
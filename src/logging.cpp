@@ -29,12 +29,17 @@
    DEALINGS WITH THE SOFTWARE.  */
 
 #include "logging.h"
+#include "json_writer.h"
+#include "output_buffer.h"
 
 #include <amd-dbgapi/amd-dbgapi.h>
 #include <cstdio>
+#include <cstdlib>
 #include <stdarg.h>
 
+#include <sstream>
 #include <string>
+#include <utility>
 
 namespace amd::debug_agent
 {
@@ -43,6 +48,98 @@ log_level_t log_level = log_level_t::warning;
 
 std::ofstream agent_out;
 
+/* Never destroyed, so that agent_out can be used until the process exits.  */
+static async_output_buffer_t *agent_out_buffer;
+
+static bool log_records = false;
+
+void
+set_agent_out_fd (int fd)
+{
+  agent_out_buffer = new async_output_buffer_t (fd);
+  agent_out.basic_ios<char>::rdbuf (agent_out_buffer);
+
+  /* Write the output still buffered when the process exits.  Registered
+     before the worker thread is started, so that it runs after the worker
+     thread has stopped.  */
+  std::atexit (flush_agent_out);
+}
+
+void
+flush_agent_out ()
+{
+  if (agent_out_buffer)
+    agent_out_buffer->flush ();
+  else
+    agent_out.flush ();
+}
+
+size_t
+agent_out_put_count ()
+{
+  return agent_out_buffer ? agent_out_buffer->put_count () : 0;
+}
+
+void
+write_agent_out_line (std::string line)
+{
+  line += '\n';
+
+  if (agent_out_buffer)
+    agent_out_buffer->append (line.data (), line.size ());
+  else
+    agent_out << line << std::flush;
+}
+
+void
+set_log_records (bool records)
+{
+  log_records = records;
+}
+
+void
+write_log_message (const char *source, log_level_t level,
+                   std::string_view message)
+{
+  if (!log_records)
+    {
+      std::string line (source);
+      line += ": ";
+      line += message;
+      write_agent_out_line (std::move (line));
+      return;
+    }
+
+  const char *level_name = "";
+  switch (level)
+    {
+    case log_level_t::none:
+    case log_level_t::error:
+      level_name = "error";
+      break;
+    case log_level_t::warning:
+      level_name = "warning";
+      break;
+    case log_level_t::info:
+      level_name = "info";
+      break;
+    case log_level_t::verbose:
+      level_name = "verbose";
+      break;
+    }
+
+  std::ostringstream record;
+  json_writer_t json (record);
+  json.begin_object ();
+  json.key ("type").value ("log");
+  json.key ("source").value (source);
+  json.key ("level").value (level_name);
+  json.key ("message").value (message);
+  json.end_object ();
+
+  write_agent_out_line (std::move (record).str ());
+}
+
 namespace detail
 {
 
@@ -51,23 +148,26 @@ log (log_level_t level, const char *format, ...)
 {
   va_list va;
 
-  agent_out << "rocm-debug-agent: ";
+  /* Records hold the level in a member of their own.  */
+  std::string message;
 
-  if (level == log_level_t::error)
-    agent_out << "error: ";
-  else if (level == log_level_t::warning)
-    agent_out << "warning: ";
+  if (!log_records && level == log_level_t::error)
+    message += "error: ";
+  else if (!log_records && level == log_level_t::warning)
+    message += "warning: ";
 
   va_start (va, format);
   size_t size = vsnprintf (NULL, 0, format, va);
   va_end (va);
 
+  const size_t prefix_size = message.size ();
+  message.resize (prefix_size + size);
+
   va_start (va, format);
-  std::string str (size, '\0');
-  vsprintf (&str[0], format, va);
+  vsprintf (&message[prefix_size], format, va);
   va_end (va);
 
-  agent_out << str << std::endl;
+  write_log_message ("rocm-debug-agent", level, message);
 }
 
 } /* namespace detail */
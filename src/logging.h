@@ -31,7 +31,10 @@
 #ifndef _ROCM_DEBUG_AGENT_LOGGING_H
 #define _ROCM_DEBUG_AGENT_LOGGING_H 1
 
+#include <cstddef>
 #include <fstream>
+#include <string>
+#include <string_view>
 
 namespace amd::debug_agent
 {
@@ -52,8 +55,39 @@ enum class log_level_t
 
 extern log_level_t log_level;
 
+/* The stream the reports and the log messages are written to.  Only one
+   thread at a time, the worker thread while it runs, may insert characters
+   in it.  Other threads write whole lines with write_agent_out_line.  */
 extern std::ofstream agent_out;
 
+/* Send the output of agent_out to FD, through a buffer written by a
+   background thread.  Flushing agent_out, for example with std::endl, then
+   no longer waits for the output to be written.  Must be called at most
+   once.  */
+void set_agent_out_fd (int fd);
+
+/* Wait until all the output of agent_out is written to its file.  Called at
+   the end of each report, and before aborting the process.  */
+void flush_agent_out ();
+
+/* The number of characters put in agent_out so far.  */
+size_t agent_out_put_count ();
+
+/* Write LINE and a new line to agent_out at once, without using the
+   formatting state of the stream.  Can be called by any thread once
+   set_agent_out_fd is called.  */
+void write_agent_out_line (std::string line);
+
+/* Write the log messages as newline-delimited JSON records instead of lines
+   of text, so that they do not break the reports written as records.  */
+void set_log_records (bool records);
+
+/* Write MESSAGE, logged at LEVEL by SOURCE, to agent_out.  It is written as
+   the line "SOURCE: MESSAGE", or as a "log" record if set_log_records was
+   called.  Can be called by any thread once set_agent_out_fd is called.  */
+void write_log_message (const char *source, log_level_t level,
+                        std::string_view message);
+
 namespace detail
 {
 
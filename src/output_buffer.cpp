@@ -0,0 +1,223 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#include "output_buffer.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace amd::debug_agent
+{
+
+/* The size of the put area.  The stream is usually flushed after each line,
+   before the put area is full.  */
+constexpr size_t put_area_size = 64 << 10;
+
+async_output_buffer_t::async_output_buffer_t (int fd, size_t buffer_size)
+    : m_fd (fd), m_put_area (put_area_size), m_front (buffer_size),
+      m_back (buffer_size)
+{
+  m_thread = std::thread (&async_output_buffer_t::writer, this);
+  pthread_setname_np (m_thread.native_handle (), "RocrDebugAgentIO");
+}
+
+async_output_buffer_t::~async_output_buffer_t ()
+{
+  flush ();
+
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_quit = true;
+  }
+  m_cv.notify_all ();
+  m_thread.join ();
+}
+
+void
+async_output_buffer_t::put (std::unique_lock<std::mutex> &lock,
+                            const char *data, size_t size)
+{
+  /* Hand the front buffer to the background thread first if DATA does not
+     fit, so that DATA is only split if it is larger than the buffer.  */
+  while (m_front_size && size > m_front.size () - m_front_size)
+    submit (lock, true);
+
+  while (size)
+    {
+      if (m_front_size == m_front.size ())
+        submit (lock, true);
+
+      const size_t count = std::min (size, m_front.size () - m_front_size);
+      std::memcpy (m_front.data () + m_front_size, data, count);
+      m_front_size += count;
+      data += count;
+      size -= count;
+    }
+}
+
+void
+async_output_buffer_t::release_put_area (std::unique_lock<std::mutex> &lock)
+{
+  if (m_put_area_owner != std::this_thread::get_id ())
+    return;
+
+  m_put_area_owner = std::thread::id ();
+  put (lock, pbase (), pptr () - pbase ());
+  setp (nullptr, nullptr);
+}
+
+void
+async_output_buffer_t::submit (std::unique_lock<std::mutex> &lock, bool wait)
+{
+  if (!m_front_size)
+    return;
+
+  if (m_back_size)
+    {
+      if (!wait)
+        return;
+      m_cv.wait (lock, [this] () { return m_back_size == 0; });
+    }
+
+  m_front.swap (m_back);
+  m_back_size = m_front_size;
+  m_submitted += m_front_size;
+  m_front_size = 0;
+
+  /* Notify the background thread without the lock, so that it does not wake
+     up only to wait for it.  */
+  lock.unlock ();
+  m_cv.notify_all ();
+  lock.lock ();
+}
+
+void
+async_output_buffer_t::append (const char *data, size_t size)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  release_put_area (lock);
+  put (lock, data, size);
+  submit (lock, false);
+}
+
+void
+async_output_buffer_t::flush ()
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  release_put_area (lock);
+  submit (lock, true);
+  m_cv.wait (lock, [this] () { return m_back_size == 0; });
+}
+
+size_t
+async_output_buffer_t::put_count ()
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+
+  size_t count = m_submitted + m_front_size;
+  if (m_put_area_owner == std::this_thread::get_id ())
+    count += pptr () - pbase ();
+  return count;
+}
+
+async_output_buffer_t::int_type
+async_output_buffer_t::overflow (int_type c)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  release_put_area (lock);
+
+  if (traits_type::eq_int_type (c, traits_type::eof ()))
+    return traits_type::not_eof (c);
+
+  /* Take the put area.  It is released when the stream is flushed.  */
+  m_put_area_owner = std::this_thread::get_id ();
+  setp (m_put_area.data (), m_put_area.data () + m_put_area.size ());
+
+  *pptr () = traits_type::to_char_type (c);
+  pbump (1);
+  return c;
+}
+
+int
+async_output_buffer_t::sync ()
+{
+  /* Do not wait for the lock, so that flushing the stream never blocks.  The
+     characters are left in the put area instead.  */
+  std::unique_lock<std::mutex> lock (m_mutex, std::try_to_lock);
+  if (!lock.owns_lock ())
+    return 0;
+
+  release_put_area (lock);
+  submit (lock, false);
+  return 0;
+}
+
+void
+async_output_buffer_t::writer ()
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  while (true)
+    {
+      m_cv.wait (lock, [this] () { return m_back_size || m_quit; });
+      if (!m_back_size)
+        return;
+
+      const char *data = m_back.data ();
+      size_t size = m_back_size;
+      lock.unlock ();
+
+      /* The output is dropped if it cannot be written: there is nowhere to
+         report the error.  */
+      while (size)
+        {
+          ssize_t written = write (m_fd, data, size);
+          if (written == -1)
+            {
+              if (errno == EINTR)
+                continue;
+              break;
+            }
+
+          data += written;
+          size -= written;
+        }
+
+      lock.lock ();
+      m_back_size = 0;
+      m_cv.notify_all ();
+    }
+}
+
+} /* namespace amd::debug_agent */
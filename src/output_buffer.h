@@ -0,0 +1,133 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#ifndef _ROCM_DEBUG_AGENT_OUTPUT_BUFFER_H
+#define _ROCM_DEBUG_AGENT_OUTPUT_BUFFER_H 1
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace amd::debug_agent
+{
+
+/* A stream buffer that writes to a file descriptor from a background thread.
+
+   The characters are put in a front buffer, while the background thread
+   writes the back buffer.  The buffers are swapped when the front buffer is
+   full, when the stream is flushed and the background thread is idle, and
+   when flush is called.  Flushing the stream, for example with std::endl,
+   never waits for the file to be written: while the background thread is
+   busy, lines accumulate in the front buffer and are written in a single
+   system call.  Only flush guarantees that the characters put so far have
+   been written to the file descriptor, so that they are not lost if the
+   process is aborted.
+
+   The characters inserted in the stream are first put, without a lock, in a
+   put area owned by the inserting thread, and moved to the front buffer when
+   the put area is full or the stream is flushed.  Only one thread at a time
+   may insert characters in the stream.  Any thread may append characters
+   with append: they are put in the front buffer under the lock, after the
+   put area if it is owned by the calling thread.  */
+class async_output_buffer_t : public std::streambuf
+{
+public:
+  /* Write to FD, which is not closed by this buffer.  */
+  explicit async_output_buffer_t (int fd, size_t buffer_size = 1 << 20);
+  ~async_output_buffer_t ();
+
+  async_output_buffer_t (const async_output_buffer_t &) = delete;
+  async_output_buffer_t &operator= (const async_output_buffer_t &) = delete;
+
+  /* Wait until all the characters put so far by all threads are written to
+     the file descriptor.  */
+  void flush ();
+
+  /* Put the SIZE characters of DATA at once, so that they are not
+     interleaved with the characters put by other threads.  */
+  void append (const char *data, size_t size);
+
+  /* The number of characters put so far.  */
+  size_t put_count ();
+
+protected:
+  int_type overflow (int_type c) override;
+  int sync () override;
+
+private:
+  /* Put the SIZE characters of DATA in the front buffer, handing it to the
+     background thread whenever it is full.  */
+  void put (std::unique_lock<std::mutex> &lock, const char *data,
+            size_t size);
+
+  /* If the calling thread owns the put area, move its characters to the
+     front buffer, and release it.  */
+  void release_put_area (std::unique_lock<std::mutex> &lock);
+
+  /* Hand the characters of the front buffer to the background thread.  If
+     the thread is still writing the back buffer, wait for it if WAIT is
+     true, or leave the characters in the front buffer.  Releases the lock
+     while notifying the background thread.  */
+  void submit (std::unique_lock<std::mutex> &lock, bool wait);
+
+  void writer ();
+
+  int const m_fd;
+
+  /* The put area, and the thread that owns it.  The owner is only set while
+     the put area is in use.  */
+  std::vector<char> m_put_area;
+  std::thread::id m_put_area_owner;
+
+  std::vector<char> m_front;
+  std::vector<char> m_back;
+  /* The number of characters put in m_front.  */
+  size_t m_front_size{ 0 };
+  /* The number of characters handed to the background thread so far.  */
+  size_t m_submitted{ 0 };
+  /* The number of characters of m_back to write.  Zero if the background
+     thread is idle.  */
+  size_t m_back_size{ 0 };
+
+  /* Protects all the members but the put area, and the background thread's
+     state.  The functions taking a LOCK argument must be called with
+     m_mutex locked by LOCK.  */
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_quit{ false };
+  std::thread m_thread;
+};
+
+} /* namespace amd::debug_agent */
+
+#endif /* _ROCM_DEBUG_AGENT_OUTPUT_BUFFER_H */
@@ -0,0 +1,369 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#include "report_format.h"
+#include "debug.h"
+#include "json_writer.h"
+#include "logging.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+namespace amd::debug_agent
+{
+
+namespace
+{
+
+/* Add the SIZE bytes VALUE of a register whose vector type has
+   DIMENSION_COUNT DIMENSIONS to JSON.  Vector registers are arrays of their
+   elements.  */
+void
+json_register_value (json_writer_t &json, const size_t *dimensions,
+                     size_t dimension_count, const uint8_t *value, size_t size)
+{
+  if (!dimension_count)
+    {
+      json.hex_value (value, size);
+      return;
+    }
+
+  const size_t element_size = size / dimensions[0];
+
+  json.begin_array ();
+  for (size_t i = 0; i < dimensions[0]; ++i)
+    json_register_value (json, dimensions + 1, dimension_count - 1,
+                         value + i * element_size, element_size);
+  json.end_array ();
+}
+
+/* Append the SIZE bytes little-endian VALUE to VALUE_STRING as a hex
+   number.  */
+void
+append_hex_string (std::string &value_string, const uint8_t *value,
+                   size_t size)
+{
+  for (size_t pos = size; pos > 0; --pos)
+    {
+      static constexpr char hex_digits[] = "0123456789abcdef";
+      value_string.push_back (hex_digits[value[pos - 1] >> 4]);
+      value_string.push_back (hex_digits[value[pos - 1] & 0xF]);
+    }
+}
+
+void
+append_register_value (std::string &value_string,
+                       const size_t *vector_dimensions,
+                       size_t dimension_count, const uint8_t *value,
+                       size_t size)
+{
+  /* handle vector types..  */
+  if (dimension_count)
+    {
+      const size_t element_count = vector_dimensions[0];
+      const size_t element_size = size / element_count;
+
+      agent_assert ((size % element_size) == 0);
+
+      for (size_t i = 0; i < element_count; ++i)
+        {
+          if (i != 0)
+            value_string += " ";
+          value_string += "[" + std::to_string (i) + "] ";
+
+          append_register_value (value_string, vector_dimensions + 1,
+                                 dimension_count - 1,
+                                 value + element_size * i, element_size);
+        }
+      return;
+    }
+
+  append_hex_string (value_string, value, size);
+}
+
+} /* namespace */
+
+std::string
+stop_reason_string (stop_reason_t stop_reason)
+{
+  std::string stop_reason_str;
+  auto stop_reason_bits{ stop_reason };
+  do
+    {
+      /* Consume one bit from the stop reason.  */
+      auto one_bit
+          = stop_reason_bits ^ (stop_reason_bits & (stop_reason_bits - 1));
+      stop_reason_bits ^= one_bit;
+
+      if (!stop_reason_str.empty ())
+        stop_reason_str += "|";
+
+      stop_reason_str += [] (amd_dbgapi_wave_stop_reasons_t reason) {
+        switch (reason)
+          {
+          case AMD_DBGAPI_WAVE_STOP_REASON_NONE:
+            return "NONE";
+          case AMD_DBGAPI_WAVE_STOP_REASON_BREAKPOINT:
+            return "BREAKPOINT";
+          case AMD_DBGAPI_WAVE_STOP_REASON_WATCHPOINT:
+            return "WATCHPOINT";
+          case AMD_DBGAPI_WAVE_STOP_REASON_SINGLE_STEP:
+            return "SINGLE_STEP";
+          case AMD_DBGAPI_WAVE_STOP_REASON_FP_INPUT_DENORMAL:
+            return "FP_INPUT_DENORMAL";
+          case AMD_DBGAPI_WAVE_STOP_REASON_FP_DIVIDE_BY_0:
+            return "FP_DIVIDE_BY_0";
+          case AMD_DBGAPI_WAVE_STOP_REASON_FP_OVERFLOW:
+            return "FP_OVERFLOW";
+          case AMD_DBGAPI_WAVE_STOP_REASON_FP_UNDERFLOW:
+            return "FP_UNDERFLOW";
+          case AMD_DBGAPI_WAVE_STOP_REASON_FP_INEXACT:
+            return "FP_INEXACT";
+          case AMD_DBGAPI_WAVE_STOP_REASON_FP_INVALID_OPERATION:
+            return "FP_INVALID_OPERATION";
+          case AMD_DBGAPI_WAVE_STOP_REASON_INT_DIVIDE_BY_0:
+            return "INT_DIVIDE_BY_0";
+          case AMD_DBGAPI_WAVE_STOP_REASON_DEBUG_TRAP:
+            return "DEBUG_TRAP";
+          case AMD_DBGAPI_WAVE_STOP_REASON_ASSERT_TRAP:
+            return "ASSERT_TRAP";
+          case AMD_DBGAPI_WAVE_STOP_REASON_TRAP:
+            return "TRAP";
+          case AMD_DBGAPI_WAVE_STOP_REASON_MEMORY_VIOLATION:
+            return "MEMORY_VIOLATION";
+          case AMD_DBGAPI_WAVE_STOP_REASON_ADDRESS_ERROR:
+            return "ADDRESS_ERROR";
+          case AMD_DBGAPI_WAVE_STOP_REASON_ILLEGAL_INSTRUCTION:
+            return "ILLEGAL_INSTRUCTION";
+          case AMD_DBGAPI_WAVE_STOP_REASON_ECC_ERROR:
+            return "ECC_ERROR";
+          case AMD_DBGAPI_WAVE_STOP_REASON_FATAL_HALT:
+            return "FATAL_HALT";
+#if AMD_DBGAPI_VERSION_MAJOR == 0 && AMD_DBGAPI_VERSION_MINOR < 58
+          case AMD_DBGAPI_WAVE_STOP_REASON_RESERVED:
+            return "RESERVED";
+#endif
+          }
+        return "";
+      }(static_cast<amd_dbgapi_wave_stop_reasons_t> (one_bit));
+  } while (stop_reason_bits);
+
+  return stop_reason_str;
+}
+
+void
+print_wave_location (amd_dbgapi_global_address_t pc,
+                     std::optional<amd_dbgapi_global_address_t> kernel_entry,
+                     std::optional<std::string_view> kernel_name,
+                     stop_reason_t stop_reason)
+{
+  agent_out << "pc=0x" << std::hex << pc << " (kernel_code_entry=";
+
+  if (kernel_entry)
+    {
+      agent_out << "0x" << std::hex << *kernel_entry;
+
+      if (kernel_name)
+        agent_out << " <" << *kernel_name << ">";
+    }
+  else
+    agent_out << "not available";
+
+  agent_out << ")";
+
+  agent_out << " (";
+  if (stop_reason != AMD_DBGAPI_WAVE_STOP_REASON_NONE)
+    agent_out << "stopped, reason: " << stop_reason_string (stop_reason);
+  else
+    agent_out << "running";
+  agent_out << ")" << std::endl;
+}
+
+std::vector<size_t>
+parse_register_type (std::string type)
+{
+  std::vector<size_t> vector_dimensions;
+
+  for (size_t pos; (pos = type.find_last_of ('[')) != std::string::npos;
+       type.resize (pos))
+    vector_dimensions.emplace_back (std::stoi (type.substr (pos + 1)));
+
+  return vector_dimensions;
+}
+
+std::string
+register_value_string (const std::vector<size_t> &vector_dimensions,
+                       const uint8_t *value, size_t size, bool compact)
+{
+  const size_t *dimensions = vector_dimensions.data ();
+  const size_t dimension_count = vector_dimensions.size ();
+
+  std::string value_string;
+
+  if (compact && dimension_count && dimensions[0])
+    {
+      const size_t element_size = size / dimensions[0];
+
+      bool uniform = element_size != 0;
+      for (size_t offset = element_size;
+           uniform && (offset + element_size) <= size; offset += element_size)
+        uniform = std::equal (value, value + element_size, value + offset);
+
+      if (uniform)
+        {
+          value_string = "all lanes = ";
+          append_register_value (value_string, dimensions + 1,
+                                 dimension_count - 1, value, element_size);
+          return value_string;
+        }
+    }
+
+  append_register_value (value_string, dimensions, dimension_count, value,
+                         size);
+  return value_string;
+}
+
+void
+print_register_class (const std::string &class_name,
+                      const std::vector<register_value_t> &registers,
+                      bool compact)
+{
+  agent_out << std::endl << class_name << " registers:";
+
+  size_t last_register_size = 0;
+  size_t column = 0;
+  for (auto &&reg : registers)
+    {
+      const size_t register_size = reg.m_value->size ();
+      const size_t num_register_per_line = 16 / register_size;
+
+      if (register_size > sizeof (uint64_t) /* Registers larger than a
+                                               uint64_t are printed each
+                                               on a separate line.  */
+          || register_size != last_register_size
+          || (column++ % num_register_per_line) == 0)
+        {
+          agent_out << std::endl;
+          column = 1;
+        }
+
+      last_register_size = register_size;
+
+      agent_out << std::right << std::setfill (' ') << std::setw (16)
+                << (*reg.m_name + ": ")
+                << register_value_string (*reg.m_vector_dimensions,
+                                          reg.m_value->data (), register_size,
+                                          compact);
+    }
+
+  agent_out << std::endl;
+}
+
+void
+json_register_class (json_writer_t &json, const std::string &class_name,
+                     const std::vector<register_value_t> &registers)
+{
+  json.key (class_name).begin_object ();
+  for (auto &&reg : registers)
+    {
+      json.key (*reg.m_name);
+      json_register_value (json, reg.m_vector_dimensions->data (),
+                           reg.m_vector_dimensions->size (),
+                           reg.m_value->data (), reg.m_value->size ());
+    }
+  json.end_object ();
+}
+
+void
+print_local_memory_contents (const std::vector<uint32_t> &contents,
+                             bool compact)
+{
+  if (contents.empty ())
+    return;
+
+  constexpr size_t words_per_row = 8;
+
+  auto print_row = [&contents] (size_t index, size_t word_count) {
+    agent_out << std::endl
+              << "    0x" << std::hex << std::setfill ('0') << std::setw (4)
+              << index * sizeof (contents[0]) << ":";
+
+    for (size_t i = index; i < index + word_count; ++i)
+      agent_out << " " << std::hex << std::setfill ('0') << std::setw (8)
+                << contents[i];
+  };
+
+  agent_out << std::endl << "Local memory content:";
+
+  /* The index of the last row printed, and of the last row skipped since.  */
+  std::optional<size_t> previous_row;
+  std::optional<size_t> skipped_row;
+
+  for (size_t i = 0; i < contents.size (); i += words_per_row)
+    {
+      const size_t word_count = std::min (words_per_row, contents.size () - i);
+
+      /* In compact mode, rows identical to the previous row are replaced
+         with a single "*" line.  */
+      if (compact && previous_row && word_count == words_per_row
+          && std::equal (&contents[*previous_row],
+                         &contents[*previous_row + words_per_row],
+                         &contents[i]))
+        {
+          if (!skipped_row)
+            agent_out << std::endl << "    *";
+          skipped_row = i;
+          continue;
+        }
+
+      print_row (i, word_count);
+      previous_row = i;
+      skipped_row.reset ();
+    }
+
+  /* Print the last row if it was skipped, to show where the local memory
+     ends.  */
+  if (skipped_row)
+    print_row (*skipped_row, words_per_row);
+
+  agent_out << std::endl;
+}
+
+void
+print_shared_local_memory (uint64_t wave_id)
+{
+  agent_out << std::endl
+            << "Local memory content: same as wave_" << std::dec << wave_id
+            << " (same workgroup)" << std::endl;
+}
+
+} /* namespace amd::debug_agent */
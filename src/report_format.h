@@ -0,0 +1,108 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#ifndef _ROCM_DEBUG_AGENT_REPORT_FORMAT_H
+#define _ROCM_DEBUG_AGENT_REPORT_FORMAT_H 1
+
+#include <amd-dbgapi/amd-dbgapi.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/* Formatting of the wavefront reports, shared by the agent and by the
+   snapshot decoder.  The text is printed to agent_out, the JSON to the given
+   json_writer_t.  */
+
+namespace amd::debug_agent
+{
+
+class json_writer_t;
+
+using stop_reason_t = std::underlying_type_t<amd_dbgapi_wave_stop_reasons_t>;
+
+/* Return the names of the stop reasons set in STOP_REASON, separated by
+   '|'.  */
+std::string stop_reason_string (stop_reason_t stop_reason);
+
+/* Print the pc, kernel and stop reason of a wavefront.  */
+void print_wave_location (amd_dbgapi_global_address_t pc,
+                          std::optional<amd_dbgapi_global_address_t>
+                              kernel_entry,
+                          std::optional<std::string_view> kernel_name,
+                          stop_reason_t stop_reason);
+
+/* Return the element counts of the vector register type TYPE, starting with
+   the outermost.  For example, "int32_t[64]" is { 64 }.  The element counts
+   of a scalar type are empty.  */
+std::vector<size_t> parse_register_type (std::string type);
+
+/* Return the string representation of the SIZE bytes register VALUE, of a
+   type with VECTOR_DIMENSIONS.  If COMPACT is true, a vector register whose
+   elements all have the same value is printed as "all lanes = VALUE".  */
+std::string
+register_value_string (const std::vector<size_t> &vector_dimensions,
+                       const uint8_t *value, size_t size, bool compact);
+
+struct register_value_t
+{
+  const std::string *m_name;
+  const std::vector<size_t> *m_vector_dimensions;
+  const std::vector<uint8_t> *m_value;
+};
+
+/* Print the registers REGISTERS of the register class CLASS_NAME.  */
+void print_register_class (const std::string &class_name,
+                           const std::vector<register_value_t> &registers,
+                           bool compact);
+
+/* Add the registers REGISTERS of the register class CLASS_NAME to JSON, as
+   a member of the current object mapping the register names to their
+   values.  Scalar values are hex strings, and vector values are arrays of
+   their elements.  */
+void json_register_class (json_writer_t &json, const std::string &class_name,
+                          const std::vector<register_value_t> &registers);
+
+/* Print the local memory CONTENTS.  If COMPACT is true, consecutive
+   identical rows are collapsed.  */
+void print_local_memory_contents (const std::vector<uint32_t> &contents,
+                                  bool compact);
+
+/* Print a reference to the local memory already printed for wave_WAVE_ID,
+   another wavefront of the same workgroup.  */
+void print_shared_local_memory (uint64_t wave_id);
+
+} /* namespace amd::debug_agent */
+
+#endif /* _ROCM_DEBUG_AGENT_REPORT_FORMAT_H */
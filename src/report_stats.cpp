@@ -0,0 +1,132 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#include "report_stats.h"
+#include "debug.h"
+#include "logging.h"
+
+#include <numeric>
+#include <utility>
+
+namespace amd::debug_agent
+{
+
+namespace detail
+{
+
+thread_local report_stats_t *current_report_stats = nullptr;
+
+} /* namespace detail */
+
+const char *
+report_phase_name (report_phase_t phase)
+{
+  switch (phase)
+    {
+    case report_phase_t::other:
+      return "other";
+    case report_phase_t::events:
+      return "events";
+    case report_phase_t::stop:
+      return "stop";
+    case report_phase_t::wave_info:
+      return "wave_info";
+    case report_phase_t::code_objects:
+      return "code_objects";
+    case report_phase_t::registers:
+      return "registers";
+    case report_phase_t::local_memory:
+      return "local_memory";
+    case report_phase_t::disassembly:
+      return "disassembly";
+    case report_phase_t::source_files:
+      return "source_files";
+    case report_phase_t::output:
+      return "output";
+    case report_phase_t::count:
+      break;
+    }
+
+  agent_error ("invalid report phase %zu", static_cast<size_t> (phase));
+}
+
+report_phase_t
+report_stats_t::switch_phase (report_phase_t phase)
+{
+  const clock_type::time_point now = clock_type::now ();
+  m_phase_time[static_cast<size_t> (m_phase)] += now - m_phase_start;
+  m_phase_start = now;
+  return std::exchange (m_phase, phase);
+}
+
+report_stats_t::clock_type::duration
+report_stats_t::total_time () const
+{
+  return std::accumulate (m_phase_time.begin (), m_phase_time.end (),
+                          clock_type::duration::zero ());
+}
+
+uint64_t
+report_stats_t::total_dbgapi_calls () const
+{
+  return std::accumulate (m_dbgapi_calls.begin (), m_dbgapi_calls.end (),
+                          uint64_t{ 0 });
+}
+
+report_stats_scope_t::report_stats_scope_t (bool enabled)
+{
+  if (!enabled)
+    return;
+
+  /* Reports are not nested.  */
+  agent_assert (!detail::current_report_stats);
+
+  m_output_start = agent_out_put_count ();
+  detail::current_report_stats = &m_stats.emplace ();
+}
+
+const report_stats_t *
+report_stats_scope_t::finish ()
+{
+  if (!m_stats)
+    return nullptr;
+
+  if (!m_finished)
+    {
+      m_stats->switch_phase (report_phase_t::other);
+      m_stats->m_bytes_written = agent_out_put_count () - m_output_start;
+      detail::current_report_stats = nullptr;
+      m_finished = true;
+    }
+
+  return &*m_stats;
+}
+
+} /* namespace amd::debug_agent */
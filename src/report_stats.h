@@ -0,0 +1,182 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#ifndef _ROCM_DEBUG_AGENT_REPORT_STATS_H
+#define _ROCM_DEBUG_AGENT_REPORT_STATS_H 1
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+/* Statistics of the time and work spent in each phase of a report, enabled
+   with --stats.
+
+   A report collects its statistics while a report_stats_scope_t lives on the
+   thread making it.  The code of each phase is wrapped in a
+   report_phase_timer_t, and the time is charged to the innermost phase, so
+   that the times of the phases add up to the time of the report.  The dbgapi
+   calls made by the thread are counted in the phase making them.  Without a
+   scope, the timers and counters do nothing but test a thread-local
+   pointer.  */
+
+namespace amd::debug_agent
+{
+
+enum class report_phase_t : size_t
+{
+  /* Outside of the other phases: formatting the report, and bookkeeping.  */
+  other,
+  /* Fetching and processing the dbgapi events.  */
+  events,
+  /* Stopping the wavefronts and the wavefront creation.  */
+  stop,
+  /* Listing the stopped wavefronts and querying their state.  */
+  wave_info,
+  /* Updating and opening the code objects, and looking up symbols.  */
+  code_objects,
+  registers,
+  local_memory,
+  disassembly,
+  /* Loading the line tables and the source files printed with the
+     disassembly.  */
+  source_files,
+  /* Writing the report to its output.  */
+  output,
+  count
+};
+
+/* Return the name of PHASE, as printed in the summary.  */
+const char *report_phase_name (report_phase_t phase);
+
+struct report_stats_t
+{
+  using clock_type = std::chrono::steady_clock;
+
+  static constexpr size_t phase_count
+      = static_cast<size_t> (report_phase_t::count);
+
+  std::array<clock_type::duration, phase_count> m_phase_time{};
+  std::array<uint64_t, phase_count> m_dbgapi_calls{};
+
+  /* The bytes of registers and memory read through dbgapi.  */
+  uint64_t m_bytes_read{ 0 };
+  /* The bytes of output written by the agent.  */
+  uint64_t m_bytes_written{ 0 };
+
+  /* The phase being timed, since M_PHASE_START.  */
+  report_phase_t m_phase{ report_phase_t::other };
+  clock_type::time_point m_phase_start{ clock_type::now () };
+
+  /* Charge the time elapsed since the last switch to the current phase, and
+     make PHASE the current phase.  Return the phase that was current.  */
+  report_phase_t switch_phase (report_phase_t phase);
+
+  clock_type::duration total_time () const;
+  uint64_t total_dbgapi_calls () const;
+};
+
+namespace detail
+{
+
+/* The statistics of the report the current thread is making, if they are
+   collected.  */
+extern thread_local report_stats_t *current_report_stats;
+
+} /* namespace detail */
+
+/* Count a dbgapi call in the current phase of the current thread's
+   report.  */
+inline void
+count_dbgapi_call ()
+{
+  if (report_stats_t *stats = detail::current_report_stats)
+    ++stats->m_dbgapi_calls[static_cast<size_t> (stats->m_phase)];
+}
+
+/* Count SIZE bytes of registers or memory read through dbgapi.  */
+inline void
+count_bytes_read (size_t size)
+{
+  if (report_stats_t *stats = detail::current_report_stats)
+    stats->m_bytes_read += size;
+}
+
+/* Charge the time the current thread spends in the lifetime of this object
+   to PHASE.  */
+class report_phase_timer_t
+{
+public:
+  explicit report_phase_timer_t (report_phase_t phase)
+      : m_stats (detail::current_report_stats)
+  {
+    if (m_stats)
+      m_previous_phase = m_stats->switch_phase (phase);
+  }
+
+  ~report_phase_timer_t ()
+  {
+    if (m_stats)
+      m_stats->switch_phase (m_previous_phase);
+  }
+
+  report_phase_timer_t (const report_phase_timer_t &) = delete;
+  report_phase_timer_t &operator= (const report_phase_timer_t &) = delete;
+
+private:
+  report_stats_t *const m_stats;
+  report_phase_t m_previous_phase{ report_phase_t::other };
+};
+
+/* Collect the statistics of the report made by the current thread, if
+   ENABLED, from the construction of this object until finish is called.  */
+class report_stats_scope_t
+{
+public:
+  explicit report_stats_scope_t (bool enabled);
+  ~report_stats_scope_t () { finish (); }
+
+  report_stats_scope_t (const report_stats_scope_t &) = delete;
+  report_stats_scope_t &operator= (const report_stats_scope_t &) = delete;
+
+  /* Stop collecting the statistics, and return them, or nullptr if they
+     are not collected.  */
+  const report_stats_t *finish ();
+
+private:
+  std::optional<report_stats_t> m_stats;
+  uint64_t m_output_start{ 0 };
+  bool m_finished{ false };
+};
+
+} /* namespace amd::debug_agent */
+
+#endif /* _ROCM_DEBUG_AGENT_REPORT_STATS_H */
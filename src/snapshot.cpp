@@ -0,0 +1,391 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#include "snapshot.h"
+#include "debug.h"
+#include "logging.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+
+namespace amd::debug_agent
+{
+
+namespace
+{
+
+/* The buffered records are written to the file when the buffer grows past
+   this size.  */
+constexpr size_t snapshot_flush_threshold = 4 << 20;
+
+struct snapshot_record_header_t
+{
+  uint32_t m_kind;
+  uint32_t m_reserved;
+  uint64_t m_payload_size;
+};
+
+} /* namespace */
+
+uint64_t
+snapshot_hash (const void *data, size_t size)
+{
+  uint64_t hash = 0xcbf29ce484222325;
+  for (size_t i = 0; i < size; ++i)
+    {
+      hash ^= static_cast<const uint8_t *> (data)[i];
+      hash *= 0x100000001b3;
+    }
+  return hash;
+}
+
+snapshot_writer_t::snapshot_writer_t (std::string path)
+    : m_path (std::move (path))
+{
+  m_fd = ::open (m_path.c_str (), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                 0644);
+  if (m_fd == -1)
+    {
+      agent_warning ("could not open snapshot file `%s': %s", m_path.c_str (),
+                     strerror (errno));
+      return;
+    }
+
+  m_buffer.insert (m_buffer.end (), snapshot_magic.begin (),
+                   snapshot_magic.end ());
+  put (snapshot_version);
+  put (snapshot_byte_order_mark);
+  flush ();
+}
+
+snapshot_writer_t::~snapshot_writer_t ()
+{
+  flush ();
+
+  if (m_fd != -1)
+    ::close (m_fd);
+}
+
+void
+snapshot_writer_t::begin_record (snapshot_record_kind_t kind)
+{
+  agent_assert (!m_record_start && "a record is already being written");
+
+  if (m_buffer.size () >= snapshot_flush_threshold)
+    flush ();
+
+  m_record_start = m_buffer.size ();
+  put (snapshot_record_header_t{ static_cast<uint32_t> (kind), 0, 0 });
+}
+
+void
+snapshot_writer_t::end_record ()
+{
+  agent_assert (m_record_start && "no record is being written");
+
+  const size_t payload_start
+      = *m_record_start + sizeof (snapshot_record_header_t);
+  const uint64_t payload_size = m_buffer.size () - payload_start;
+
+  std::memcpy (&m_buffer[*m_record_start]
+                   + offsetof (snapshot_record_header_t, m_payload_size),
+               &payload_size, sizeof (payload_size));
+  m_record_start.reset ();
+}
+
+void
+snapshot_writer_t::put_string (std::string_view string)
+{
+  put (static_cast<uint32_t> (string.size ()));
+  m_buffer.insert (m_buffer.end (), string.begin (), string.end ());
+}
+
+void
+snapshot_writer_t::put_bytes (const void *data, size_t size)
+{
+  put (static_cast<uint64_t> (size));
+  const char *bytes = static_cast<const char *> (data);
+  m_buffer.insert (m_buffer.end (), bytes, bytes + size);
+}
+
+void
+snapshot_writer_t::flush ()
+{
+  agent_assert (!m_record_start && "cannot flush a partial record");
+
+  if (m_fd == -1)
+    {
+      m_buffer.clear ();
+      return;
+    }
+
+  for (size_t written = 0; written < m_buffer.size ();)
+    {
+      ssize_t count = ::write (m_fd, m_buffer.data () + written,
+                               m_buffer.size () - written);
+      if (count == -1 && errno == EINTR)
+        continue;
+
+      if (count == -1)
+        {
+          agent_warning ("could not write snapshot file `%s': %s",
+                         m_path.c_str (), strerror (errno));
+          ::close (m_fd);
+          m_fd = -1;
+          break;
+        }
+
+      written += count;
+    }
+
+  m_buffer.clear ();
+}
+
+snapshot_reader_t::snapshot_reader_t (const std::string &path)
+{
+  std::ifstream file (path, std::ios::in | std::ios::binary);
+  if (!file)
+    throw snapshot_error_t ("could not open `" + path + "'");
+
+  m_data.assign (std::istreambuf_iterator<char> (file),
+                 std::istreambuf_iterator<char> ());
+
+  m_record_end = m_data.size ();
+
+  if (m_data.size () < snapshot_magic.size ()
+      || !std::equal (snapshot_magic.begin (), snapshot_magic.end (),
+                      m_data.begin ()))
+    throw snapshot_error_t ("`" + path + "' is not a snapshot file");
+
+  m_position = snapshot_magic.size ();
+  m_version = get<uint32_t> ();
+
+  if (get<uint32_t> () != snapshot_byte_order_mark)
+    throw snapshot_error_t ("`" + path
+                            + "' was written on a host with a different "
+                              "byte order");
+
+  if (m_version == 0 || m_version > snapshot_version)
+    throw snapshot_error_t ("`" + path + "' has unsupported version "
+                            + std::to_string (m_version));
+}
+
+const char *
+snapshot_reader_t::consume (size_t size)
+{
+  if (size > m_record_end - m_position)
+    throw snapshot_error_t ("truncated record at offset "
+                            + std::to_string (m_position));
+
+  const char *data = &m_data[m_position];
+  m_position += size;
+  return data;
+}
+
+std::string
+snapshot_reader_t::get_string ()
+{
+  const size_t size = get<uint32_t> ();
+  return std::string (consume (size), size);
+}
+
+template <typename T>
+std::vector<T>
+snapshot_reader_t::get_bytes ()
+{
+  const uint64_t size = get<uint64_t> ();
+  if ((size % sizeof (T)) != 0)
+    throw snapshot_error_t ("misaligned array at offset "
+                            + std::to_string (m_position));
+
+  std::vector<T> values (size / sizeof (T));
+  std::memcpy (values.data (), consume (size), size);
+  return values;
+}
+
+void
+snapshot_reader_t::read_architecture (snapshot_architecture_t &architecture)
+{
+  architecture.m_id = get<uint64_t> ();
+  architecture.m_elf_amdgpu_machine = get<uint32_t> ();
+  architecture.m_name = get_string ();
+
+  for (uint32_t count = get<uint32_t> (); count; --count)
+    architecture.m_class_names.emplace_back (get_string ());
+
+  for (uint32_t count = get<uint32_t> (); count; --count)
+    {
+      snapshot_register_info_t &info
+          = architecture.m_registers.emplace_back ();
+      info.m_id = get<uint64_t> ();
+      info.m_name = get_string ();
+      info.m_type = get_string ();
+      info.m_size = get<uint64_t> ();
+      if (int32_t class_index = get<int32_t> (); class_index >= 0)
+        {
+          if (static_cast<size_t> (class_index)
+              >= architecture.m_class_names.size ())
+            throw snapshot_error_t ("invalid register class index");
+          info.m_class_index.emplace (class_index);
+        }
+    }
+}
+
+void
+snapshot_reader_t::read_code_object (snapshot_code_object_t &code_object)
+{
+  code_object.m_id = get<uint64_t> ();
+  code_object.m_load_address = get<uint64_t> ();
+  code_object.m_mem_size = get<uint64_t> ();
+  code_object.m_hash = get<uint64_t> ();
+  code_object.m_uri = get_string ();
+  code_object.m_image = get_bytes<char> ();
+}
+
+void
+snapshot_reader_t::read_wave (snapshot_wave_t &wave)
+{
+  wave.m_wave_id = get<uint64_t> ();
+  wave.m_architecture_id = get<uint64_t> ();
+  wave.m_stop_reason = get<uint64_t> ();
+  wave.m_pc = get<uint64_t> ();
+
+  const uint8_t flags = get<uint8_t> ();
+  if (flags & snapshot_wave_has_dispatch)
+    {
+      wave.m_dispatch_id.emplace (get<uint64_t> ());
+      wave.m_kernel_entry.emplace (get<uint64_t> ());
+      wave.m_workgroup_coord.emplace (get<std::array<uint32_t, 3>> ());
+    }
+  if (flags & snapshot_wave_has_code_object)
+    wave.m_code_object_id.emplace (get<uint64_t> ());
+
+  for (uint32_t count = get<uint32_t> (); count; --count)
+    {
+      uint64_t register_id = get<uint64_t> ();
+      wave.m_registers.emplace_back (register_id, get_bytes<uint8_t> ());
+    }
+
+  wave.m_instructions_address = get<uint64_t> ();
+  wave.m_instructions = get_bytes<uint8_t> ();
+
+  wave.m_local_memory_kind = get<snapshot_local_memory_t> ();
+  switch (wave.m_local_memory_kind)
+    {
+    case snapshot_local_memory_t::none:
+      break;
+    case snapshot_local_memory_t::contents:
+      wave.m_local_memory = get_bytes<uint32_t> ();
+      break;
+    case snapshot_local_memory_t::shared:
+      wave.m_local_memory_wave_id = get<uint64_t> ();
+      break;
+    default:
+      throw snapshot_error_t ("invalid local memory kind");
+    }
+}
+
+std::optional<snapshot_report_t>
+snapshot_reader_t::next_report ()
+{
+  std::optional<snapshot_report_t> report;
+
+  while (m_position < m_data.size ())
+    {
+      const size_t record_start = m_position;
+
+      /* A record cut short, as written by a process that died while writing
+         the snapshot, ends the snapshot.  */
+      m_record_end = m_data.size ();
+      if (m_data.size () - m_position < sizeof (snapshot_record_header_t))
+        {
+          m_position = m_data.size ();
+          break;
+        }
+
+      auto header = get<snapshot_record_header_t> ();
+      if (header.m_payload_size > m_data.size () - m_position)
+        {
+          m_position = m_data.size ();
+          break;
+        }
+
+      m_record_end = m_position + header.m_payload_size;
+
+      const auto kind = static_cast<snapshot_record_kind_t> (header.m_kind);
+
+      if (kind == snapshot_record_kind_t::report_begin && report)
+        {
+          /* The previous report has no report_end record.  Return it, and
+             start with this record on the next call.  */
+          m_position = record_start;
+          return report;
+        }
+
+      if (kind != snapshot_record_kind_t::report_begin && !report)
+        throw snapshot_error_t ("record outside of a report at offset "
+                                + std::to_string (record_start));
+
+      switch (kind)
+        {
+        case snapshot_record_kind_t::report_begin:
+          report.emplace ().m_timestamp = get<uint64_t> ();
+          break;
+        case snapshot_record_kind_t::architecture:
+          read_architecture (report->m_architectures.emplace_back ());
+          break;
+        case snapshot_record_kind_t::code_object:
+          read_code_object (report->m_code_objects.emplace_back ());
+          break;
+        case snapshot_record_kind_t::wave:
+          read_wave (report->m_waves.emplace_back ());
+          break;
+        case snapshot_record_kind_t::report_end:
+          m_position = m_record_end;
+          return report;
+        default:
+          /* Skip unknown records.  */
+          break;
+        }
+
+      /* Newer writers may append fields to a record.  */
+      m_position = m_record_end;
+    }
+
+  return report;
+}
+
+} /* namespace amd::debug_agent */
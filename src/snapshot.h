@@ -0,0 +1,292 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#ifndef _ROCM_DEBUG_AGENT_SNAPSHOT_H
+#define _ROCM_DEBUG_AGENT_SNAPSHOT_H 1
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/* The crash snapshot file format.
+
+   A snapshot holds the raw state of the stopped wavefronts, as read from the
+   process, so that the process is only held for the time needed to write the
+   bytes.  The report text is produced later, by a decoder.
+
+   A snapshot starts with a header:
+
+     char     magic[8]         "ROCDBGSN"
+     uint32_t version          snapshot_version
+     uint32_t byte_order_mark  0x01020304
+
+   followed by a sequence of records:
+
+     uint32_t kind             snapshot_record_kind_t
+     uint32_t reserved         0
+     uint64_t payload_size
+     uint8_t  payload[payload_size]
+
+   Each report is a report_begin record, followed by the wave, architecture
+   and code object records of the report, followed by a report_end record.
+   Readers skip the records whose kind they do not know.
+
+   Values are stored in the byte order of the host that wrote the snapshot.
+   Strings are a uint32_t length followed by the characters, and byte arrays
+   are a uint64_t length followed by the bytes.  */
+
+namespace amd::debug_agent
+{
+
+constexpr std::array<char, 8> snapshot_magic
+    = { 'R', 'O', 'C', 'D', 'B', 'G', 'S', 'N' };
+constexpr uint32_t snapshot_version = 1;
+constexpr uint32_t snapshot_byte_order_mark = 0x01020304;
+
+enum class snapshot_record_kind_t : uint32_t
+{
+  /* uint64_t timestamp (nanoseconds since the epoch).  */
+  report_begin = 1,
+  /* uint64_t architecture id
+     uint32_t ELF AMDGPU machine
+     string   name
+     uint32_t class count, followed by the class names
+     uint32_t register count, followed by for each register:
+       uint64_t register id
+       string   name
+       string   type
+       uint64_t size
+       int32_t  index of the class it is printed under, or -1  */
+  architecture = 2,
+  /* uint64_t code object id
+     uint64_t load address
+     uint64_t memory size
+     uint64_t content hash (snapshot_hash of the image)
+     string   URI
+     bytes    image, only for code objects that are not backed by a file  */
+  code_object = 3,
+  /* uint64_t wave id
+     uint64_t architecture id
+     uint64_t stop reason
+     uint64_t pc
+     uint8_t  flags (snapshot_wave_flags_t)
+     if has_dispatch:
+       uint64_t dispatch id
+       uint64_t kernel code entry address
+       uint32_t workgroup coordinates[3]
+     if has_code_object:
+       uint64_t code object id
+     uint32_t register count, followed by for each register:
+       uint64_t register id
+       bytes    value
+     uint64_t address of the instructions at the pc
+     bytes    instructions at the pc
+     uint8_t  local memory (snapshot_local_memory_t)
+     if shared:
+       uint64_t id of the wave whose record holds the local memory
+     if contents:
+       bytes    local memory contents  */
+  wave = 4,
+  report_end = 5,
+};
+
+enum snapshot_wave_flags_t : uint8_t
+{
+  snapshot_wave_has_dispatch = 1 << 0,
+  snapshot_wave_has_code_object = 1 << 1,
+};
+
+enum class snapshot_local_memory_t : uint8_t
+{
+  /* The local memory could not be read.  */
+  none = 0,
+  contents = 1,
+  /* The local memory is the same as another wave's of the same workgroup.  */
+  shared = 2,
+};
+
+/* Return the FNV-1a hash of the SIZE bytes DATA.  Used to check that the code
+   object found by the decoder is the one that was loaded.  */
+uint64_t snapshot_hash (const void *data, size_t size);
+
+/* Write a snapshot to a file.  Records are buffered and written to the file
+   when the buffer is full, or when flush is called.  Write errors are
+   reported once as a warning, and the following records are dropped.  */
+class snapshot_writer_t
+{
+public:
+  /* Create or truncate the snapshot file PATH and write its header.  */
+  explicit snapshot_writer_t (std::string path);
+  ~snapshot_writer_t ();
+
+  snapshot_writer_t (const snapshot_writer_t &) = delete;
+  snapshot_writer_t &operator= (const snapshot_writer_t &) = delete;
+
+  bool is_open () const { return m_fd != -1; }
+  const std::string &path () const { return m_path; }
+
+  void begin_record (snapshot_record_kind_t kind);
+  void end_record ();
+
+  template <typename T> void put (T value)
+  {
+    static_assert (std::is_trivially_copyable_v<T>);
+    const char *bytes = reinterpret_cast<const char *> (&value);
+    m_buffer.insert (m_buffer.end (), bytes, bytes + sizeof (value));
+  }
+
+  void put_string (std::string_view string);
+  void put_bytes (const void *data, size_t size);
+
+  /* Write the buffered records to the file.  */
+  void flush ();
+
+private:
+  std::string const m_path;
+  int m_fd{ -1 };
+  std::vector<char> m_buffer;
+  /* The offset in m_buffer of the record being written.  */
+  std::optional<size_t> m_record_start;
+};
+
+/* Thrown by snapshot_reader_t when the snapshot is not valid.  */
+class snapshot_error_t : public std::runtime_error
+{
+public:
+  using std::runtime_error::runtime_error;
+};
+
+struct snapshot_register_info_t
+{
+  uint64_t m_id;
+  std::string m_name;
+  std::string m_type;
+  uint64_t m_size;
+  std::optional<size_t> m_class_index;
+};
+
+struct snapshot_architecture_t
+{
+  uint64_t m_id;
+  uint32_t m_elf_amdgpu_machine;
+  std::string m_name;
+  std::vector<std::string> m_class_names;
+  std::vector<snapshot_register_info_t> m_registers;
+};
+
+struct snapshot_code_object_t
+{
+  uint64_t m_id;
+  uint64_t m_load_address;
+  uint64_t m_mem_size;
+  uint64_t m_hash;
+  std::string m_uri;
+  std::vector<char> m_image;
+};
+
+struct snapshot_wave_t
+{
+  uint64_t m_wave_id;
+  uint64_t m_architecture_id;
+  uint64_t m_stop_reason;
+  uint64_t m_pc;
+  std::optional<uint64_t> m_dispatch_id;
+  std::optional<uint64_t> m_kernel_entry;
+  std::optional<std::array<uint32_t, 3>> m_workgroup_coord;
+  std::optional<uint64_t> m_code_object_id;
+  /* The register ids and values, in the order the registers are printed.  */
+  std::vector<std::pair<uint64_t, std::vector<uint8_t>>> m_registers;
+  uint64_t m_instructions_address;
+  std::vector<uint8_t> m_instructions;
+  snapshot_local_memory_t m_local_memory_kind;
+  uint64_t m_local_memory_wave_id;
+  std::vector<uint32_t> m_local_memory;
+};
+
+struct snapshot_report_t
+{
+  uint64_t m_timestamp;
+  std::vector<snapshot_wave_t> m_waves;
+  std::vector<snapshot_architecture_t> m_architectures;
+  std::vector<snapshot_code_object_t> m_code_objects;
+};
+
+/* Read the reports of a snapshot file.  */
+class snapshot_reader_t
+{
+public:
+  /* Load the snapshot file PATH and check its header.  */
+  explicit snapshot_reader_t (const std::string &path);
+
+  uint32_t version () const { return m_version; }
+
+  /* Return the next report of the snapshot, or nullopt if there are no more
+     reports.  A report missing its report_end record, as written by a process
+     that died while writing it, is returned with the waves read so far.  */
+  std::optional<snapshot_report_t> next_report ();
+
+private:
+  template <typename T> T get ()
+  {
+    static_assert (std::is_trivially_copyable_v<T>);
+    T value;
+    std::memcpy (&value, consume (sizeof (value)), sizeof (value));
+    return value;
+  }
+
+  std::string get_string ();
+  template <typename T> std::vector<T> get_bytes ();
+
+  /* Return a pointer to the next SIZE bytes of the current record, and skip
+     them.  */
+  const char *consume (size_t size);
+
+  void read_architecture (snapshot_architecture_t &architecture);
+  void read_code_object (snapshot_code_object_t &code_object);
+  void read_wave (snapshot_wave_t &wave);
+
+  std::vector<char> m_data;
+  uint32_t m_version{ 0 };
+  size_t m_position{ 0 };
+  /* The end of the current record's payload.  */
+  size_t m_record_end{ 0 };
+};
+
+} /* namespace amd::debug_agent */
+
+#endif /* _ROCM_DEBUG_AGENT_SNAPSHOT_H */
@@ -0,0 +1,123 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#include "symbol_table.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace amd::debug_agent
+{
+
+size_t
+symbol_table_t::add_string_table (const char *strings, size_t size)
+{
+  size_t offset = m_string_arena.size ();
+
+  m_string_arena.insert (m_string_arena.end (), strings, strings + size);
+  /* Make sure the last string is null-terminated even if the string table is
+     malformed.  */
+  m_string_arena.push_back ('\0');
+
+  return offset;
+}
+
+void
+symbol_table_t::add (address_t address, address_t size, size_t name_offset)
+{
+  m_addresses.push_back (address);
+  m_sizes.push_back (size);
+  m_name_offsets.push_back (name_offset);
+}
+
+void
+symbol_table_t::finalize ()
+{
+  std::vector<uint32_t> order (m_addresses.size ());
+  std::iota (order.begin (), order.end (), 0);
+
+  /* Sort by address, and for symbols at the same address, by decreasing size.
+     The sort is stable so that among symbols of the same address and size,
+     the first one added is kept.  */
+  std::stable_sort (order.begin (), order.end (), [this] (auto lhs, auto rhs) {
+    if (m_addresses[lhs] != m_addresses[rhs])
+      return m_addresses[lhs] < m_addresses[rhs];
+    return m_sizes[lhs] > m_sizes[rhs];
+  });
+
+  std::vector<address_t> addresses, sizes;
+  std::vector<uint32_t> name_offsets;
+  addresses.reserve (order.size ());
+  sizes.reserve (order.size ());
+  name_offsets.reserve (order.size ());
+
+  for (auto index : order)
+    {
+      if (!addresses.empty () && addresses.back () == m_addresses[index])
+        continue;
+
+      addresses.push_back (m_addresses[index]);
+      sizes.push_back (m_sizes[index]);
+      name_offsets.push_back (m_name_offsets[index]);
+    }
+
+  m_addresses = std::move (addresses);
+  m_sizes = std::move (sizes);
+  m_name_offsets = std::move (name_offsets);
+}
+
+std::optional<size_t>
+symbol_table_t::find (address_t address) const
+{
+  const address_t *base = m_addresses.data ();
+  size_t count = m_addresses.size ();
+
+  if (!count || address < base[0])
+    return std::nullopt;
+
+  /* Find the last symbol starting at or before ADDRESS.  The loop body has no
+     data dependent branch: the compiler turns the selection into a
+     conditional move, so the loop does not suffer from branch mispredictions,
+     and runs a fixed number of iterations for a given table size.  */
+  while (count > 1)
+    {
+      size_t half = count / 2;
+      base = (base[half] <= address) ? base + half : base;
+      count -= half;
+    }
+
+  size_t index = base - m_addresses.data ();
+  if ((address - m_addresses[index]) < m_sizes[index])
+    return index;
+
+  return std::nullopt;
+}
+
+} /* namespace amd::debug_agent */
@@ -0,0 +1,86 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#ifndef _ROCM_DEBUG_AGENT_SYMBOL_TABLE_H
+#define _ROCM_DEBUG_AGENT_SYMBOL_TABLE_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace amd::debug_agent
+{
+
+/* A table of function symbols sorted by address.  The table is stored as a
+   structure of arrays: symbol addresses and sizes are kept in contiguous
+   arrays, and symbol names are offsets into a single string arena that holds
+   copies of the ELF string tables.  Building the table costs no allocation
+   per symbol, and lookups only touch the address array.  */
+class symbol_table_t
+{
+public:
+  using address_t = std::uint64_t;
+
+  /* Copy the SIZE bytes string table STRINGS at the end of the string arena,
+     and return its offset in the arena.  */
+  size_t add_string_table (const char *strings, size_t size);
+
+  /* Add a symbol starting at ADDRESS and covering SIZE bytes.  NAME_OFFSET is
+     the offset of the symbol's null-terminated name in the string arena.  */
+  void add (address_t address, address_t size, size_t name_offset);
+
+  /* Sort the symbols by address.  If more than one symbol is defined at an
+     address, only the one covering the largest address range is kept.  Must
+     be called after the last symbol is added, and before any lookup.  */
+  void finalize ();
+
+  /* Return the index of the symbol containing ADDRESS.  */
+  std::optional<size_t> find (address_t address) const;
+
+  size_t size () const { return m_addresses.size (); }
+
+  address_t address (size_t index) const { return m_addresses[index]; }
+  address_t symbol_size (size_t index) const { return m_sizes[index]; }
+  const char *name (size_t index) const
+  {
+    return &m_string_arena[m_name_offsets[index]];
+  }
+
+private:
+  std::vector<address_t> m_addresses;
+  std::vector<address_t> m_sizes;
+  std::vector<uint32_t> m_name_offsets;
+  std::vector<char> m_string_arena;
+};
+
+} /* namespace amd::debug_agent */
+
+#endif /* _ROCM_DEBUG_AGENT_SYMBOL_TABLE_H */
@@ -0,0 +1,328 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#include "trace.h"
+#include "debug.h"
+#include "json_writer.h"
+#include "logging.h"
+#include "output_buffer.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace amd::debug_agent
+{
+
+namespace detail
+{
+
+bool trace_enabled = false;
+
+} /* namespace detail */
+
+namespace
+{
+
+/* The events recorded by a thread, pushed by that thread and popped by the
+   thread writing the trace.  */
+struct trace_ring_t
+{
+  static constexpr size_t capacity = 1024;
+
+  std::array<trace_event_t, capacity> m_events;
+
+  /* The number of events pushed and popped so far.  */
+  std::atomic<uint64_t> m_head{ 0 };
+  std::atomic<uint64_t> m_tail{ 0 };
+
+  /* The number of events dropped because the ring was full.  */
+  std::atomic<uint64_t> m_dropped{ 0 };
+
+  /* Set when the thread exits.  The ring is then reused by the next thread
+     that records an event, once it is drained.  */
+  std::atomic<bool> m_released{ false };
+
+  pid_t m_thread_id{ 0 };
+  std::array<char, 16> m_thread_name{};
+  /* Whether the name of the thread was written to the trace.  */
+  bool m_thread_name_written{ false };
+
+  /* Return false if the ring is full.  */
+  bool push (const trace_event_t &event)
+  {
+    const uint64_t head = m_head.load (std::memory_order_relaxed);
+    if (head - m_tail.load (std::memory_order_acquire) == capacity)
+      return false;
+
+    m_events[head % capacity] = event;
+    m_head.store (head + 1, std::memory_order_release);
+    return true;
+  }
+
+  void drop ()
+  {
+    m_dropped.store (m_dropped.load (std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
+  }
+};
+
+struct trace_t
+{
+  explicit trace_t (int fd) : m_buffer (fd), m_out (&m_buffer), m_json (m_out)
+  {
+  }
+
+  async_output_buffer_t m_buffer;
+  std::ostream m_out;
+  json_writer_t m_json;
+
+  pid_t const m_process_id{ getpid () };
+
+  /* Protects the members below, and the output.  */
+  std::mutex m_mutex;
+  std::vector<std::unique_ptr<trace_ring_t>> m_rings;
+  /* The events dropped by the threads whose ring was reused.  */
+  uint64_t m_dropped{ 0 };
+  bool m_closed{ false };
+};
+
+/* Never destroyed, so that the threads can record events until the process
+   exits.  */
+trace_t *g_trace;
+
+/* Acquire a ring for the calling thread.  */
+trace_ring_t *
+acquire_ring ()
+{
+  std::lock_guard<std::mutex> lock (g_trace->m_mutex);
+
+  trace_ring_t *ring = nullptr;
+  for (auto &&released_ring : g_trace->m_rings)
+    if (released_ring->m_released.load (std::memory_order_acquire)
+        && released_ring->m_head.load (std::memory_order_relaxed)
+               == released_ring->m_tail.load (std::memory_order_relaxed))
+      {
+        ring = released_ring.get ();
+        g_trace->m_dropped += ring->m_dropped.exchange (0);
+        ring->m_released.store (false, std::memory_order_relaxed);
+        break;
+      }
+
+  if (!ring)
+    ring = g_trace->m_rings.emplace_back (std::make_unique<trace_ring_t> ())
+               .get ();
+
+  ring->m_thread_id = syscall (SYS_gettid);
+  pthread_getname_np (pthread_self (), ring->m_thread_name.data (),
+                      ring->m_thread_name.size ());
+  ring->m_thread_name_written = false;
+
+  return ring;
+}
+
+/* The ring of the calling thread, released when the thread exits.  */
+struct thread_ring_t
+{
+  ~thread_ring_t ()
+  {
+    if (m_ring)
+      m_ring->m_released.store (true, std::memory_order_release);
+  }
+
+  trace_ring_t *m_ring{ nullptr };
+};
+
+thread_local thread_ring_t t_thread_ring;
+
+/* Set in the thread writing the trace.  */
+thread_local bool t_trace_writer;
+
+void
+write_thread_name (const trace_ring_t &ring)
+{
+  json_writer_t &json = g_trace->m_json;
+
+  json.begin_object ();
+  json.key ("name").value ("thread_name");
+  json.key ("ph").value ("M");
+  json.key ("pid").value (g_trace->m_process_id);
+  json.key ("tid").value (ring.m_thread_id);
+  json.key ("args").begin_object ();
+  json.key ("name").value (ring.m_thread_name.data ());
+  json.end_object ();
+  json.end_object ();
+  g_trace->m_out.put ('\n');
+}
+
+void
+write_event (const trace_ring_t &ring, const trace_event_t &event)
+{
+  json_writer_t &json = g_trace->m_json;
+
+  /* The timestamps are in microseconds.  */
+  json.begin_object ();
+  json.key ("name").value (event.m_name);
+  json.key ("cat").value ("rocm-debug-agent");
+  json.key ("ph").value ("X");
+  json.key ("ts").fixed_value (event.m_start_ns, 3);
+  json.key ("dur").fixed_value (event.m_end_ns - event.m_start_ns, 3);
+  json.key ("pid").value (g_trace->m_process_id);
+  json.key ("tid").value (ring.m_thread_id);
+  if (event.m_arg_name)
+    {
+      json.key ("args").begin_object ();
+      json.key (event.m_arg_name).value (event.m_arg);
+      json.end_object ();
+    }
+  json.end_object ();
+  g_trace->m_out.put ('\n');
+}
+
+/* Write the events of all the rings.  Called with the trace mutex held.  */
+void
+write_events ()
+{
+  for (auto &&ring : g_trace->m_rings)
+    {
+      uint64_t tail = ring->m_tail.load (std::memory_order_relaxed);
+      const uint64_t head = ring->m_head.load (std::memory_order_acquire);
+      if (tail == head)
+        continue;
+
+      if (!ring->m_thread_name_written)
+        {
+          write_thread_name (*ring);
+          ring->m_thread_name_written = true;
+        }
+
+      for (; tail != head; ++tail)
+        write_event (*ring, ring->m_events[tail % trace_ring_t::capacity]);
+
+      ring->m_tail.store (tail, std::memory_order_release);
+    }
+}
+
+} /* namespace */
+
+namespace detail
+{
+
+void
+record_trace_event (const trace_event_t &event)
+{
+  if (!t_thread_ring.m_ring)
+    t_thread_ring.m_ring = acquire_ring ();
+
+  /* The thread writing the trace, which records the spans of each
+     wavefront of a report, drains its full ring instead of dropping the
+     events.  */
+  if (!t_thread_ring.m_ring->push (event))
+    {
+      if (t_trace_writer)
+        flush_trace ();
+
+      if (!t_thread_ring.m_ring->push (event))
+        t_thread_ring.m_ring->drop ();
+    }
+}
+
+} /* namespace detail */
+
+bool
+open_trace (const std::string &path)
+{
+  agent_assert (!g_trace);
+
+  int fd = open (path.c_str (), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                 0666);
+  if (fd == -1)
+    return false;
+
+  g_trace = new trace_t (fd);
+  g_trace->m_json.begin_array ();
+  g_trace->m_out.put ('\n');
+
+  detail::trace_enabled = true;
+  return true;
+}
+
+void
+flush_trace ()
+{
+  if (!g_trace)
+    return;
+
+  std::lock_guard<std::mutex> lock (g_trace->m_mutex);
+  if (g_trace->m_closed)
+    return;
+
+  t_trace_writer = true;
+  write_events ();
+
+  /* Hand the events to the background writer, without waiting for them to
+     be written.  */
+  g_trace->m_out.flush ();
+}
+
+void
+close_trace ()
+{
+  if (!g_trace)
+    return;
+
+  std::lock_guard<std::mutex> lock (g_trace->m_mutex);
+  if (g_trace->m_closed)
+    return;
+
+  write_events ();
+  g_trace->m_json.end_array ();
+  g_trace->m_out.put ('\n');
+  g_trace->m_out.flush ();
+  g_trace->m_buffer.flush ();
+  g_trace->m_closed = true;
+
+  uint64_t dropped = g_trace->m_dropped;
+  for (auto &&ring : g_trace->m_rings)
+    dropped += ring->m_dropped.load (std::memory_order_relaxed);
+
+  if (dropped)
+    agent_warning ("%lu trace events were dropped", dropped);
+}
+
+} /* namespace amd::debug_agent */
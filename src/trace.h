@@ -0,0 +1,133 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+#ifndef _ROCM_DEBUG_AGENT_TRACE_H
+#define _ROCM_DEBUG_AGENT_TRACE_H 1
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/* A trace of the agent's activity, enabled with --trace, in the Chrome JSON
+   trace format read by chrome://tracing and Perfetto.
+
+   Each thread records its events in its own ring buffer, without locks or
+   system calls, and the worker thread writes the events of all the rings to
+   the trace file before waiting for the next commands and dbgapi events.
+   When the ring of another thread is full, its new events are dropped until
+   it is drained, while the worker thread drains its own ring.  The trace is
+   a JSON array written as it grows, which the readers accept even if the
+   process is aborted before it is closed.  */
+
+namespace amd::debug_agent
+{
+
+/* A span of time in a thread, with an optional numeric argument.  */
+struct trace_event_t
+{
+  /* The name of the span, and of its argument, are string literals.  */
+  const char *m_name;
+  const char *m_arg_name;
+  uint64_t m_arg;
+  /* The start and end of the span, in steady_clock nanoseconds.  */
+  uint64_t m_start_ns;
+  uint64_t m_end_ns;
+};
+
+namespace detail
+{
+
+/* Set when the trace is opened, before the threads recording events are
+   started.  */
+extern bool trace_enabled;
+
+void record_trace_event (const trace_event_t &event);
+
+inline uint64_t
+trace_clock_ns ()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds> (
+             std::chrono::steady_clock::now ().time_since_epoch ())
+      .count ();
+}
+
+} /* namespace detail */
+
+/* Start writing the trace to the file PATH.  Return false if it cannot be
+   created.  */
+bool open_trace (const std::string &path);
+
+/* Write the events recorded so far by all the threads to the trace file.
+   Called by the worker thread only.  */
+void flush_trace ();
+
+/* Write the remaining events, and terminate the trace.  The calls after the
+   first one do nothing.  */
+void close_trace ();
+
+/* Record the lifetime of this object, in the calling thread, as the span
+   NAME.  */
+class trace_span_t
+{
+public:
+  explicit trace_span_t (const char *name, const char *arg_name = nullptr,
+                         uint64_t arg = 0)
+  {
+    if (detail::trace_enabled)
+      m_event = { name, arg_name, arg, detail::trace_clock_ns (), 0 };
+  }
+
+  ~trace_span_t ()
+  {
+    if (m_event.m_name)
+      {
+        m_event.m_end_ns = detail::trace_clock_ns ();
+        detail::record_trace_event (m_event);
+      }
+  }
+
+  trace_span_t (const trace_span_t &) = delete;
+  trace_span_t &operator= (const trace_span_t &) = delete;
+
+  /* Set the argument of the span, for an argument only known at its
+     end.  */
+  void set_arg (const char *arg_name, uint64_t arg)
+  {
+    m_event.m_arg_name = arg_name;
+    m_event.m_arg = arg;
+  }
+
+private:
+  trace_event_t m_event{};
+};
+
+} /* namespace amd::debug_agent */
+
+#endif /* _ROCM_DEBUG_AGENT_TRACE_H */
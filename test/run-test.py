@@ -1,6 +1,8 @@
 import os
 import re
 import sys
+import json
+import shutil
 import inspect
 from subprocess import Popen, PIPE
 
@@ -15,6 +17,27 @@ def filter_warnings(err_str):
     ])
 
 
+def find_all(check_list, text):
+    """ Return True if all the patterns of check_list are found in text.  """
+    all_output_string_found = True
+    for check_str in check_list:
+        pattern = re.compile(check_str)
+        if (not (pattern.search(text))):
+            all_output_string_found = False
+            print ("\"", check_str, "\" Not Found in dump.")
+    return all_output_string_found
+
+
+def run_test_with_options(test, options):
+    """ Run rocm-debug-agent-test TEST with the agent options OPTIONS.  """
+    env = dict(os.environ)
+    env["ROCM_DEBUG_AGENT_OPTIONS"] = options
+    p = Popen(['./rocm-debug-agent-test', test], stdout=PIPE, stderr=PIPE,
+              env=env)
+    output, err = p.communicate()
+    return output.decode('utf-8'), err.decode('utf-8')
+
+
 # set up
 if (len(sys.argv)  != 2):
     raise Exception("ERROR: Please specify test binary location. For example: $python3.6 run_test.py ./build")
@@ -28,6 +51,11 @@ else:
         os.environ["LD_LIBRARY_PATH"] += ":" + agent_library_directory
     os.environ["HSA_TOOLS_LIB"] = "librocm-debug-agent.so.2"
     os.environ["ROCM_DEBUG_AGENT_OPTIONS"] = "-p"
+    # The snapshot decoder, from the build tree or installed.
+    decoder = os.path.join(agent_library_directory, "tools",
+                           "rocm-debug-agent-decode")
+    if not os.access(decoder, os.X_OK):
+        decoder = shutil.which("rocm-debug-agent-decode")
     os.chdir(test_binary_directory)
     # pre test to check if librocm-debug-agent.so.2 can be found
     p = Popen(['./rocm-debug-agent-test', '0'], stdout=PIPE, stderr=PIPE)
@@ -55,12 +83,8 @@ def check_test_0():
 
     return True
 
-# test 1
-def check_test_1():
-    print("Starting rocm-debug-agent test 1")
-
-    #TODO: use regular expressions instead of strings
-    check_list = ['HSA_STATUS_ERROR_EXCEPTION: An HSAIL operation resulted in a hardware exception\.',
+# The report of the wavefronts of test 1.
+test_1_report_check_list = [
                   '\(stopped, reason: ASSERT_TRAP\)',
                    'exec: (00000000)?00000001',
 #                  'status: 00012061',
@@ -75,6 +99,13 @@ def check_test_1():
 #                  's_trap 2'
                   ]
 
+# test 1
+def check_test_1():
+    print("Starting rocm-debug-agent test 1")
+
+    #TODO: use regular expressions instead of strings
+    check_list = ['HSA_STATUS_ERROR_EXCEPTION: An HSAIL operation resulted in a hardware exception\.'] + test_1_report_check_list
+
     p = Popen(['./rocm-debug-agent-test', '1'], stdout=PIPE, stderr=PIPE)
     output, err = p.communicate()
     out_str = output.decode('utf-8')
@@ -138,10 +169,117 @@ def check_test_2():
 
     return all_output_string_found
 
+# test 3: the wavefronts of test 1 saved in a snapshot, then decoded
+def check_test_3():
+    print("Starting rocm-debug-agent test 3")
+
+    if decoder is None:
+        print("rocm-debug-agent-decode not found, skipping test 3")
+        return True
+
+    snapshot = os.path.abspath("rocm-debug-agent-test-3.snapshot")
+    if os.path.exists(snapshot):
+        os.remove(snapshot)
+
+    out_str, err_str = run_test_with_options('1', "-p --snapshot=" + snapshot)
+
+    all_output_string_found = find_all(['Saved [0-9]+ wavefronts? to snapshot'],
+                                       err_str)
+    if (not all_output_string_found):
+        print("rocm-debug-agent test error message.")
+        print(err_str)
+        return False
+
+    p = Popen([decoder, snapshot], stdout=PIPE, stderr=PIPE)
+    output, err = p.communicate()
+    decoded_str = output.decode('utf-8')
+    decoder_err_str = err.decode('utf-8')
+
+    # The decoded report is the report the agent would have printed.
+    all_output_string_found = (p.returncode == 0
+                               and find_all(test_1_report_check_list,
+                                            decoded_str))
+
+    if (not all_output_string_found):
+        print("rocm-debug-agent-decode print out.")
+        print(decoded_str)
+        print("rocm-debug-agent-decode error message.")
+        print(decoder_err_str)
+
+    return all_output_string_found
+
+# test 4: the wavefronts of test 2 printed as NDJSON records
+def check_test_4():
+    print("Starting rocm-debug-agent test 4")
+
+    report = os.path.abspath("rocm-debug-agent-test-4.ndjson")
+    if os.path.exists(report):
+        os.remove(report)
+
+    out_str, err_str = run_test_with_options(
+        '2', "-p --format=ndjson --output=" + report)
+
+    # Every line, including the log messages, must be a JSON record.
+    records = []
+    try:
+        with open(report) as report_file:
+            for line in report_file:
+                records.append(json.loads(line))
+    except (OSError, ValueError) as error:
+        print("Cannot read the NDJSON report: ", error)
+        print(err_str)
+        return False
+
+    def records_of_type(record_type):
+        return [record for record in records if record["type"] == record_type]
+
+    reports = records_of_type("report")
+    waves = records_of_type("wave")
+
+    def has_register(wave, name, pattern):
+        return any(re.match(pattern, registers.get(name, ""))
+                   for registers in wave["registers"].values())
+
+    checks = [
+        ("one report", len(reports) == 1),
+        ("a wave record per wavefront",
+         len(reports) == 1 and len(waves) == reports[0]["wave_count"]),
+        ("a wave stopped by a memory violation",
+         any("MEMORY_VIOLATION" in wave["stop_reason"] for wave in waves)),
+        ("the exec mask",
+         any(has_register(wave, "exec", "0x(ffffffff)?ffffffff$")
+             for wave in waves)),
+        # First uint64_t in LDS is '1111111122222222'
+        ("the local memory",
+         any(wave.get("local_memory", [])[:2] == [0x22222222, 0x11111111]
+             for wave in waves)),
+        ("the kernel name",
+         any(re.match(r"vector_add_memory_fault\(int\*, int\*, int\*\)",
+                      wave.get("kernel_name", ""))
+             for wave in waves)),
+        ("the disassembly", len(records_of_type("instruction")) > 0),
+    ]
+
+    all_checks_passed = True
+    for description, passed in checks:
+        if (not passed):
+            all_checks_passed = False
+            print ("\"", description, "\" Not Found in NDJSON report.")
+
+    if (not all_checks_passed):
+        print("rocm-debug-agent NDJSON report.")
+        print("\n".join(json.dumps(record) for record in records))
+        print("rocm-debug-agent test error message.")
+        print(err_str)
+
+    return all_checks_passed
+
 test_success = True
 test_success &= check_test_0()
 test_success &= check_test_1()
 test_success &= check_test_2()
+test_success &= check_test_3()
+test_success &= check_test_4()
 if (test_success):
     print("rocm-debug-agent test Pass!")
 else:
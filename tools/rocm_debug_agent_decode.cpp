@@ -0,0 +1,584 @@
+/* The University of Illinois/NCSA
+   Open Source License (NCSA)
+
+   Copyright (c) 2026, Advanced Micro Devices, Inc. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal with the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+    - Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimers.
+    - Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimers in
+      the documentation and/or other materials provided with the distribution.
+    - Neither the names of Advanced Micro Devices, Inc,
+      nor the names of its contributors may be used to endorse or promote
+      products derived from this Software without specific prior written
+      permission.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+   OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+   ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS WITH THE SOFTWARE.  */
+
+/* Print the reports saved by the ROCdebug-agent --snapshot option.
+
+   The snapshot holds the raw state of the wavefronts.  The kernel names,
+   source lines and disassembly are recovered here from the code objects:
+   the ones loaded from memory are saved in the snapshot, and the ones loaded
+   from a file are read from that file, if it still matches the code object
+   that was loaded.  */
+
+#include "code_object.h"
+#include "json_writer.h"
+#include "logging.h"
+#include "report_format.h"
+#include "snapshot.h"
+
+#include <amd-dbgapi/amd-dbgapi.h>
+
+#include <getopt.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace amd::debug_agent;
+
+namespace
+{
+
+struct decoder_options_t
+{
+  bool m_json{ false };
+  bool m_compact{ false };
+};
+
+void
+decoder_warning (const std::string &message)
+{
+  std::cerr << "rocm-debug-agent-decode: warning: " << message << std::endl;
+}
+
+/* Initialize dbgapi, which is only used to get architectures and to
+   disassemble instructions.  The decoder is not attached to any process, so
+   the process callbacks all fail.  */
+bool
+initialize_dbgapi ()
+{
+  static amd_dbgapi_callbacks_t callbacks = {
+    .allocate_memory = malloc,
+    .deallocate_memory = free,
+    .client_process_get_info =
+        [] (amd_dbgapi_client_process_id_t, amd_dbgapi_client_process_info_t,
+            size_t, void *) { return AMD_DBGAPI_STATUS_ERROR; },
+    .insert_breakpoint =
+        [] (amd_dbgapi_client_process_id_t, amd_dbgapi_global_address_t,
+            amd_dbgapi_breakpoint_id_t) { return AMD_DBGAPI_STATUS_ERROR; },
+    .remove_breakpoint =
+        [] (amd_dbgapi_client_process_id_t, amd_dbgapi_breakpoint_id_t) {
+          return AMD_DBGAPI_STATUS_ERROR;
+        },
+    .xfer_global_memory =
+        [] (amd_dbgapi_client_process_id_t, amd_dbgapi_global_address_t,
+            amd_dbgapi_size_t *, void *,
+            const void *) { return AMD_DBGAPI_STATUS_ERROR; },
+    .log_message =
+        [] (amd_dbgapi_log_level_t level, const char *message) {
+          std::cerr << "rocm-dbgapi: " << message << std::endl;
+        }
+  };
+
+  return amd_dbgapi_initialize (&callbacks) == AMD_DBGAPI_STATUS_SUCCESS;
+}
+
+/* Decode the waves of a snapshot report.  */
+class report_decoder_t
+{
+public:
+  report_decoder_t (const snapshot_report_t &report, bool dbgapi_available);
+
+  void print_text (bool compact);
+  void print_json (json_writer_t &json);
+
+private:
+  struct architecture_t
+  {
+    const snapshot_architecture_t *m_record;
+    /* The architecture's registers, and the element counts of their vector
+       types, by register id.  */
+    std::unordered_map<uint64_t, std::pair<const snapshot_register_info_t *,
+                                           std::vector<size_t>>>
+        m_registers;
+    std::optional<amd_dbgapi_architecture_id_t> m_architecture_id;
+  };
+
+  struct code_object_entry_t
+  {
+    const snapshot_code_object_t *m_record;
+    /* The code object, once opened.  Null if it is not available.  */
+    std::unique_ptr<code_object_t> m_code_object;
+    bool m_opened{ false };
+  };
+
+  /* Return the code object ID, opened, or nullptr if it is not
+     available.  */
+  code_object_t *get_code_object (uint64_t id);
+
+  /* Return the name of the kernel of WAVE, if it is known.  */
+  std::optional<std::string_view> kernel_name (const snapshot_wave_t &wave);
+
+  /* Return the registers of WAVE grouped by register class, in the order
+     they are printed.  */
+  std::vector<std::vector<register_value_t>>
+  class_registers (const snapshot_wave_t &wave,
+                   const architecture_t &architecture);
+
+  void print_disassembly (const snapshot_wave_t &wave,
+                          architecture_t &architecture);
+
+  const snapshot_report_t &m_report;
+  std::unordered_map<uint64_t, architecture_t> m_architectures;
+  std::map<uint64_t, code_object_entry_t> m_code_objects;
+};
+
+report_decoder_t::report_decoder_t (const snapshot_report_t &report,
+                                    bool dbgapi_available)
+    : m_report (report)
+{
+  for (auto &&record : report.m_architectures)
+    {
+      architecture_t &architecture = m_architectures[record.m_id];
+      architecture.m_record = &record;
+
+      for (auto &&info : record.m_registers)
+        architecture.m_registers.emplace (
+            info.m_id,
+            std::make_pair (&info, parse_register_type (info.m_type)));
+
+      amd_dbgapi_architecture_id_t architecture_id;
+      if (dbgapi_available
+          && amd_dbgapi_get_architecture (record.m_elf_amdgpu_machine,
+                                          &architecture_id)
+                 == AMD_DBGAPI_STATUS_SUCCESS)
+        architecture.m_architecture_id.emplace (architecture_id);
+    }
+
+  for (auto &&record : report.m_code_objects)
+    m_code_objects[record.m_id].m_record = &record;
+}
+
+code_object_t *
+report_decoder_t::get_code_object (uint64_t id)
+{
+  auto it = m_code_objects.find (id);
+  if (it == m_code_objects.end ())
+    return nullptr;
+
+  code_object_entry_t &entry = it->second;
+  if (entry.m_opened)
+    return entry.m_code_object.get ();
+
+  entry.m_opened = true;
+
+  const snapshot_code_object_t &record = *entry.m_record;
+  auto code_object = std::make_unique<code_object_t> (record.m_uri,
+                                                      record.m_load_address);
+
+  std::string protocol = record.m_uri.substr (0, record.m_uri.find ("://"));
+  std::transform (protocol.begin (), protocol.end (), protocol.begin (),
+                  [] (unsigned char c) { return std::tolower (c); });
+
+  if (!record.m_image.empty ())
+    code_object->open (record.m_image);
+  else if (protocol == "file")
+    code_object->open ();
+
+  if (!code_object->is_open ())
+    {
+      decoder_warning ("code object `" + record.m_uri + "' is not available");
+      return nullptr;
+    }
+
+  if (code_object->content_hash () != record.m_hash)
+    {
+      decoder_warning ("code object `" + record.m_uri
+                       + "' does not match the code object that was loaded");
+      return nullptr;
+    }
+
+  entry.m_code_object = std::move (code_object);
+  return entry.m_code_object.get ();
+}
+
+std::optional<std::string_view>
+report_decoder_t::kernel_name (const snapshot_wave_t &wave)
+{
+  if (!wave.m_kernel_entry || !wave.m_code_object_id)
+    return std::nullopt;
+
+  if (code_object_t *code_object = get_code_object (*wave.m_code_object_id))
+    if (auto symbol = code_object->find_symbol (*wave.m_kernel_entry))
+      return symbol->m_name;
+
+  return std::nullopt;
+}
+
+std::vector<std::vector<register_value_t>>
+report_decoder_t::class_registers (const snapshot_wave_t &wave,
+                                   const architecture_t &architecture)
+{
+  std::vector<std::vector<register_value_t>> class_registers (
+      architecture.m_record->m_class_names.size ());
+
+  for (auto &&[register_id, value] : wave.m_registers)
+    {
+      auto it = architecture.m_registers.find (register_id);
+      if (it == architecture.m_registers.end ())
+        throw snapshot_error_t ("unknown register in wave_"
+                                + std::to_string (wave.m_wave_id));
+
+      auto &&[info, vector_dimensions] = it->second;
+      if (!info->m_class_index)
+        continue;
+
+      if (value.empty ()
+          || (!vector_dimensions.empty ()
+              && (!vector_dimensions[0]
+                  || (value.size () % vector_dimensions[0]) != 0)))
+        throw snapshot_error_t ("invalid value for register " + info->m_name
+                                + " in wave_"
+                                + std::to_string (wave.m_wave_id));
+
+      class_registers[*info->m_class_index].emplace_back (
+          register_value_t{ &info->m_name, &vector_dimensions, &value });
+    }
+
+  return class_registers;
+}
+
+void
+report_decoder_t::print_disassembly (const snapshot_wave_t &wave,
+                                     architecture_t &architecture)
+{
+  if (!wave.m_code_object_id || !architecture.m_architecture_id)
+    return;
+
+  code_object_t *code_object = get_code_object (*wave.m_code_object_id);
+  if (!code_object)
+    return;
+
+  /* The instructions at the pc are in the snapshot.  The instructions before
+     the pc, printed to show the start of the source line, are read from the
+     code object's image.  */
+  auto read_memory = [&] (amd_dbgapi_global_address_t address, void *buffer,
+                          amd_dbgapi_size_t *size) {
+    const amd_dbgapi_global_address_t start = wave.m_instructions_address;
+    if (address >= start
+        && (address - start) < wave.m_instructions.size ())
+      {
+        *size = std::min<amd_dbgapi_size_t> (
+            *size, wave.m_instructions.size () - (address - start));
+        std::memcpy (buffer, &wave.m_instructions[address - start], *size);
+        return true;
+      }
+
+    return code_object->read_image_memory (address, buffer, size);
+  };
+
+  code_object->disassemble (*architecture.m_architecture_id, wave.m_pc,
+                            read_memory);
+}
+
+void
+report_decoder_t::print_text (bool compact)
+{
+  for (size_t i = 0; i < m_report.m_waves.size (); ++i)
+    {
+      const snapshot_wave_t &wave = m_report.m_waves[i];
+
+      auto it = m_architectures.find (wave.m_architecture_id);
+      if (it == m_architectures.end ())
+        throw snapshot_error_t ("unknown architecture in wave_"
+                                + std::to_string (wave.m_wave_id));
+      architecture_t &architecture = it->second;
+
+      if (i)
+        agent_out << std::endl;
+
+      agent_out << "--------------------------------------------------------"
+                << std::endl;
+
+      agent_out << "wave_" << std::dec << wave.m_wave_id << ": ";
+      print_wave_location (wave.m_pc, wave.m_kernel_entry,
+                           kernel_name (wave), wave.m_stop_reason);
+
+      auto registers = class_registers (wave, architecture);
+      for (size_t j = 0; j < registers.size (); ++j)
+        print_register_class (architecture.m_record->m_class_names[j],
+                              registers[j], compact);
+
+      switch (wave.m_local_memory_kind)
+        {
+        case snapshot_local_memory_t::none:
+          break;
+        case snapshot_local_memory_t::contents:
+          print_local_memory_contents (wave.m_local_memory, compact);
+          break;
+        case snapshot_local_memory_t::shared:
+          print_shared_local_memory (wave.m_local_memory_wave_id);
+          break;
+        }
+
+      print_disassembly (wave, architecture);
+    }
+}
+
+void
+report_decoder_t::print_json (json_writer_t &json)
+{
+  json.begin_object ();
+  json.key ("timestamp").value (m_report.m_timestamp);
+
+  json.key ("waves").begin_array ();
+  for (auto &&wave : m_report.m_waves)
+    {
+      auto it = m_architectures.find (wave.m_architecture_id);
+      if (it == m_architectures.end ())
+        throw snapshot_error_t ("unknown architecture in wave_"
+                                + std::to_string (wave.m_wave_id));
+      architecture_t &architecture = it->second;
+
+      json.begin_object ();
+      json.key ("wave_id").value (wave.m_wave_id);
+      json.key ("architecture").value (architecture.m_record->m_name);
+      json.key ("pc").hex_value (wave.m_pc);
+      json.key ("stop_reason").value (stop_reason_string (wave.m_stop_reason));
+
+      if (wave.m_dispatch_id)
+        {
+          json.key ("dispatch_id").value (*wave.m_dispatch_id);
+          json.key ("kernel_code_entry").hex_value (*wave.m_kernel_entry);
+
+          json.key ("workgroup").begin_array ();
+          for (uint32_t coord : *wave.m_workgroup_coord)
+            json.value (coord);
+          json.end_array ();
+        }
+
+      if (auto name = kernel_name (wave))
+        json.key ("kernel_name").value (*name);
+
+      if (wave.m_code_object_id)
+        json.key ("code_object_id").value (*wave.m_code_object_id);
+
+      json.key ("registers").begin_object ();
+      auto registers = class_registers (wave, architecture);
+      for (size_t i = 0; i < registers.size (); ++i)
+        json_register_class (json, architecture.m_record->m_class_names[i],
+                             registers[i]);
+      json.end_object ();
+
+      switch (wave.m_local_memory_kind)
+        {
+        case snapshot_local_memory_t::none:
+          break;
+        case snapshot_local_memory_t::contents:
+          json.key ("local_memory").begin_array ();
+          for (uint32_t word : wave.m_local_memory)
+            json.value (word);
+          json.end_array ();
+          break;
+        case snapshot_local_memory_t::shared:
+          json.key ("local_memory_same_as_wave_id")
+              .value (wave.m_local_memory_wave_id);
+          break;
+        }
+
+      json.end_object ();
+    }
+  json.end_array ();
+
+  json.key ("code_objects").begin_array ();
+  for (auto &&[id, entry] : m_code_objects)
+    {
+      const snapshot_code_object_t &record = *entry.m_record;
+
+      json.begin_object ();
+      json.key ("code_object_id").value (id);
+      json.key ("uri").value (record.m_uri);
+      json.key ("load_address").hex_value (record.m_load_address);
+      json.key ("mem_size").value (record.m_mem_size);
+      json.key ("hash").hex_value (record.m_hash);
+      json.key ("saved_in_snapshot").value (!record.m_image.empty ());
+      json.end_object ();
+    }
+  json.end_array ();
+
+  json.end_object ();
+}
+
+void
+print_usage ()
+{
+  std::cerr << "usage: rocm-debug-agent-decode [OPTION]... SNAPSHOT"
+            << std::endl
+            << "Print the reports saved in SNAPSHOT by the ROCdebug-agent "
+               "--snapshot option."
+            << std::endl
+            << std::endl;
+  std::cerr << "  -j, --json                  "
+               "Print the reports in JSON instead of text."
+            << std::endl;
+  std::cerr << "  -c, --compact               "
+               "Collapse identical consecutive rows of the local"
+            << std::endl
+            << "                              "
+               "memory dump, and print vector registers whose"
+            << std::endl
+            << "                              "
+               "lanes all have the same value as 'all lanes ='."
+            << std::endl;
+  std::cerr << "  -o, --output=FILE           "
+               "Save the output in FILE. By default, the output"
+            << std::endl
+            << "                              "
+               "is printed to stdout."
+            << std::endl;
+  std::cerr << "  -h, --help                  "
+               "Display this usage message."
+            << std::endl;
+}
+
+} /* namespace */
+
+int
+main (int argc, char **argv)
+{
+  decoder_options_t options;
+
+  static struct option long_options[]
+      = { { "json", no_argument, nullptr, 'j' },
+          { "compact", no_argument, nullptr, 'c' },
+          { "output", required_argument, nullptr, 'o' },
+          { "help", no_argument, nullptr, 'h' },
+          { 0 } };
+
+  while (int c = getopt_long (argc, argv, "jco:h", long_options, nullptr))
+    {
+      if (c == -1)
+        break;
+
+      switch (c)
+        {
+        case 'j': /* -j or --json  */
+          options.m_json = true;
+          break;
+
+        case 'c': /* -c or --compact  */
+          options.m_compact = true;
+          break;
+
+        case 'o': /* -o or --output  */
+          agent_out.open (optarg);
+          if (!agent_out.is_open ())
+            {
+              std::cerr << "could not open `" << optarg << "'" << std::endl;
+              return 1;
+            }
+          break;
+
+        case 'h': /* -h or --help  */
+          print_usage ();
+          return 0;
+
+        default:
+          print_usage ();
+          return 1;
+        }
+    }
+
+  if (optind != argc - 1)
+    {
+      print_usage ();
+      return 1;
+    }
+
+  if (!agent_out.is_open ())
+    {
+      agent_out.copyfmt (std::cout);
+      agent_out.clear (std::cout.rdstate ());
+      agent_out.basic_ios<char>::rdbuf (std::cout.rdbuf ());
+    }
+
+  const bool dbgapi_available = initialize_dbgapi ();
+  if (!dbgapi_available)
+    decoder_warning ("could not initialize rocm-dbgapi, the instructions will "
+                     "not be disassembled");
+
+  try
+    {
+      snapshot_reader_t reader (argv[optind]);
+      std::optional<json_writer_t> json;
+
+      if (options.m_json)
+        {
+          json.emplace (agent_out);
+          json->begin_object ();
+          json->key ("version").value (reader.version ());
+          json->key ("reports").begin_array ();
+        }
+
+      for (size_t i = 0; auto report = reader.next_report (); ++i)
+        {
+          report_decoder_t decoder (*report, dbgapi_available);
+
+          if (json)
+            {
+              decoder.print_json (*json);
+              continue;
+            }
+
+          if (i)
+            agent_out << std::endl;
+          decoder.print_text (options.m_compact);
+        }
+
+      if (json)
+        {
+          json->end_array ();
+          json->end_object ();
+          agent_out << std::endl;
+        }
+    }
+  catch (const snapshot_error_t &error)
+    {
+      agent_out.flush ();
+      std::cerr << "rocm-debug-agent-decode: error: " << error.what ()
+                << std::endl;
+      return 1;
+    }
+
+  if (dbgapi_available)
+    amd_dbgapi_finalize ();
+
+  return 0;
+}